@@ -42,6 +42,8 @@ from m5.proxy import *
 
 from m5.objects.BaseCPU import BaseCPU
 from m5.objects.RunaheadFUPool import *
+from m5.objects.RunaheadExitPolicy import *
+from m5.objects.ContinuousRunaheadEngine import ContinuousRunaheadEngine
 #from m5.objects.RunaheadChecker import RunaheadChecker
 from m5.objects.BranchPredictor import *
 
@@ -143,6 +145,12 @@ class BaseRunaheadCPU(BaseCPU):
     numPhysCCRegs = Param.Unsigned(0, "Number of physical cc registers")
     numIQEntries = Param.Unsigned(64, "Number of instruction queue entries")
     numROBEntries = Param.Unsigned(192, "Number of reorder buffer entries")
+    iqDependencyGraph = Param.String('Linked', 'IQ dependency graph. Must be one of: "Linked" (a heap node per '
+                                               'dependent), "Pooled" (fixed slots per register). Both wake up alike')
+    iqDependencyGraphSlots = Param.Unsigned(4, "Dependents kept per register by the pooled dependency graph "
+                                               "before spilling")
+    iqScheduler = Param.String('List', 'IQ select logic. Must be one of: "List" (age ordered list of ready '
+                                       'queues), "AgeMatrix" (bit matrix), "Check" (both, panics if they differ)')
 
     smtNumFetchingThreads = Param.Unsigned(1, "SMT Number of Fetching Threads")
     smtFetchPolicy = Param.SMTFetchPolicy('RoundRobin', "SMT Fetch policy")
@@ -156,6 +164,9 @@ class BaseRunaheadCPU(BaseCPU):
                                           "SMT ROB Sharing Policy")
     smtROBThreshold = Param.Int(100, "SMT ROB Threshold Sharing Parameter")
     smtCommitPolicy = Param.CommitPolicy('RoundRobin', "SMT Commit Policy")
+    # Prefer fetching from threads in normal mode and cap the IQ share of threads in runahead
+    smtRunaheadPolicy = Param.String('None', 'SMT runahead policy. Must be one of: "None", "Deprioritize"')
+    smtRunaheadIQShare = Param.Percent(50, "Deprioritize policy - percentage of its IQ entries a thread in runahead may use")
 
     branchPred = Param.BranchPredictor(TournamentBP(numThreads =
                                                        Parent.numThreads),
@@ -166,18 +177,81 @@ class BaseRunaheadCPU(BaseCPU):
 
     filteredRunahead = Param.Bool(True, "Whether or not to filter the instruction stream to load chains in runahead")
 
+    # Runahead insts execute outside of the ROB using free resources, and exit only squashes them
+    preciseRunahead = Param.Bool(False, "Use precise runahead, which keeps the ROB and avoids the exit flush. "
+                                        "Requires the eager exit policy")
+
+    # Requires filteredRunahead. Chains that do not fit in the buffer fall back to filtered fetch
+    runaheadBuffer = Param.Bool(False, "Replay load chains from a runahead buffer, gating fetch and decode in runahead")
+    runaheadBufferSize = Param.Unsigned(32, "Runahead buffer capacity, in instructions")
+
     # 0 is L1, 1 is L2 and so on
     # This is more of a system/simulation parameter, really, but I'm trying to keep
     # runahead related things in the CPU
     lllDepthThreshold = Param.Int(2, 'Depth threshold after which a request to be considered a long latency load')
+    earlyLLLDetection = Param.Bool(False, "Detect LLLs as soon as they miss deep enough, and generate their "
+                                          "dependence chain before they reach the ROB head")
 
     runaheadCacheSize = Param.MemorySize('2kB', "Runahead cache capacity")
+    runaheadCacheAssoc = Param.Unsigned(1, "Runahead cache associativity")
+    runaheadCacheReplPolicy = Param.String('LRU', 'Runahead cache replacement policy. Must be one of: "LRU", "Random"')
+    runaheadCacheLatency = Param.Cycles(1, "Runahead cache access latency")
+    runaheadCachePorts = Param.Unsigned(0, "Runahead cache accesses per cycle (0 for unlimited)")
+
+    # Set the size to 0 to disable
+    runaheadPrefetchTrackerSize = Param.Unsigned(4096, "Amount of runahead-prefetched blocks to track for usefulness")
+    runaheadPrefetchTrackerPeriods = Param.Unsigned(16, "Max amount of runahead periods to keep prefetch records for")
+
+    # PC-indexed confidence table vetoing runahead entry for LLLs causing useless periods
+    runaheadEntryPredictor = Param.Bool(False, "Use a confidence predictor to veto runahead entry")
+    runaheadEntryPredictorEntries = Param.Unsigned(256, "Entry predictor table size. Must be a power of 2")
+    runaheadEntryPredictorTagBits = Param.Unsigned(8, "Amount of PC tag bits per entry predictor entry")
+    runaheadEntryPredictorCounterBits = Param.Unsigned(2, "Width of the entry predictor confidence counters")
+    runaheadEntryPredictorThreshold = Param.Unsigned(1, "Runahead entry is vetoed when confidence is below this")
+    runaheadEntryPredictorInitial = Param.Unsigned(2, "Initial confidence of new entry predictor entries")
+    runaheadEntryPredictorProbeInterval = Param.Unsigned(16, "Let a vetoed LLL enter runahead after this many of its "
+                                                             "instances were vetoed (0 to never)")
+    runaheadEntryPredictorMinLLLs = Param.Unsigned(1, "New LLLs a runahead period must generate to be useful")
+    runaheadEntryPredictorMinValidLoads = Param.Unsigned(1, "Valid loads a runahead period must pseudoretire to be useful")
+
+    # Last-value/stride predictor supplying values for runahead LLLs instead of poisoning them
+    runaheadValuePredictor = Param.Bool(False, "Predict the values of runahead LLLs instead of poisoning them")
+    runaheadValuePredictorEntries = Param.Unsigned(1024, "Value predictor table size. Must be a power of 2")
+    runaheadValuePredictorCounterBits = Param.Unsigned(2, "Width of the value predictor confidence counters")
+    runaheadValuePredictorThreshold = Param.Unsigned(2, "Values are only predicted with at least this confidence")
+
+    vectorRunahead = Param.Bool(False, "Issue lanes of prefetches for future iterations of strided and indirect LLLs")
+    vectorRunaheadLanes = Param.Unsigned(16, "Amount of future iterations to issue vector runahead lanes for")
+    vectorRunaheadIssueWidth = Param.Unsigned(2, "Max vector runahead lanes sent to the data cache per cycle")
+
+    runaheadReuseBufferSize = Param.Unsigned(0, "Amount of pseudoretired results kept for reuse after runahead "
+                                                "exits. Must be a power of 2, 0 disables the reuse buffer")
+
+    runaheadChainFilter = Param.Bool(True, "Look up runahead chain membership in a hash table instead of "
+                                           "scanning the chain")
+    dynInstFreeList = Param.Bool(True, "Recycle the buffers of squashed and committed instructions instead of "
+                                       "returning them to the heap")
+
+    commitWatchdogCycles = Param.Cycles(0, "Check every this many cycles that an instruction committed, and "
+                                           "dump the pipeline state if not. 0 disables the watchdog")
+    commitWatchdogExit = Param.Bool(True, "Exit the simulation loop when the commit watchdog fires")
+
+    skipStalledCycles = Param.String('Off', 'Stop ticking while no stage can make progress until something wakes '
+                                            'the CPU, counting the same stats as ticking through the stall. Must be '
+                                            'one of: "Off", "Skip", "Check" (skip one cycle at a time, tick the next '
+                                            'and panic if it changes the stats differently)')
+
+    runaheadTraceFile = Param.String("", "File in the output directory to write a binary trace of every runahead "
+                                         "period to. Empty disables the trace")
+    runaheadTraceBufferSize = Param.MemorySize("64KiB", "Amount of trace data buffered before writing it out")
+
+    continuousRunaheadEngine = Param.ContinuousRunaheadEngine(NULL, "Engine running the hottest dependence chains "
+                                                                    "continuously on the memory side. Requires filtered runahead")
 
     runaheadEagerEntry = Param.Bool(True, 'Enter runahead immediately on LLL detection (True) or wait for full ROB (False)?')
 
-    runaheadExitPolicy = Param.String('Eager', 'Runahead exit policy. Must be one of: "Eager", "MinimumWork", "DynamicDelayed"')
+    runaheadExitPolicy = Param.RunaheadExitPolicy(EagerExitPolicy(), 'Runahead exit policy')
     runaheadExitDeadline = Param.Cycles(250, 'All runahead is forced to exit within this amount of cycles.')
-    minRunaheadWork = Param.Int(100, 'MinimumWork exit policy - Minimum insts to pseudoretire before exiting.')
 
     # Set to 0 to disable
     runaheadInFlightThreshold = Param.Cycles(100, 'Max LLL in-flight cycles before it cannot trigger runahead.')
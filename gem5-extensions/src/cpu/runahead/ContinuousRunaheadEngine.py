@@ -0,0 +1,17 @@
+from m5.params import *
+from m5.proxy import *
+from m5.objects.ClockedObject import ClockedObject
+
+class ContinuousRunaheadEngine(ClockedObject):
+    type = 'ContinuousRunaheadEngine'
+    cxx_class = 'gem5::runahead::ContinuousRunaheadEngine'
+    cxx_header = "cpu/runahead/continuous_runahead.hh"
+
+    port = RequestPort('Port to the LLC side of the memory hierarchy')
+    system = Param.System(Parent.any, 'System the engine belongs to')
+
+    chainCacheEntries = Param.Unsigned(8, 'Amount of dependence chains kept by the engine')
+    issueWidth = Param.Unsigned(1, 'Chain operations executed per cycle')
+    maxDistance = Param.Unsigned(64, 'Max iterations a chain is run ahead of the core')
+    maxOutstanding = Param.Unsigned(16, 'Max requests in flight from the engine')
+    trackedPrefetches = Param.Unsigned(1024, 'Amount of prefetched blocks remembered to measure coverage')
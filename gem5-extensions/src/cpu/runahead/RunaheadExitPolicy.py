@@ -0,0 +1,31 @@
+from m5.SimObject import SimObject
+from m5.params import *
+
+class RunaheadExitPolicy(SimObject):
+    type = 'RunaheadExitPolicy'
+    abstract = True
+    cxx_class = 'gem5::runahead::ExitPolicy'
+    cxx_header = "cpu/runahead/exit_policy.hh"
+
+class EagerExitPolicy(RunaheadExitPolicy):
+    type = 'EagerExitPolicy'
+    cxx_class = 'gem5::runahead::EagerExitPolicy'
+    cxx_header = "cpu/runahead/exit_policy.hh"
+
+class MinimumWorkExitPolicy(RunaheadExitPolicy):
+    type = 'MinimumWorkExitPolicy'
+    cxx_class = 'gem5::runahead::MinimumWorkExitPolicy'
+    cxx_header = "cpu/runahead/exit_policy.hh"
+    minWork = Param.Unsigned(100, 'Minimum insts to pseudoretire before exiting')
+
+class NLLBExitPolicy(RunaheadExitPolicy):
+    type = 'NLLBExitPolicy'
+    cxx_class = 'gem5::runahead::NLLBExitPolicy'
+    cxx_header = "cpu/runahead/exit_policy.hh"
+
+class DynamicDelayedExitPolicy(RunaheadExitPolicy):
+    type = 'DynamicDelayedExitPolicy'
+    cxx_class = 'gem5::runahead::DynamicDelayedExitPolicy'
+    cxx_header = "cpu/runahead/exit_policy.hh"
+    loadSearchLimit = Param.Int(0, 'Valid loads from the ROB head to look at for an unsent one '
+                                   '(0 looks at the first one only, -1 at all of them)')
@@ -0,0 +1,194 @@
+#include "cpu/runahead/age_matrix.hh"
+
+#include <algorithm>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "cpu/runahead/dyn_inst.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+namespace
+{
+
+constexpr unsigned WordBits = 64;
+
+} // anonymous namespace
+
+AgeMatrix::AgeMatrix(unsigned capacity)
+{
+    unsigned words = divCeil(std::max(capacity, 1u), WordBits);
+    numWords = words;
+    numSlots = words * WordBits;
+
+    insts.resize(numSlots);
+    opClasses.resize(numSlots, No_OpClass);
+    seqNums.resize(numSlots, 0);
+    older.resize(numSlots * numWords, 0);
+    ready.resize(Num_OpClasses * numWords, 0);
+    occupied.resize(numWords, 0);
+    blocked.resize(numWords, 0);
+}
+
+void
+AgeMatrix::grow()
+{
+    unsigned new_words = numWords + 1;
+    unsigned new_slots = new_words * WordBits;
+
+    // Rows and class bitvectors get a word longer, the new word is all zeroes
+    std::vector<uint64_t> new_older(new_slots * new_words, 0);
+    for (unsigned slot = 0; slot < numSlots; slot++) {
+        for (unsigned w = 0; w < numWords; w++)
+            new_older[slot * new_words + w] = older[slot * numWords + w];
+    }
+
+    std::vector<uint64_t> new_ready(Num_OpClasses * new_words, 0);
+    for (unsigned op_class = 0; op_class < Num_OpClasses; op_class++) {
+        for (unsigned w = 0; w < numWords; w++)
+            new_ready[op_class * new_words + w] = ready[op_class * numWords + w];
+    }
+
+    older.swap(new_older);
+    ready.swap(new_ready);
+    occupied.push_back(0);
+    blocked.push_back(0);
+
+    insts.resize(new_slots);
+    opClasses.resize(new_slots, No_OpClass);
+    seqNums.resize(new_slots, 0);
+
+    numWords = new_words;
+    numSlots = new_slots;
+}
+
+void
+AgeMatrix::insert(const DynInstPtr &inst, OpClass op_class)
+{
+    int slot = NoSlot;
+    for (unsigned w = 0; w < numWords && slot == NoSlot; w++) {
+        if (~occupied[w])
+            slot = w * WordBits + findLsbSet(~occupied[w]);
+    }
+    if (slot == NoSlot) {
+        slot = numSlots;
+        grow();
+    }
+
+    const InstSeqNum seq_num = inst->seqNum;
+    insts[slot] = inst;
+    opClasses[slot] = op_class;
+    seqNums[slot] = seq_num;
+
+    // Fill in the row of the new slot, and its column in the rows of the others
+    uint64_t *new_row = row(slot);
+    const unsigned slot_word = slot / WordBits;
+    const uint64_t slot_bit = 1ULL << (slot % WordBits);
+
+    for (unsigned w = 0; w < numWords; w++) {
+        new_row[w] = 0;
+        uint64_t others = occupied[w];
+        while (others) {
+            int other = w * WordBits + findLsbSet(others);
+            others &= others - 1;
+
+            if (seqNums[other] < seq_num) {
+                new_row[w] |= 1ULL << (other % WordBits);
+                row(other)[slot_word] &= ~slot_bit;
+            } else {
+                row(other)[slot_word] |= slot_bit;
+            }
+        }
+    }
+
+    occupied[slot_word] |= slot_bit;
+    classSlots(op_class)[slot_word] |= slot_bit;
+}
+
+void
+AgeMatrix::remove(int slot)
+{
+    const unsigned slot_word = slot / WordBits;
+    const uint64_t slot_bit = 1ULL << (slot % WordBits);
+
+    assert(occupied[slot_word] & slot_bit);
+
+    // Stale bits in the column of the slot are overwritten when it is used again
+    occupied[slot_word] &= ~slot_bit;
+    blocked[slot_word] &= ~slot_bit;
+    classSlots(opClasses[slot])[slot_word] &= ~slot_bit;
+    insts[slot] = nullptr;
+}
+
+int
+AgeMatrix::oldest() const
+{
+    for (unsigned w = 0; w < numWords; w++) {
+        uint64_t candidates = occupied[w] & ~blocked[w];
+        while (candidates) {
+            int slot = w * WordBits + findLsbSet(candidates);
+            candidates &= candidates - 1;
+
+            // Oldest if no selectable slot is older
+            const uint64_t *slot_row = row(slot);
+            bool is_oldest = true;
+            for (unsigned k = 0; k < numWords && is_oldest; k++)
+                is_oldest = !(slot_row[k] & occupied[k] & ~blocked[k]);
+
+            if (is_oldest)
+                return slot;
+        }
+    }
+
+    return NoSlot;
+}
+
+void
+AgeMatrix::block(OpClass op_class)
+{
+    const uint64_t *slots = &ready[op_class * numWords];
+    for (unsigned w = 0; w < numWords; w++)
+        blocked[w] |= slots[w];
+}
+
+void
+AgeMatrix::unblockAll()
+{
+    std::fill(blocked.begin(), blocked.end(), 0);
+}
+
+bool
+AgeMatrix::empty() const
+{
+    for (uint64_t word : occupied) {
+        if (word)
+            return false;
+    }
+    return true;
+}
+
+unsigned
+AgeMatrix::size(OpClass op_class) const
+{
+    unsigned count = 0;
+    for (unsigned w = 0; w < numWords; w++)
+        count += popCount(ready[op_class * numWords + w]);
+    return count;
+}
+
+void
+AgeMatrix::clear()
+{
+    for (auto &inst : insts)
+        inst = nullptr;
+
+    std::fill(ready.begin(), ready.end(), 0);
+    std::fill(occupied.begin(), occupied.end(), 0);
+    std::fill(blocked.begin(), blocked.end(), 0);
+}
+
+} // namespace runahead
+} // namespace gem5
@@ -0,0 +1,101 @@
+#ifndef __CPU_RUNAHEAD_AGE_MATRIX_HH__
+#define __CPU_RUNAHEAD_AGE_MATRIX_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "cpu/inst_seq.hh"
+#include "cpu/op_class.hh"
+#include "cpu/runahead/dyn_inst_ptr.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+/**
+ * Ready instructions of the IQ in an age matrix, to select the oldest ready instruction across
+ * op classes with word-wide bit operations instead of sorted lists.
+ *
+ * Each ready instruction takes a slot. Row i of the matrix has a bit set for every slot holding
+ * an instruction older than the one in slot i, and each op class has a bitvector of the slots
+ * holding its instructions. The oldest instruction among a set of slots is the one whose row has
+ * no bit in common with the set.
+ *
+ * An op class without a free FU is blocked for the rest of the cycle, which takes its slots out
+ * of the selection, the same as skipping its queue in the age ordered list of ready queues.
+ * The matrix grows by a word of slots when it runs out.
+ */
+class AgeMatrix
+{
+  public:
+    /** No instruction to select */
+    static constexpr int NoSlot = -1;
+
+  private:
+    /** Amount of slots, always a multiple of the word size */
+    unsigned numSlots = 0;
+
+    /** Words per bitvector */
+    unsigned numWords = 0;
+
+    /** Instruction, op class and sequence number in each slot */
+    std::vector<DynInstPtr> insts;
+    std::vector<OpClass> opClasses;
+    std::vector<InstSeqNum> seqNums;
+
+    /** Age matrix, numWords words per row. Row i has the slots older than slot i */
+    std::vector<uint64_t> older;
+
+    /** Slots of each op class, numWords words per op class */
+    std::vector<uint64_t> ready;
+
+    /** Slots in use */
+    std::vector<uint64_t> occupied;
+
+    /** Slots of the op classes blocked this cycle */
+    std::vector<uint64_t> blocked;
+
+    uint64_t *row(int slot) { return &older[slot * numWords]; }
+    const uint64_t *row(int slot) const { return &older[slot * numWords]; }
+    uint64_t *classSlots(OpClass op_class) { return &ready[op_class * numWords]; }
+
+    /** Add a word of slots */
+    void grow();
+
+  public:
+    /** Create a matrix of at least the given amount of slots */
+    explicit AgeMatrix(unsigned capacity);
+
+    /** Add a ready instruction */
+    void insert(const DynInstPtr &inst, OpClass op_class);
+
+    /** Remove the instruction in a slot */
+    void remove(int slot);
+
+    /** Slot of the oldest instruction of an op class that is not blocked, or NoSlot */
+    int oldest() const;
+
+    /** Take the slots of an op class out of selection until unblockAll() */
+    void block(OpClass op_class);
+
+    /** Make all op classes selectable again, at the start of a cycle */
+    void unblockAll();
+
+    const DynInstPtr &inst(int slot) const { return insts[slot]; }
+    OpClass opClass(int slot) const { return opClasses[slot]; }
+
+    /** Whether or not no instruction is ready */
+    bool empty() const;
+
+    /** Amount of ready instructions of an op class */
+    unsigned size(OpClass op_class) const;
+
+    /** Remove all instructions */
+    void clear();
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_AGE_MATRIX_HH__
@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <cstring>
+
 #include "cpu/runahead/arch_checkpoint.hh"
 #include "cpu/runahead/cpu.hh"
+#include "base/bitfield.hh"
 #include "config/the_isa.hh"
 #include "cpu/reg_class.hh"
 #include "debug/RunaheadCheckpoint.hh"
@@ -11,19 +15,30 @@ namespace runahead
 {
 
 ArchCheckpoint::ArchCheckpoint(CPU *cpu, const BaseRunaheadCPUParams &params) :
-    cpu(cpu), numThreads(params.numThreads)
+    cpu(cpu), numThreads(params.numThreads), periodBytesSaved(0), stats(cpu)
 {
+    size_t totalBytes = 0;
     const auto &regClasses = params.isa[0]->regClasses();
 
-    // setup checkpoint list
-    // TODO: vector register/pred register support. ISA regclasses store their reg size
+    // Preallocate packed storage for every register class, at the full register width
     for (int regTypeIdx = 0; regTypeIdx <= MiscRegClass; regTypeIdx++) {
         RegClassType regType = static_cast<RegClassType>(regTypeIdx);
         const RegClass &cls = regClasses.at(regType);
 
         RegCheckpoint &checkpoint = registerCheckpoints[regTypeIdx];
-        checkpoint.values.resize(cls.numRegs());
+        // Scalar classes are accessed as whole RegVals, even if the class is narrower
+        checkpoint.regBytes = regType == MiscRegClass ?
+            sizeof(RegVal) : std::max(cls.regBytes(), sizeof(RegVal));
+        checkpoint.numRegs = cls.numRegs();
+        checkpoint.values.resize(checkpoint.numRegs * checkpoint.regBytes, 0);
+        checkpoint.scratch.resize(checkpoint.regBytes, 0);
+        checkpoint.validBits.resize((checkpoint.numRegs + 63) / 64, 0);
+        totalBytes += checkpoint.values.size();
     }
+
+    stats.bytesSavedPerPeriod
+        .init(0, totalBytes, std::max<size_t>(1, totalBytes / 16))
+        .flags(statistics::total);
 }
 
 std::string
@@ -32,37 +47,76 @@ ArchCheckpoint::name() const
      return cpu->name() + ".arch_checkpoint";
 }
 
+void
+ArchCheckpoint::saveReg(ThreadID tid, RegCheckpoint &checkpoint, const RegId &archReg)
+{
+    uint8_t *slot = checkpoint.reg(archReg.index());
+    if (archReg.classValue() == MiscRegClass) {
+        RegVal val = cpu->readMiscReg(archReg.index(), tid);
+        std::memcpy(slot, &val, sizeof(RegVal));
+    } else {
+        // Read straight into the packed storage, whatever the register width
+        cpu->getArchReg(archReg, slot, tid);
+    }
+}
+
+bool
+ArchCheckpoint::restoreReg(ThreadID tid, RegCheckpoint &checkpoint, const RegId &archReg)
+{
+    RegClassType regType = archReg.classValue();
+    RegIndex archIdx = archReg.index();
+    const uint8_t *slot = checkpoint.reg(archIdx);
+
+    if (regType != MiscRegClass) {
+        // Check if the value is actually different.
+        // This is mostly just to reduce the amount of debug prints
+        cpu->getArchReg(archReg, checkpoint.scratch.data(), tid);
+        if (std::memcmp(checkpoint.scratch.data(), slot, checkpoint.regBytes) != 0) {
+            DPRINTF(RunaheadCheckpoint,
+                "[tid:%i] Restoring %s arch reg %i to value %s (was %s)\n",
+                tid, archReg.className(), archIdx,
+                archReg.regClass().valString(slot),
+                archReg.regClass().valString(checkpoint.scratch.data()));
+            cpu->setArchReg(archReg, slot, tid);
+            return true;
+        }
+    } else {
+        RegVal checkpointVal;
+        std::memcpy(&checkpointVal, slot, sizeof(RegVal));
+        RegVal curVal = cpu->readMiscReg(archIdx, tid);
+        if (curVal != checkpointVal) { // && archIdx == TheISA::misc_reg::Rflags
+            DPRINTF(RunaheadCheckpoint, "[tid:%i] Restoring misc reg %i to value %#x (was %#x)\n",
+                    tid, archIdx, checkpointVal, curVal);
+            cpu->setMiscRegNoEffect(archIdx, checkpointVal, tid);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void
 ArchCheckpoint::fullSave(ThreadID tid)
 {
     // Save all the architectural registers
-    const auto &regClasses = cpu->isa[0]->regClasses();
     for (int regTypeIdx = 0; regTypeIdx < registerCheckpoints.size(); regTypeIdx++) {
         RegClassType regType = static_cast<RegClassType>(regTypeIdx);
-        if (regType == VecRegClass || regType == VecPredRegClass)
-            continue;
-
-        RegClass regClass = regClasses.at(regType);
-        size_t numRegs = regClass.numRegs();
-
         RegCheckpoint &checkpoint = registerCheckpoints[regTypeIdx];
-        checkpoint.validIdxs.clear();
-        for (RegIndex archIdx = 0; archIdx < numRegs; archIdx++) {
-            RegId archReg(regType, archIdx);
-            RegVal val;
-            if (regType == MiscRegClass) {
-                // x86 specific
-                if (!TheISA::misc_reg::isValid(archIdx))
-                    continue;
-                val = cpu->readMiscReg(archIdx, tid);
-            } else {
-                val = cpu->getArchReg(archReg, tid);
-            }
 
-            checkpoint.values[archIdx] = val;
-            checkpoint.validIdxs.push_back(archIdx);
+        for (RegIndex archIdx = 0; archIdx < checkpoint.numRegs; archIdx++) {
+            // x86 specific
+            if (regType == MiscRegClass && !TheISA::misc_reg::isValid(archIdx))
+                continue;
+
+            saveReg(tid, checkpoint, RegId(regType, archIdx));
         }
+
+        checkpoint.setAllValid();
+        periodBytesSaved += checkpoint.values.size();
+        stats.bytesSaved += checkpoint.values.size();
     }
+
+    stats.fullSaves++;
 }
 
 void
@@ -72,45 +126,36 @@ ArchCheckpoint::restore(ThreadID tid)
     for (int regTypeIdx = 0; regTypeIdx < registerCheckpoints.size(); regTypeIdx++) {
         RegClassType regType = static_cast<RegClassType>(regTypeIdx);
         // unsupported
-        if (regType == VecRegClass || regType == VecPredRegClass || regType == MiscRegClass)
+        if (regType == MiscRegClass)
             continue;
 
-        // Go through all value checkpoints for this specific register type, e.g. all int reg checkpoints
+        // Go through all valid checkpoints for this specific register type, e.g. all int reg checkpoints
         RegCheckpoint &checkpoint = registerCheckpoints[regTypeIdx];
-        if (checkpoint.validIdxs.empty())
+        if (checkpoint.numValid == 0)
             continue;
 
-        for (auto i = checkpoint.validIdxs.begin(); i != checkpoint.validIdxs.end(); i++) {
-            RegIndex archIdx = *i;
-            RegId reg(regType, archIdx);
-            RegVal curVal;
-            RegVal checkpointVal = checkpoint.values[archIdx];
-
-            if (regType != MiscRegClass) {
-                curVal = cpu->getArchReg(reg, tid);
-
-                // Check if the value is actually different.
-                // This is mostly just to reduce the amount of debug prints
-                if (curVal != checkpointVal) {
-                    DPRINTF(RunaheadCheckpoint,
-                        "[tid:%i] Restoring %s arch reg %i to value %#x (was %#x)\n",
-                        tid, reg.className(), reg.index(),
-                        checkpointVal, curVal);
-                    cpu->setArchReg(reg, checkpointVal, tid);
-                }
-            } else {
-                curVal = cpu->readMiscReg(archIdx, tid);
-                if (curVal != checkpointVal) { // && archIdx == TheISA::misc_reg::Rflags
-                    DPRINTF(RunaheadCheckpoint, "[tid:%i] Restoring misc reg %i to value %#x (was %#x)\n",
-                            tid, archIdx, checkpointVal, curVal);
-                    cpu->setMiscRegNoEffect(archIdx, checkpointVal, tid);
+        for (size_t wordIdx = 0; wordIdx < checkpoint.validBits.size(); wordIdx++) {
+            uint64_t word = checkpoint.validBits[wordIdx];
+            while (word) {
+                int bit = findLsbSet(word);
+                word &= word - 1;
+
+                RegIndex archIdx = wordIdx * 64 + bit;
+                stats.regsChecked++;
+                if (restoreReg(tid, checkpoint, RegId(regType, archIdx))) {
+                    stats.regsRestored++;
+                    stats.bytesRestored += checkpoint.regBytes;
                 }
             }
         }
 
         // All checkpoints for this register class have been restored, make them invalid
-        checkpoint.validIdxs.clear();
+        checkpoint.clearValid();
     }
+
+    // This ends the checkpoint's runahead period
+    stats.bytesSavedPerPeriod.sample(periodBytesSaved);
+    periodBytesSaved = 0;
 }
 
 void
@@ -119,42 +164,46 @@ ArchCheckpoint::updateReg(ThreadID tid, RegId archReg)
     // Checkpoint updates should not happen in runahead
     assert(!cpu->inRunahead(tid));
 
-    if (archReg.classValue() == VecRegClass || archReg.classValue() == VecPredRegClass) {
-        DPRINTF(RunaheadCheckpoint, "VecRegClass/VecPredClass register checkpointing is unsupported. This update is ignored.\n");
-        return;
-    }
-
     if (archReg.classValue() == InvalidRegClass)
         return;
 
-    RegVal val;
     RegIndex archIdx = archReg.index();
     RegClassType regClass = archReg.classValue();
-    if (archReg.classValue() == MiscRegClass) {
-        // x86 specific: it has invalid misc registers
-        if (!TheISA::misc_reg::isValid(archIdx))
-            return;
-        val = cpu->readMiscReg(archIdx, tid);
-    } else {
-        val = cpu->getArchReg(archReg, tid);
-    }
+    // x86 specific: it has invalid misc registers
+    if (regClass == MiscRegClass && !TheISA::misc_reg::isValid(archIdx))
+        return;
 
     RegCheckpoint &checkpoint = registerCheckpoints[regClass];
-    checkpoint.values[archIdx] = val;
-
-    // Admittedly this is a ugly hack implementation of a set of unique indices
-    // Would've used std::set or std::unordered_set but they segfault and I don't know why
-    bool inValidSet = false;
-    for (auto i = checkpoint.validIdxs.begin(); i != checkpoint.validIdxs.end(); i++) {
-        RegIndex idx = *i;
-        if (idx == archIdx) {
-            inValidSet = true;
-            break;
-        }
-    }
+    saveReg(tid, checkpoint, archReg);
+
+    periodBytesSaved += checkpoint.regBytes;
+    stats.bytesSaved += checkpoint.regBytes;
+    stats.regUpdates++;
 
-    if (!inValidSet)
-        checkpoint.validIdxs.push_back(archIdx);
+    if (!checkpoint.setValid(archIdx))
+        stats.redundantRegUpdates++;
+}
+
+ArchCheckpoint::ArchCheckpointStats::ArchCheckpointStats(CPU *cpu)
+    : statistics::Group(cpu, "archcheckpoint"),
+      ADD_STAT(fullSaves, statistics::units::Count::get(),
+           "Number of full architectural checkpoints taken"),
+      ADD_STAT(regUpdates, statistics::units::Count::get(),
+           "Number of single register checkpoint updates"),
+      ADD_STAT(redundantRegUpdates, statistics::units::Count::get(),
+           "Number of single register updates to an already valid checkpoint"),
+      ADD_STAT(bytesSaved, statistics::units::Byte::get(),
+           "Total bytes written to the architectural checkpoint"),
+      ADD_STAT(bytesSavedPerPeriod, statistics::units::Byte::get(),
+           "Bytes written to the architectural checkpoint per runahead period"),
+      ADD_STAT(regsChecked, statistics::units::Count::get(),
+           "Number of registers compared against the checkpoint on restore"),
+      ADD_STAT(regsRestored, statistics::units::Count::get(),
+           "Number of registers that differed from the checkpoint and were restored"),
+      ADD_STAT(bytesRestored, statistics::units::Byte::get(),
+           "Bytes written back to the register file on restore")
+{
+    redundantRegUpdates.prereq(redundantRegUpdates);
 }
 
 } // namespace runahead
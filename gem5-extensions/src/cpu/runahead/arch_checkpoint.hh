@@ -1,6 +1,10 @@
 #ifndef __CPU_RUNAHEAD_ARCH_CHECKPOINT_HH__
 #define __CPU_RUNAHEAD_ARCH_CHECKPOINT_HH__
 
+#include <algorithm>
+#include <vector>
+
+#include "base/statistics.hh"
 #include "cpu/runahead/regfile.hh"
 #include "cpu/runahead/rename_map.hh"
 #include "cpu/runahead/free_list.hh"
@@ -26,10 +30,59 @@ class ArchCheckpoint
 {
 private:
     struct RegCheckpoint {
-        /** The checkpointed values */
-        std::vector<RegVal> values;
-        /** Indices of valid checkpoint */
-        std::list<RegIndex> validIdxs;
+        /**
+         * The checkpointed values, packed back to back and preallocated for the entire class.
+         * Register n resides at byte offset n * regBytes, regardless of register width.
+         */
+        std::vector<uint8_t> values;
+        /** Scratch space for a single register, used to compare against current values */
+        std::vector<uint8_t> scratch;
+        /** Width of a single register in bytes */
+        size_t regBytes = 0;
+        /** Number of registers in the class */
+        size_t numRegs = 0;
+        /**
+         * Bitmap of registers with a valid checkpoint, one bit per register.
+         * Setting a bit is O(1) and naturally deduplicates repeated updates of a register.
+         */
+        std::vector<uint64_t> validBits;
+        /** Number of set bits in validBits */
+        size_t numValid = 0;
+
+        /** Mark a register as valid. Returns false if it was already valid */
+        bool
+        setValid(RegIndex idx)
+        {
+            uint64_t &word = validBits[idx / 64];
+            uint64_t bit = 1ULL << (idx % 64);
+            if (word & bit)
+                return false;
+            word |= bit;
+            numValid++;
+            return true;
+        }
+
+        /** Mark all registers in the class as valid */
+        void
+        setAllValid()
+        {
+            std::fill(validBits.begin(), validBits.end(), ~0ULL);
+            // Don't set bits past the last register
+            if (numRegs % 64)
+                validBits.back() = (1ULL << (numRegs % 64)) - 1;
+            numValid = numRegs;
+        }
+
+        /** Invalidate all registers in the class */
+        void
+        clearValid()
+        {
+            if (numValid > 0)
+                std::fill(validBits.begin(), validBits.end(), 0);
+            numValid = 0;
+        }
+
+        uint8_t *reg(RegIndex idx) { return values.data() + idx * regBytes; }
     };
 
     /** The CPU whose state is checkpointed */
@@ -44,6 +97,40 @@ private:
      */
     std::array<RegCheckpoint, MiscRegClass + 1> registerCheckpoints;
 
+    /** Save a single architectural register into its checkpoint slot */
+    void saveReg(ThreadID tid, RegCheckpoint &checkpoint, const RegId &archReg);
+
+    /**
+     * Restore a single architectural register from its checkpoint slot.
+     * Returns true if the register differed from the checkpoint and was written.
+     */
+    bool restoreReg(ThreadID tid, RegCheckpoint &checkpoint, const RegId &archReg);
+
+    /** Bytes written to the checkpoint since the last restore */
+    uint64_t periodBytesSaved;
+
+    struct ArchCheckpointStats : public statistics::Group
+    {
+        ArchCheckpointStats(CPU *cpu);
+
+        /** Number of full checkpoint saves */
+        statistics::Scalar fullSaves;
+        /** Number of single register checkpoint updates */
+        statistics::Scalar regUpdates;
+        /** Number of single register updates to a register that was already valid */
+        statistics::Scalar redundantRegUpdates;
+        /** Total bytes written to the checkpoint */
+        statistics::Scalar bytesSaved;
+        /** Bytes written to the checkpoint per runahead period */
+        statistics::Distribution bytesSavedPerPeriod;
+        /** Number of registers compared against the checkpoint on restore */
+        statistics::Scalar regsChecked;
+        /** Number of registers that differed from the checkpoint and were written on restore */
+        statistics::Scalar regsRestored;
+        /** Bytes written back to the register file on restore */
+        statistics::Scalar bytesRestored;
+    } stats;
+
 public:
     ArchCheckpoint(CPU *cpu, const BaseRunaheadCPUParams &params);
 
@@ -0,0 +1,133 @@
+#ifndef __CPU_RUNAHEAD_CHAIN_FILTER_HH__
+#define __CPU_RUNAHEAD_CHAIN_FILTER_HH__
+
+#include <algorithm>
+#include <vector>
+
+#include "arch/generic/pcstate.hh"
+#include "base/intmath.hh"
+#include "cpu/runahead/pc_pair.hh"
+
+namespace gem5
+{
+
+namespace runahead
+{
+
+/**
+ * Membership filter for the runahead chain, queried by fetch for every instruction in
+ * filtered runahead. The chain PCs are placed in a small open-addressed hash table when
+ * the chain is generated, so lookups are O(1) instead of a scan over the whole chain.
+ * The last PC of the chain is kept on the side to cheaply detect chain loops.
+ */
+class RunaheadChainFilter
+{
+  private:
+    struct Slot
+    {
+        Addr pc = 0;
+        MicroPC upc = 0;
+        bool valid = false;
+    };
+
+    /** Hash table slots. The amount of slots is always a power of 2 */
+    std::vector<Slot> slots;
+
+    /** Mask to turn a hash into a slot index */
+    size_t mask = 0;
+
+    /** Amount of PCs in the filter */
+    size_t numEntries = 0;
+
+    /** The last PC of the chain */
+    Slot end;
+
+    static size_t
+    hash(Addr pc, MicroPC upc)
+    {
+        uint64_t key = pc ^ ((uint64_t)upc << 48);
+        key ^= key >> 29;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 32;
+        return key;
+    }
+
+  public:
+    /** Place the given chain in the filter, replacing whatever was there */
+    void
+    build(const std::vector<PCPair> &chain)
+    {
+        clear();
+        if (chain.empty())
+            return;
+
+        // Keep the load factor at or below 1/2 so probe sequences stay short
+        size_t numSlots = std::max<size_t>(16, 1ULL << ceilLog2(chain.size() * 2));
+        if (slots.size() < numSlots)
+            slots.resize(numSlots);
+        mask = slots.size() - 1;
+
+        for (const PCPair &pcPair : chain) {
+            size_t idx = hash(pcPair.pc, pcPair.upc) & mask;
+            while (slots[idx].valid &&
+                   !(slots[idx].pc == pcPair.pc && slots[idx].upc == pcPair.upc))
+                idx = (idx + 1) & mask;
+
+            if (!slots[idx].valid) {
+                slots[idx].pc = pcPair.pc;
+                slots[idx].upc = pcPair.upc;
+                slots[idx].valid = true;
+                numEntries++;
+            }
+        }
+
+        end.pc = chain.back().pc;
+        end.upc = chain.back().upc;
+        end.valid = true;
+    }
+
+    /** Empty the filter */
+    void
+    clear()
+    {
+        if (numEntries > 0) {
+            for (Slot &slot : slots)
+                slot.valid = false;
+        }
+        numEntries = 0;
+        end.valid = false;
+    }
+
+    /** Amount of distinct PCs in the filter */
+    size_t size() const { return numEntries; }
+
+    /** Whether or not the given PC is in the chain */
+    bool
+    contains(const PCStateBase &pcState) const
+    {
+        if (numEntries == 0)
+            return false;
+
+        Addr pc = pcState.instAddr();
+        MicroPC upc = pcState.microPC();
+        size_t idx = hash(pc, upc) & mask;
+        while (slots[idx].valid) {
+            if (slots[idx].pc == pc && slots[idx].upc == upc)
+                return true;
+            idx = (idx + 1) & mask;
+        }
+        return false;
+    }
+
+    /** Whether or not the given PC is the last PC of the chain */
+    bool
+    isEnd(const PCStateBase &pcState) const
+    {
+        return end.valid && end.pc == pcState.instAddr() && end.upc == pcState.microPC();
+    }
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_CHAIN_FILTER_HH__
@@ -0,0 +1,141 @@
+#include "cpu/runahead/chain_pattern.hh"
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "cpu/runahead/cpu.hh"
+#include "cpu/runahead/dyn_inst.hh"
+#include "debug/RunaheadChains.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+/** Minimum instances of a load needed to trust its stride */
+static constexpr unsigned MinInstances = 3;
+
+bool
+findChainPattern(CPU *cpu, ThreadID tid, const DynInstPtr &lll, ChainPattern &pat)
+{
+    struct Instance
+    {
+        Addr pc;
+        Addr addr;
+        unsigned size;
+        /** Loaded value, if the load has its real data */
+        bool hasValue;
+        uint64_t value;
+    };
+
+    pat = ChainPattern();
+    Addr lllPC = lll->pcState().instAddr();
+
+    // Collect the loads in the window that computed their address, in program order
+    std::vector<Instance> loads;
+    std::map<Addr, std::vector<size_t>> instancesByPC;
+    for (const DynInstPtr &inst : cpu->instWindow) {
+        if (inst->threadNumber != tid || inst->seqNum < lll->seqNum || inst->isSquashed() ||
+            !inst->isLoad() || inst->isVector() || !inst->effAddrValid())
+            continue;
+
+        Addr pc = inst->pcState().instAddr();
+        // Only the LLL and loads that lead up to it can be part of its pattern
+        if (pc != lllPC && !cpu->inRunaheadChain(inst))
+            continue;
+
+        Instance instance = { pc, inst->effAddr, inst->effSize, false, 0 };
+        if (inst->isExecuted() && !inst->isPoisoned() && !inst->isPredicted() &&
+            inst->memData && inst->effSize <= sizeof(uint64_t)) {
+            instance.hasValue = true;
+            std::memcpy(&instance.value, inst->memData, inst->effSize);
+        }
+
+        instancesByPC[pc].push_back(loads.size());
+        loads.push_back(instance);
+    }
+
+    // Constant, non-zero stride over enough instances
+    auto stride = [&](const std::vector<size_t> &idxs, int64_t &out) {
+        if (idxs.size() < MinInstances)
+            return false;
+        out = loads[idxs[1]].addr - loads[idxs[0]].addr;
+        if (out == 0)
+            return false;
+        for (size_t i = 2; i < idxs.size(); i++) {
+            if ((int64_t)(loads[idxs[i]].addr - loads[idxs[i - 1]].addr) != out)
+                return false;
+        }
+        return true;
+    };
+
+    const std::vector<size_t> &lllInstances = instancesByPC[lllPC];
+    pat.pc = lllPC;
+    pat.lllSize = lll->effSize;
+
+    // Direct: the LLL itself is strided
+    if (stride(lllInstances, pat.stride)) {
+        pat.valid = true;
+        pat.lastAddr = loads[lllInstances.back()].addr;
+        pat.size = lll->effSize;
+        DPRINTF(RunaheadChains, "[tid:%i] LLL PC %#x is strided by %lli.\n",
+                tid, lllPC, pat.stride);
+        return true;
+    }
+
+    // Indirect: a strided chain load supplies the value the LLL address is computed from
+    for (const auto &candidate : instancesByPC) {
+        int64_t indexStride = 0;
+        if (candidate.first == lllPC || !stride(candidate.second, indexStride))
+            continue;
+
+        // Pair each LLL instance with the closest older instance of the candidate
+        std::vector<std::pair<uint64_t, Addr>> pairs;
+        const Instance *lastIndex = nullptr;
+        for (const Instance &instance : loads) {
+            if (instance.pc == candidate.first)
+                lastIndex = instance.hasValue ? &instance : nullptr;
+            else if (instance.pc == lllPC && lastIndex)
+                pairs.push_back({lastIndex->value, instance.addr});
+        }
+
+        // Fit addr = base + scale * value on two pairs with different values
+        size_t second = 1;
+        while (second < pairs.size() && pairs[second].first == pairs[0].first)
+            second++;
+        if (second >= pairs.size())
+            continue;
+
+        int64_t valueDelta = pairs[second].first - pairs[0].first;
+        int64_t addrDelta = pairs[second].second - pairs[0].second;
+        if (addrDelta % valueDelta != 0)
+            continue;
+        int64_t scale = addrDelta / valueDelta;
+        Addr base = pairs[0].second - scale * pairs[0].first;
+
+        bool fits = true;
+        for (const auto &pair : pairs)
+            fits = fits && (base + scale * pair.first == pair.second);
+        if (!fits)
+            continue;
+
+        const Instance &youngest = loads[candidate.second.back()];
+        pat.valid = true;
+        pat.indirect = true;
+        pat.lastAddr = youngest.addr;
+        pat.stride = indexStride;
+        pat.size = youngest.size;
+        pat.base = base;
+        pat.scale = scale;
+        DPRINTF(RunaheadChains, "[tid:%i] LLL PC %#x is indirect through PC %#x "
+                "(stride %lli, addr = %#x + %lli * value).\n",
+                tid, lllPC, candidate.first, indexStride, base, scale);
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace runahead
+} // namespace gem5
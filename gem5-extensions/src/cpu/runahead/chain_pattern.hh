@@ -0,0 +1,49 @@
+#ifndef __CPU_RUNAHEAD_CHAIN_PATTERN_HH__
+#define __CPU_RUNAHEAD_CHAIN_PATTERN_HH__
+
+#include "base/types.hh"
+#include "cpu/runahead/dyn_inst_ptr.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * Address pattern of a LLL and its dependence chain, found by inspecting the instances of
+ * the LLL and its chain loads in the instruction window. One of:
+ *  - Direct: the LLL address advances by a constant stride.
+ *  - Indirect: a chain load advances by a constant stride, and the LLL address is a linear
+ *    function of the value it loaded, i.e. b[a[i]].
+ */
+struct ChainPattern
+{
+    bool valid = false;
+    bool indirect = false;
+    /** PC of the LLL */
+    Addr pc = 0;
+    /** Address of the youngest instance of the strided load */
+    Addr lastAddr = 0;
+    /** Stride of the strided load */
+    int64_t stride = 0;
+    /** Access size of the strided load */
+    unsigned size = 0;
+    /** LLL address = base + scale * loaded value, for indirect patterns */
+    Addr base = 0;
+    int64_t scale = 0;
+    /** Access size of the LLL */
+    unsigned lllSize = 0;
+};
+
+/**
+ * Look for a direct or indirect pattern around the LLL in the thread's instruction window.
+ * Chain loads are recognized through the thread's current runahead chain.
+ */
+bool findChainPattern(CPU *cpu, ThreadID tid, const DynInstPtr &lll, ChainPattern &pat);
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_CHAIN_PATTERN_HH__
@@ -42,6 +42,7 @@
 #include "cpu/runahead/commit.hh"
 
 #include <algorithm>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -92,6 +93,7 @@ Commit::processTrapEvent(ThreadID tid, bool wasRunahead)
 Commit::Commit(CPU *_cpu, const BaseRunaheadCPUParams &params)
     : commitPolicy(params.smtCommitPolicy),
       cpu(_cpu),
+      exitPolicy(params.runaheadExitPolicy),
       runaheadExitDeadline(params.runaheadExitDeadline),
       iewToCommitDelay(params.iewToCommitDelay),
       commitToIEWDelay(params.commitToIEWDelay),
@@ -112,6 +114,9 @@ Commit::Commit(CPU *_cpu, const BaseRunaheadCPUParams &params)
              "\tincrease MaxWidth in src/cpu/runahead/limits.hh\n",
              commitWidth, static_cast<int>(MaxWidth));
 
+    fatal_if(params.preciseRunahead && !dynamic_cast<EagerExitPolicy *>(exitPolicy),
+             "Precise runahead requires the eager runahead exit policy.\n");
+
     _status = Active;
     _nextStatus = Inactive;
 
@@ -130,6 +135,7 @@ Commit::Commit(CPU *_cpu, const BaseRunaheadCPUParams &params)
         squashAfterInst[tid] = nullptr;
         pc[tid].reset(params.isa[0]->newPCState());
         youngestSeqNum[tid] = 0;
+        youngestOutsideROB[tid] = 0;
         lastCommitedSeqNum[tid] = 0;
         trapInFlight[tid] = false;
         committedStores[tid] = false;
@@ -139,20 +145,6 @@ Commit::Commit(CPU *_cpu, const BaseRunaheadCPUParams &params)
         htmStops[tid] = 0;
     }
     interrupt = NoFault;
-
-    // Setup runahead exit policy
-    if (params.runaheadExitPolicy == "Eager") {
-        runaheadExitPolicy = REExitPolicy::Eager;
-    } else if (params.runaheadExitPolicy == "MinimumWork") {
-        runaheadExitPolicy = REExitPolicy::MinimumWork;
-        minRunaheadWork = params.minRunaheadWork;
-    } else if (params.runaheadExitPolicy == "NLLB") {
-        runaheadExitPolicy = REExitPolicy::NLLB;
-    } else if (params.runaheadExitPolicy == "DynamicDelayed") {
-        runaheadExitPolicy = REExitPolicy::DynamicDelayed;
-    } else {
-        runaheadExitPolicy = REExitPolicy::Eager;
-    }
 }
 
 std::string Commit::name() const { return cpu->name() + ".commit"; }
@@ -240,6 +232,8 @@ Commit::CommitStats::CommitStats(CPU *cpu, Commit *commit)
                "Number of runahead insts that were retired while it was safe to exit runahead"),
       ADD_STAT(runaheadDelayedLoads, statistics::units::Cycle::get(),
                "Number of runahead loads that were retired while it was safe to exit runahead"),
+      ADD_STAT(preciseRunaheadInsts, statistics::units::Count::get(),
+               "Number of precise runahead insts that bypassed the ROB"),
       ADD_STAT(fullROBLoads, statistics::units::Count::get(),
                "Number of times a load caused a full ROB stall"),
       ADD_STAT(runaheadExitCause, statistics::units::Count::get(),
@@ -330,6 +324,7 @@ Commit::CommitStats::CommitStats(CPU *cpu, Commit *commit)
     runaheadDelayedCycles.prereq(runaheadDelayedCycles);
     runaheadDelayedInsts.prereq(runaheadDelayedInsts);
     runaheadDelayedLoads.prereq(runaheadDelayedLoads);
+    preciseRunaheadInsts.prereq(preciseRunaheadInsts);
 
     fullROBLoads.prereq(fullROBLoads);
 
@@ -402,7 +397,13 @@ Commit::setRenameMap(UnifiedRenameMap rm_ptr[])
         renameMap[tid] = &rm_ptr[tid];
 }
 
-void Commit::setROB(ROB *rob_ptr) { rob = rob_ptr; }
+void
+Commit::setROB(ROB *rob_ptr)
+{
+    rob = rob_ptr;
+    // Let the runahead exit policy inspect the pipeline
+    exitPolicy->setPipeline(cpu, this, rob);
+}
 
 void
 Commit::startupStage()
@@ -490,6 +491,65 @@ Commit::isDrained() const
         interrupt == NoFault;
 }
 
+bool
+Commit::isStalled()
+{
+    assert(numThreads == 1);
+    ThreadID tid = activeThreads->front();
+    if (commitStatus[tid] != Running || trapSquash[tid] || tcSquash[tid] ||
+        trapInFlight[tid] || exitRunahead[tid] || runaheadExitable[tid] ||
+        interrupt != NoFault || drainPending || (FullSystem && cpu->checkInterrupts(0)))
+        return false;
+
+    if (rob->isEmpty(tid) || rob->isHeadReady(tid))
+        return false;
+
+    stallProfile = StallProfile();
+    const DynInstPtr &head_inst = rob->readHeadInst(tid);
+    if (!head_inst->isLoad() || !head_inst->hasRequest())
+        return true;
+
+    stallProfile.loadAtHead = true;
+    LSQ::LSQRequest *lsqRequest = head_inst->savedRequest;
+    if (lsqRequest == nullptr || lsqRequest->isComplete() || !lsqRequest->isSent())
+        return true;
+
+    // The caches bump the depth of the requests without waking the CPU, so a
+    // load that did not miss deep enough yet may become a LLL any cycle
+    for (int idx = 0; !head_inst->isDetectedLLL() && idx < lsqRequest->_reqs.size(); idx++) {
+        if (lsqRequest->req(idx)->getAccessDepth() < cpu->lllDepthThreshold)
+            return false;
+    }
+
+    stallProfile.lllAtHead = true;
+    return cpu->entryDecisionFinal(tid, head_inst, stallProfile.refusedEntry);
+}
+
+void
+Commit::countStalledCycles(Cycles cycles)
+{
+    // Same counters as tick() and commitInsts() would have bumped every cycle
+    if (runaheadInfo.runaheadEnterCycles >= 0)
+        runaheadInfo.runaheadEnterCycles += cycles;
+    if (runaheadInfo.runaheadExitCycles >= 0)
+        runaheadInfo.runaheadExitCycles += cycles;
+
+    stats.numCommittedDist.sample(0, cycles);
+
+    if (stallProfile.loadAtHead)
+        stats.loadsAtROBHead += cycles;
+    if (stallProfile.lllAtHead) {
+        stats.lllAtROBHead += cycles;
+        stats.normalLLLAtROBHead += cycles;
+    }
+    if (stallProfile.refusedEntry >= 0)
+        cpu->cpuStats.refusedRunaheadEntries[stallProfile.refusedEntry] += cycles;
+
+    const DynInstPtr &head_inst = rob->readHeadInst(activeThreads->front());
+    for (uint64_t i = 0; i < cycles; i++)
+        ppCommitStall->notify(head_inst);
+}
+
 void
 Commit::takeOverFrom()
 {
@@ -638,40 +698,7 @@ Commit::signalExitRunahead(ThreadID tid, const DynInstPtr &inst)
     runaheadCause[tid] = inst;
 
     // Handle the signal according to the exit policy
-    if (runaheadExitPolicy == REExitPolicy::Eager) {
-        DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead ASAP due to eager exit policy.\n",
-                tid);
-        exitRunahead[tid] = true;
-        stats.runaheadExitCause[stats.REExitCause::EagerExit]++;
-    } else if (runaheadExitPolicy == REExitPolicy::MinimumWork) {
-        if (instsPseudoretired[tid] >= minRunaheadWork) {
-            DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead now because minimum work has been done.\n",
-                tid, minRunaheadWork);
-            exitRunahead[tid] = true;
-            stats.runaheadExitCause[stats.REExitCause::MinWorkDone]++;
-        } else {
-            DPRINTF(RunaheadCommit, "[tid:%i] %llu/%llu insts have been pseudoretired. Runahead will exit later.\n",
-                    tid, instsPseudoretired[tid], minRunaheadWork);
-        }
-    } else if (runaheadExitPolicy == REExitPolicy::NLLB) {
-        DPRINTF(RunaheadCommit, "[tid:%i] Inspecting ROB for unsent loads.\n", tid);
-
-        InstSeqNum loadSn = rob->findUnsentValidLoad(tid);
-        if (loadSn) {
-            InstSeqNum instsToPseudoRetire = loadSn - rob->readHeadInst(tid)->seqNum;
-            DPRINTF(RunaheadCommit, "Youngest load in ROB has sn:%llu, which is %llu insts away.\n",
-                    loadSn, instsToPseudoRetire);
-
-            runaheadExitSeqNum = loadSn;
-        } else {
-            DPRINTF(RunaheadCommit, "Unable to find any unsent loads, exiting ASAP.\n");
-            exitRunahead[tid] = true;
-            stats.runaheadExitCause[stats.REExitCause::EagerExit]++;
-        }
-    } else if (runaheadExitPolicy == REExitPolicy::DynamicDelayed) {
-        DPRINTF(RunaheadCommit, "[tid:%i] Inspecting ROB for nearby loads.\n", tid);
-        dynamicDelayedRunaheadExit(tid);
-    }
+    applyExitDecision(tid, exitPolicy->lllReturned(tid, inst));
 
     // If we aren't exiting immediately, schedule a deadline event
     InstSeqNum causeSeqNum = inst->seqNum;
@@ -693,6 +720,7 @@ Commit::signalExitRunahead(ThreadID tid, const DynInstPtr &inst)
                 DPRINTF(RunaheadCommit, "[tid:%i] Runahead was not exited, exiting now runahead due to deadline.\n", tid);
                 exitRunahead[tid] = true;
                 stats.runaheadExitCause[stats.REExitCause::Deadline]++;
+                lastExitCause[tid] = stats.REExitCause::Deadline;
 
                 // Wake the CPU in case it started idling
                 cpu->wakeCPU();
@@ -704,33 +732,34 @@ Commit::signalExitRunahead(ThreadID tid, const DynInstPtr &inst)
 }
 
 void
-Commit::dynamicDelayedRunaheadExit(ThreadID tid)
+Commit::applyExitDecision(ThreadID tid, ExitPolicy::Decision decision)
 {
-    // First of all, make sure we even worked through the insts in the ROB on entry
-    if (instsPseudoretired[tid] < runaheadInfo.trackedROBInsts) {
-        DPRINTF(RunaheadCommit, "[tid:%i] Runahead did not clear the ROB, exiting ASAP.\n");
-        exitRunahead[tid] = true;
-        stats.runaheadExitCause[stats.REExitCause::EagerExit]++;
+    switch (decision) {
+      case ExitPolicy::Stay:
         return;
-    }
-
-    // Check if there's an unsent, valid load in the ROB within the minimum work limit of instructions
-    InstSeqNum loadSn = rob->findUnsentValidLoad(tid, minRunaheadWork);
-    if (!loadSn) {
-        DPRINTF(RunaheadCommit, "No nearby unsent loads in the ROB, exiting ASAP.\n");
-        exitRunahead[tid] = true;
+      case ExitPolicy::ExitEager:
         stats.runaheadExitCause[stats.REExitCause::EagerExit]++;
-        return;
+        lastExitCause[tid] = stats.REExitCause::EagerExit;
+        break;
+      case ExitPolicy::ExitMinWork:
+        stats.runaheadExitCause[stats.REExitCause::MinWorkDone]++;
+        lastExitCause[tid] = stats.REExitCause::MinWorkDone;
+        break;
+      case ExitPolicy::ExitDynamic:
+        stats.runaheadExitCause[stats.REExitCause::Dynamic]++;
+        lastExitCause[tid] = stats.REExitCause::Dynamic;
+        break;
     }
 
-    DPRINTF(RunaheadCommit, "[tid:%i] Checking that we have a runahead chain.\n", tid);
-    // Default to true so we delay even if we're not using filtered runahead
-    bool hasChain = cpu->usingFilteredRunahead() ? (cpu->runaheadChainSize() > 0) : true;
-    if (!hasChain) {
-        DPRINTF(RunaheadCommit, "[tid:%i] Not executing a chain, exiting ASAP.\n");
-        exitRunahead[tid] = true;
-        stats.runaheadExitCause[stats.REExitCause::EagerExit]++;
-    }
+    exitRunahead[tid] = true;
+}
+
+InstSeqNum
+Commit::squashTailSeqNum(ThreadID tid, InstSeqNum squashed_inst)
+{
+    InstSeqNum tail = rob->isEmpty(tid) ? squashed_inst : rob->readTailInst(tid)->seqNum;
+    // Precise runahead insts younger than the ROB tail must be squashed too
+    return std::max(tail, youngestOutsideROB[tid]);
 }
 
 void
@@ -753,7 +782,7 @@ Commit::squashAll(ThreadID tid)
 
     // Send back the sequence number of the squashed instruction.
     toIEW->commitInfo[tid].doneSeqNum = squashed_inst;
-    toIEW->commitInfo[tid].squashTail = rob->isEmpty(tid) ? squashed_inst : rob->readTailInst(tid)->seqNum;
+    toIEW->commitInfo[tid].squashTail = squashTailSeqNum(tid, squashed_inst);
 
     // Send back the squash signal to tell stages that they should
     // squash.
@@ -855,7 +884,7 @@ Commit::squashFromRunaheadExit(ThreadID tid)
 
     youngestSeqNum[tid] = squashedSeqNum;
     toIEW->commitInfo[tid].doneSeqNum = squashedSeqNum;
-    toIEW->commitInfo[tid].squashTail = rob->isEmpty(tid) ? squashedSeqNum : rob->readTailInst(tid)->seqNum;
+    toIEW->commitInfo[tid].squashTail = squashTailSeqNum(tid, squashedSeqNum);
 
     // Start squashing in the ROB
     commitStatus[tid] = ROBSquashing;
@@ -879,6 +908,58 @@ Commit::squashFromRunaheadExit(ThreadID tid)
     runaheadExitable[tid] = false;
 }
 
+void
+Commit::squashFromPreciseRunaheadExit(ThreadID tid)
+{
+    exitRunahead[tid] = false;
+    // start counting cycles to the next committed inst for stats
+    runaheadInfo.runaheadExitCycles = 0;
+    if (!iewStage->instQueue.empty(tid))
+        runaheadInfo.trackedIqSeqNum = iewStage->instQueue.getYoungestInst(tid)->seqNum;
+    else
+        runaheadInfo.trackedIqSeqNum = 0;
+
+    // The LLL is at the head of the ROB, so the ROB can not be empty
+    assert(!rob->isEmpty(tid));
+    const DynInstPtr &tail = rob->readTailInst(tid);
+    InstSeqNum squashedSeqNum = tail->seqNum;
+
+    // Fetch resumes after the ROB tail. A branch at the tail may have resolved as
+    // mispredicted during runahead, which only redirected runahead fetch, so use
+    // its resolved target like IEW::squashDueToBranch() once it executed.
+    std::unique_ptr<PCStateBase> resume_pc(tail->readPredTarg().clone());
+    if (tail->isExecuted()) {
+        set(resume_pc, tail->pcState());
+        tail->staticInst->advancePC(*resume_pc);
+    }
+
+    DPRINTF(RunaheadCommit, "[tid:%i] Performing precise runahead exit squash after "
+            "ROB tail [sn:%llu], resuming at PC %s\n",
+            tid, squashedSeqNum, *resume_pc);
+
+    // Squash every inst after the ROB. No architectural state to restore, the ROB was untouched
+    toIEW->commitInfo[tid].squash = true;
+    toIEW->commitInfo[tid].doneSeqNum = squashedSeqNum;
+    toIEW->commitInfo[tid].squashTail = squashTailSeqNum(tid, squashedSeqNum);
+    youngestSeqNum[tid] = squashedSeqNum;
+    youngestOutsideROB[tid] = 0;
+
+    // Nothing in the ROB is younger than its tail, but let it go through the motions
+    commitStatus[tid] = ROBSquashing;
+    rob->squash(squashedSeqNum, tid);
+    changedROBNumEntries[tid] = true;
+    toIEW->commitInfo[tid].robSquashing = true;
+
+    toIEW->commitInfo[tid].mispredictInst = NULL;
+    toIEW->commitInfo[tid].squashInst = tail;
+
+    set(toIEW->commitInfo[tid].pc, *resume_pc);
+
+    cpu->activityThisCycle();
+    cpu->exitRunahead(tid);
+    runaheadExitable[tid] = false;
+}
+
 void
 Commit::tick()
 {
@@ -988,7 +1069,7 @@ Commit::handleInterrupt()
 
     // Wait until all in flight instructions are finished before enterring
     // the interrupt. Runahead should not pose any hazards either.
-    if (canHandleInterrupts && !runaheadHazard && cpu->instList.empty()) {
+    if (canHandleInterrupts && !runaheadHazard && cpu->instWindow.empty()) {
         // Squash or record that I need to squash this cycle if
         // an interrupt needed to be handled.
         DPRINTF(Commit, "Interrupt detected.\n");
@@ -1022,7 +1103,7 @@ Commit::handleInterrupt()
         DPRINTF(Commit, "Interrupt pending: instruction is %sin "
                 "flight, ROB is %sempty. Runahead hazard: %s\n",
                 canHandleInterrupts ? "not " : "",
-                cpu->instList.empty() ? "" : "not ",
+                cpu->instWindow.empty() ? "" : "not ",
                 runaheadHazard ? "yes" : "no");
     }
 }
@@ -1100,7 +1181,10 @@ Commit::commit()
                 commitStatus[tid] = Running;
             }
         } else if (exitRunahead[tid]) {
-            squashFromRunaheadExit(tid);
+            if (cpu->usingPreciseRunahead())
+                squashFromPreciseRunaheadExit(tid);
+            else
+                squashFromRunaheadExit(tid);
         }
 
         // Squashed sequence number must be older than youngest valid
@@ -1151,7 +1235,7 @@ Commit::commit()
             changedROBNumEntries[tid] = true;
 
             toIEW->commitInfo[tid].doneSeqNum = squashed_inst;
-            toIEW->commitInfo[tid].squashTail = rob->isEmpty(tid) ? squashed_inst : rob->readTailInst(tid)->seqNum;
+            toIEW->commitInfo[tid].squashTail = squashTailSeqNum(tid, squashed_inst);
 
             toIEW->commitInfo[tid].squash = true;
 
@@ -1315,9 +1399,10 @@ Commit::commitInsts()
                     "[sn:%llu] (PC %s). Associated requests:\n",
                     tid, head_inst->seqNum, head_inst->pcState());
             
+            // Loads detected as LLLs while in flight already missed deep enough
             bool allPktsMissed = true;
             // Can't use the stored depth on the inst because it is only updated when pkts respond
-            for (int idx = 0; idx < lsqRequest->_reqs.size(); idx++) {
+            for (int idx = 0; !head_inst->isDetectedLLL() && idx < lsqRequest->_reqs.size(); idx++) {
                 RequestPtr request = lsqRequest->req(idx);
                 int depth = request->getAccessDepth();
 
@@ -1338,18 +1423,19 @@ Commit::commitInsts()
                     ++stats.normalLLLAtROBHead;
 
                 // If not already in runahead, try to enter it
-                // If in runahead, make sure the load isn't already poisoned (waiting to drain)
+                // If in runahead, make sure the load wasn't already handled (waiting to drain)
+                // In precise runahead, the LLL waits at the ROB head for its data
                 bool enteredRunahead = false;
                 if (!cpu->inRunahead(tid)) {
                     enteredRunahead = cpu->enterRunahead(tid);
-                } else if (!head_inst->isPoisoned()) {
+                } else if (!cpu->usingPreciseRunahead() && !head_inst->hasForgedResponse()) {
                     // If in runahead, immediately "complete" it to avoid blocking on it
                     assert(head_inst->isRunahead());
                     DPRINTF(RunaheadCommit,
                             "[tid:%i] Load was a runahead LLL. Attempting to forge response.\n", tid);
                     // Tell the CPU to deal with it. This is kinda ugly, LSQ should handle these
                     cpu->handleRunaheadLLL(head_inst);
-                    numLLLsThisPeriod++;
+                    numLLLsThisPeriod[tid]++;
                 }
 
                 if (enteredRunahead) {
@@ -1361,7 +1447,9 @@ Commit::commitInsts()
                     // Start tracking runahead entry overhead
                     runaheadInfo.runaheadEnterCycles = 0;
                     // And reset the counter for runahead LLLs
-                    numLLLsThisPeriod = 0;
+                    numLLLsThisPeriod[tid] = 0;
+                    // And let the exit policy start over
+                    exitPolicy->enteredRunahead(tid);
                 }
             }
 
@@ -1434,7 +1522,7 @@ Commit::commitInsts()
 
                 // Set the doneSeqNum to the youngest committed instruction.
                 toIEW->commitInfo[tid].doneSeqNum = head_inst->seqNum;
-                toIEW->commitInfo[tid].squashTail = rob->isEmpty(tid) ? head_inst->seqNum : rob->readTailInst(tid)->seqNum;
+                toIEW->commitInfo[tid].squashTail = squashTailSeqNum(tid, head_inst->seqNum);
 
                 if (tid == 0)
                     canHandleInterrupts = !head_inst->isDelayedCommit();
@@ -1673,6 +1761,7 @@ Commit::commitHead(const DynInstPtr &head_inst, unsigned inst_num)
                 runaheadCause[tid] = cpu->runaheadCause[tid];
                 exitRunahead[tid] = true;
                 stats.runaheadExitCause[stats.REExitCause::FetchPageFault]++;
+                lastExitCause[tid] = stats.REExitCause::FetchPageFault;
             }
         }
 
@@ -1724,6 +1813,10 @@ Commit::commitHead(const DynInstPtr &head_inst, unsigned inst_num)
         for (int i = 0; i < head_inst->numDestRegs(); i++)
             renameMap[tid]->setEntry(head_inst->flattenedDestIdx(i),
                                     head_inst->renamedDestIdx(i));
+
+        // Train the runahead value predictor on committed load values
+        if (head_inst->isLoad())
+            cpu->loadValuePredictor().train(head_inst);
     } else if (head_inst->isPoisoned()) {
         // Sanity check
         for (int i = 0; i < head_inst->numDestRegs(); i++)
@@ -1769,6 +1862,17 @@ Commit::getInsts()
         if (!inst->isSquashed() &&
             commitStatus[tid] != ROBSquashing &&
             commitStatus[tid] != TrapPending) {
+            // Precise runahead insts run outside of the ROB
+            if (inst->isRunahead() && cpu->usingPreciseRunahead()) {
+                DPRINTF(RunaheadCommit, "[tid:%i] [sn:%llu] Keeping precise runahead inst "
+                        "PC %s out of the ROB.\n",
+                        tid, inst->seqNum, inst->pcState());
+                ++stats.preciseRunaheadInsts;
+                youngestSeqNum[tid] = inst->seqNum;
+                youngestOutsideROB[tid] = inst->seqNum;
+                continue;
+            }
+
             changedROBNumEntries[tid] = true;
 
             DPRINTF(Commit, "[tid:%i] [sn:%llu] Inserting PC %s into ROB.\n",
@@ -1816,58 +1920,9 @@ Commit::updateRunaheadState(ThreadID tid)
     if (timeBuffer->getWire(-1)->archRestore[tid])
         cpu->restoreCheckpointState(tid);
 
-    // If waiting for minimum work to be completed, check if we're done
-    if (runaheadExitPolicy == REExitPolicy::MinimumWork &&
-        runaheadExitable[tid] && !exitRunahead[tid]) {
-        if (instsPseudoretired[tid] >= minRunaheadWork) {
-            DPRINTF(RunaheadCommit,
-                    "[tid:%i] Exiting runahead because minimum work has been done.\n",
-                    tid);
-            exitRunahead[tid] = true;
-            stats.runaheadExitCause[stats.REExitCause::MinWorkDone]++;
-        } else {
-            DPRINTF(RunaheadCommit,
-                    "[tid:%i] %llu/%llu insts pseudoretired towards runahead exit.\n",
-                    tid, instsPseudoretired[tid], minRunaheadWork);
-        }
-    }
-
-    // If doing a NLLB exit, check if the load has been executed
-    if (runaheadExitPolicy == REExitPolicy::NLLB &&
-        runaheadExitable[tid] && !exitRunahead[tid] &&
-        runaheadExitSeqNum) {
-        DynInstPtr loadInst = rob->findInst(tid, runaheadExitSeqNum);
-        // Could've been squashed or something
-        if (!loadInst) {
-            DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead because the exit-after load in the ROB disappeared.\n", tid);
-            exitRunahead[tid] = true;
-            stats.runaheadExitCause[stats.REExitCause::Dynamic]++;
-        } else if (loadInst->isExecuted()) {
-            DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead because the exit-after load was executed.\n", tid);
-            exitRunahead[tid] = true;
-            stats.runaheadExitCause[stats.REExitCause::Dynamic]++;
-        }
-
-        if (rob->countInsts(tid) > 0) {
-            // I don't think this should happen?
-            InstSeqNum oldestInst = rob->readHeadInst(tid)->seqNum;
-            if (oldestInst > runaheadExitSeqNum) {
-                DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead because the ROB head is too young.\n", tid);
-                exitRunahead[tid] = true;
-                stats.runaheadExitCause[stats.REExitCause::Dynamic]++;
-            }
-
-            if (!exitRunahead[tid]) {
-                InstSeqNum instsToExit = runaheadExitSeqNum - oldestInst;
-                DPRINTF(RunaheadCommit, "[tid:%i] Runahead will exit in %llu insts.\n", tid, instsToExit);
-            }
-        } else {
-            DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead because the ROB is empty", tid);
-            exitRunahead[tid] = true;
-            stats.runaheadExitCause[stats.REExitCause::Dynamic]++;
-        }
-    }
-
+    // Let the exit policy decide if a thread waiting to exit runahead should do so now
+    if (runaheadExitable[tid] && !exitRunahead[tid])
+        applyExitDecision(tid, exitPolicy->update(tid));
 
     // Check if we should stop counting runahead exit overhead cycles
     if (!runaheadInfo.trackedIqEmpty && runaheadInfo.runaheadExitCycles != -1) {
@@ -1901,6 +1956,9 @@ Commit::updateComInstStats(const DynInstPtr &inst)
 {
     ThreadID tid = inst->threadNumber;
 
+    if (inst->isRunahead())
+        cpu->resultReuseBuffer().pseudoretired(inst);
+
     if (!inst->isMicroop() || inst->isLastMicroop()) {
         stats.instsCommitted[tid]++;
         if (!cpu->inRunahead(tid))
@@ -1910,6 +1968,9 @@ Commit::updateComInstStats(const DynInstPtr &inst)
             stats.instsPseudoretired[tid]++;
             instsPseudoretired[tid]++;
 
+            if (runaheadExitable[tid] && !exitRunahead[tid])
+                applyExitDecision(tid, exitPolicy->pseudoretired(tid, inst));
+
             if (inst->isPoisoned())
                 ++stats.commitPoisonedInsts;
         }
@@ -1966,8 +2027,11 @@ Commit::updateComInstStats(const DynInstPtr &inst)
     if (inst->isRunahead()) {
         if (inst->isLoad()) {
             stats.loadsPseudoretired++;
-            if (!inst->isPoisoned())
+            loadsPseudoretired[tid]++;
+            if (!inst->isPoisoned()) {
                 stats.validLoadsPseudoretired++;
+                validLoadsPseudoretired[tid]++;
+            }
         }
 
         if (runaheadExitable[tid]) {
@@ -48,6 +48,7 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/runahead/comm.hh"
 #include "cpu/runahead/dyn_inst_ptr.hh"
+#include "cpu/runahead/exit_policy.hh"
 #include "cpu/runahead/iew.hh"
 #include "cpu/runahead/limits.hh"
 #include "cpu/runahead/rename_map.hh"
@@ -190,6 +191,16 @@ class Commit
     /** Has the stage drained? */
     bool isDrained() const;
 
+    /**
+     * Whether or not commit only counts stall stats until something wakes
+     * the CPU: the ROB head is not ready, and if it is a LLL, the CPU has
+     * settled on not running ahead of it.
+     */
+    bool isStalled();
+
+    /** Count the stats of cycles the CPU skipped while commit was stalled */
+    void countStalledCycles(Cycles cycles);
+
     /** Takes over from another CPU's thread. */
     void takeOverFrom();
 
@@ -224,8 +235,12 @@ class Commit
     /** Signal commit that the given thread should exit runahead as soon as possible */
     void signalExitRunahead(ThreadID tid, const DynInstPtr &inst);
 
+    /** Amount of insts that were in the ROB when runahead was last entered */
+    size_t robInstsOnEntry() const { return runaheadInfo.trackedROBInsts; }
+
   private:
-    void dynamicDelayedRunaheadExit(ThreadID tid);
+    /** Act on a decision made by the runahead exit policy */
+    void applyExitDecision(ThreadID tid, ExitPolicy::Decision decision);
 
     /** Updates the overall status of commit with the nextStatus, and
      * tell the CPU if commit is active/inactive.
@@ -253,6 +268,15 @@ class Commit
     /** Handles a squash from runahead exiting */
     void squashFromRunaheadExit(ThreadID tid);
 
+    /**
+     * Handles a squash from precise runahead exiting. Only the runahead insts beyond the ROB
+     * are squashed, and fetch resumes after the youngest ROB inst.
+     */
+    void squashFromPreciseRunaheadExit(ThreadID tid);
+
+    /** Youngest inst to squash in other stages when squashing after squashed_inst */
+    InstSeqNum squashTailSeqNum(ThreadID tid, InstSeqNum squashed_inst);
+
     /**
      * Handle squashing from instruction with SquashAfter set.
      *
@@ -364,6 +388,12 @@ class Commit
     /** The amount of valid (not poisoned) loads pseudoretired in the current runahead period */
     uint64_t validLoadsPseudoretired[MaxThreads] = { 0 }; 
 
+    /** Amount of new LLLs (L3 cache misses) in the current runahead period */
+    unsigned numLLLsThisPeriod[MaxThreads] = { 0 };
+
+    /** Cause of the last runahead exit, as a runaheadExitCause bucket */
+    uint8_t lastExitCause[MaxThreads] = { 0 };
+
     /** Instructions retired since last runahead exit and before earliest runahead entry */
     int instsBetweenRunahead[MaxThreads] = { 0 };
 
@@ -393,15 +423,8 @@ class Commit
     /** Records if a thread is able to safely exit runahead */
     bool runaheadExitable[MaxThreads] = { false };
 
-    /** Runahead exit policies */
-    enum REExitPolicy {
-        Eager,
-        MinimumWork,
-        NLLB, // No Load Left Behind
-        DynamicDelayed,
-    };
     /** The runahead exit policy being used */
-    REExitPolicy runaheadExitPolicy;
+    ExitPolicy *exitPolicy;
 
     /**
      * For all exit policies, the maximum number of cycles the CPU can
@@ -409,15 +432,6 @@ class Commit
      */
     Cycles runaheadExitDeadline;
 
-    /** For the MinimumWork and DynamicDelayed policy: minimum insts to pseduoretire before exiting runahead */
-    int minRunaheadWork = 0;
-
-    /** For the NLLB/DynamicDelayed policy: seqnum to exit runahead at */
-    InstSeqNum runaheadExitSeqNum = 0;
-
-    /** Amount of L3 cache misses this runahead period */
-    int numLLLsThisPeriod = 0;
-
     /** Records if a thread should exit runahead as soon as possible */
     bool exitRunahead[MaxThreads] = { false };
 
@@ -456,6 +470,17 @@ class Commit
     /** Update state and metrics related to runahead at the end of the cycle */
     void updateRunaheadState(ThreadID tid);
 
+    /** What commitInsts() counts every cycle the ROB head stays stalled, filled by isStalled() */
+    struct StallProfile
+    {
+        /** A load with a request is at the head */
+        bool loadAtHead = false;
+        /** That load is a LLL */
+        bool lllAtHead = false;
+        /** The reason the CPU refuses to enter runahead for it, -1 if not counted */
+        int refusedEntry = -1;
+    } stallProfile;
+
     /**
      * Instruction passed to squashAfter().
      *
@@ -518,6 +543,9 @@ class Commit
     /** The sequence number of the youngest valid instruction in the ROB. */
     InstSeqNum youngestSeqNum[MaxThreads];
 
+    /** The sequence number of the youngest precise runahead inst, which are not in the ROB */
+    InstSeqNum youngestOutsideROB[MaxThreads];
+
     /** The sequence number of the last commited instruction. */
     InstSeqNum lastCommitedSeqNum[MaxThreads];
 
@@ -637,6 +665,8 @@ class Commit
         statistics::Scalar runaheadDelayedInsts;
         /** Amount of loads retired in delayed runahead */
         statistics::Scalar runaheadDelayedLoads;
+        /** Amount of precise runahead insts kept out of the ROB */
+        statistics::Scalar preciseRunaheadInsts;
 
         /** Number of loads that caused a full ROB stall */
         statistics::Scalar fullROBLoads;
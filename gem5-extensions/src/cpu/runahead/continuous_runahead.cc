@@ -0,0 +1,358 @@
+#include "cpu/runahead/continuous_runahead.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "arch/generic/mmu.hh"
+#include "cpu/runahead/cpu.hh"
+#include "cpu/runahead/dyn_inst.hh"
+#include "debug/RunaheadContinuous.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+bool
+ContinuousRunaheadEngine::EnginePort::recvTimingResp(PacketPtr pkt)
+{
+    engine.recvTimingResp(pkt);
+    return true;
+}
+
+void
+ContinuousRunaheadEngine::EnginePort::recvReqRetry()
+{
+    engine.recvReqRetry();
+}
+
+ContinuousRunaheadEngine::ContinuousRunaheadEngine(const Params &p)
+    : ClockedObject(p),
+      port(name() + ".port", *this),
+      system(p.system),
+      requestorId(p.system->getRequestorId(this)),
+      chainCacheEntries(p.chainCacheEntries),
+      issueWidth(p.issueWidth),
+      maxDistance(p.maxDistance),
+      maxOutstanding(p.maxOutstanding),
+      trackedPrefetches(p.trackedPrefetches),
+      tickEvent([this]{ tick(); }, name() + ".tick"),
+      stats(this)
+{
+    fatal_if(chainCacheEntries == 0 || issueWidth == 0 || maxOutstanding == 0,
+             "The continuous runahead engine needs room for at least one chain, "
+             "one operation per cycle and one request in flight.\n");
+}
+
+Port &
+ContinuousRunaheadEngine::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "port")
+        return port;
+    return ClockedObject::getPort(if_name, idx);
+}
+
+void
+ContinuousRunaheadEngine::init()
+{
+    ClockedObject::init();
+
+    // Ports are only bound once all SimObjects are built
+    fatal_if(!port.isConnected(),
+             "The continuous runahead engine must be connected to the memory hierarchy.\n");
+    fatal_if(!cpu, "The continuous runahead engine is not attached to a core.\n");
+    blockSize = cpu->cacheLineSize();
+}
+
+void
+ContinuousRunaheadEngine::registerCore(CPU *_cpu)
+{
+    cpu = _cpu;
+}
+
+void
+ContinuousRunaheadEngine::chainGenerated(ThreadID tid, const DynInstPtr &lll)
+{
+    assert(cpu);
+    stats.chainsReceived++;
+
+    ChainPattern pattern;
+    if (!findChainPattern(cpu, tid, lll, pattern)) {
+        DPRINTF(RunaheadContinuous, "[tid:%i] No runnable pattern in chain of LLL PC %s.\n",
+                tid, lll->pcState());
+        stats.noPattern++;
+        return;
+    }
+
+    auto it = chains.find(pattern.pc);
+    if (it == chains.end()) {
+        if (chains.size() >= chainCacheEntries) {
+            auto victim = std::min_element(chains.begin(), chains.end(),
+                [](const auto &a, const auto &b) { return a.second.lastUse < b.second.lastUse; });
+            DPRINTF(RunaheadContinuous, "Evicting chain of LLL PC %#x.\n", victim->first);
+            chains.erase(victim);
+            stats.chainEvictions++;
+        }
+
+        DPRINTF(RunaheadContinuous, "[tid:%i] Caching chain of LLL PC %#x.\n", tid, pattern.pc);
+        it = chains.emplace(pattern.pc, ChainEntry{tid, ChainPattern(), 0, 0, 0, 0}).first;
+    }
+
+    // Resync to where the core is now, keeping the iterations already run ahead of it
+    ChainEntry &chain = it->second;
+    unsigned ahead = 0;
+    if (chain.pattern.valid && chain.pattern.indirect == pattern.indirect &&
+        chain.pattern.stride == pattern.stride) {
+        int64_t delta = chain.pattern.lastAddr + chain.iteration * chain.pattern.stride -
+                        pattern.lastAddr;
+        if (delta % pattern.stride == 0 && delta / pattern.stride > 0)
+            ahead = std::min<int64_t>(delta / pattern.stride, maxDistance);
+    }
+
+    chain.tid = tid;
+    chain.pattern = pattern;
+    chain.iteration = ahead;
+    chain.generation++;
+    chain.uses++;
+    chain.lastUse = curTick();
+
+    DPRINTF(RunaheadContinuous, "[tid:%i] Chain of LLL PC %#x resynced, %i iterations ahead.\n",
+            tid, pattern.pc, ahead);
+
+    scheduleTick();
+}
+
+ContinuousRunaheadEngine::ChainEntry *
+ContinuousRunaheadEngine::hottestChain()
+{
+    ChainEntry *hottest = nullptr;
+    for (auto &it : chains) {
+        ChainEntry &chain = it.second;
+        if (chain.iteration >= maxDistance)
+            continue;
+        if (!hottest || chain.uses > hottest->uses ||
+            (chain.uses == hottest->uses && chain.lastUse > hottest->lastUse))
+            hottest = &chain;
+    }
+    return hottest;
+}
+
+bool
+ContinuousRunaheadEngine::hasWork() const
+{
+    if (retryPkt || outstanding >= maxOutstanding || drainState() == DrainState::Draining)
+        return false;
+    if (!pendingPrefetches.empty())
+        return true;
+
+    for (const auto &it : chains) {
+        if (it.second.iteration < maxDistance)
+            return true;
+    }
+    return false;
+}
+
+void
+ContinuousRunaheadEngine::scheduleTick()
+{
+    if (!tickEvent.scheduled() && hasWork())
+        schedule(tickEvent, clockEdge(Cycles(1)));
+}
+
+void
+ContinuousRunaheadEngine::tick()
+{
+    for (unsigned op = 0; op < issueWidth; op++) {
+        if (retryPkt || outstanding >= maxOutstanding || drainState() == DrainState::Draining)
+            break;
+
+        // Addresses computed from returned indices are the oldest operations, so they go first
+        if (!pendingPrefetches.empty()) {
+            PendingPrefetch prefetch = pendingPrefetches.front();
+            pendingPrefetches.pop_front();
+
+            auto it = chains.find(prefetch.chainPC);
+            if (it != chains.end())
+                sendRequest(it->second, prefetch.vaddr, it->second.pattern.lllSize, false);
+            continue;
+        }
+
+        ChainEntry *chain = hottestChain();
+        if (!chain)
+            break;
+
+        const ChainPattern &pat = chain->pattern;
+        chain->iteration++;
+        stats.chainsExecuted++;
+        sendRequest(*chain, pat.lastAddr + chain->iteration * pat.stride, pat.size, pat.indirect);
+    }
+
+    scheduleTick();
+}
+
+bool
+ContinuousRunaheadEngine::sendRequest(const ChainEntry &chain, Addr vaddr, unsigned size,
+                                      bool gather)
+{
+    if ((vaddr % blockSize) + size > blockSize) {
+        stats.droppedRequests++;
+        return false;
+    }
+
+    // Indices are needed to compute the LLL address, the LLL address itself is only prefetched
+    Request::Flags flags = gather ? Request::Flags(0) : Request::Flags(Request::PREFETCH);
+    ThreadContext *tc = cpu->tcBase(chain.tid);
+    RequestPtr req = std::make_shared<Request>(vaddr, size, flags, requestorId,
+                                               chain.pattern.pc, tc->contextId());
+
+    // The engine uses the core's page table instead of a TLB of its own
+    Fault fault = cpu->mmu->translateFunctional(req, tc, BaseMMU::Read);
+    if (fault != NoFault || req->isUncacheable()) {
+        DPRINTF(RunaheadContinuous, "Dropping request to %#x, translation failed.\n", vaddr);
+        stats.droppedRequests++;
+        return false;
+    }
+
+    PacketPtr pkt = Packet::createRead(req);
+    pkt->allocate();
+    pkt->senderState = new EngineState(chain.pattern.pc, chain.generation, gather, size);
+
+    DPRINTF(RunaheadContinuous, "Chain of LLL PC %#x: %s %#x (paddr %#x).\n",
+            chain.pattern.pc, gather ? "loading index at" : "prefetching", vaddr,
+            req->getPaddr());
+
+    outstanding++;
+    if (gather) {
+        stats.indexLoads++;
+    } else {
+        stats.prefetchesIssued++;
+        trackPrefetch(pkt->getAddr());
+    }
+
+    if (!port.sendTimingReq(pkt))
+        retryPkt = pkt;
+    return true;
+}
+
+void
+ContinuousRunaheadEngine::recvTimingResp(PacketPtr pkt)
+{
+    EngineState *state = dynamic_cast<EngineState *>(pkt->senderState);
+    assert(state && outstanding > 0);
+    outstanding--;
+
+    // A returned index of a chain that was not resynced meanwhile gives the LLL address
+    auto it = chains.find(state->chainPC);
+    if (state->gather && !pkt->isError() && it != chains.end() &&
+        it->second.generation == state->generation) {
+        const ChainPattern &pat = it->second.pattern;
+        uint64_t value = 0;
+        std::memcpy(&value, pkt->getConstPtr<uint8_t>(), state->size);
+        pendingPrefetches.push_back({state->chainPC, pat.base + pat.scale * value});
+    }
+
+    delete state;
+    delete pkt;
+
+    if (drainState() == DrainState::Draining && outstanding == 0) {
+        signalDrainDone();
+        return;
+    }
+    scheduleTick();
+}
+
+void
+ContinuousRunaheadEngine::recvReqRetry()
+{
+    assert(retryPkt);
+    if (port.sendTimingReq(retryPkt)) {
+        retryPkt = nullptr;
+        scheduleTick();
+    }
+}
+
+void
+ContinuousRunaheadEngine::trackPrefetch(Addr paddr)
+{
+    Addr blkAddr = blockAlign(paddr);
+    if (prefetchedMap.find(blkAddr) != prefetchedMap.end())
+        return;
+
+    if (prefetchedBlocks.size() >= trackedPrefetches && !prefetchedBlocks.empty()) {
+        prefetchedMap.erase(prefetchedBlocks.front());
+        prefetchedBlocks.pop_front();
+    }
+
+    prefetchedBlocks.push_back(blkAddr);
+    prefetchedMap[blkAddr] = std::prev(prefetchedBlocks.end());
+}
+
+bool
+ContinuousRunaheadEngine::demandAccess(Addr paddr)
+{
+    auto it = prefetchedMap.find(blockAlign(paddr));
+    if (it == prefetchedMap.end())
+        return false;
+
+    prefetchedBlocks.erase(it->second);
+    prefetchedMap.erase(it);
+    stats.usefulPrefetches++;
+    return true;
+}
+
+void
+ContinuousRunaheadEngine::demandFilled(int depth)
+{
+    if (depth >= cpu->lllDepthThreshold)
+        stats.uncoveredMisses++;
+}
+
+DrainState
+ContinuousRunaheadEngine::drain()
+{
+    // Operations not yet executed are only prefetches, so they can be dropped
+    pendingPrefetches.clear();
+    return outstanding == 0 ? DrainState::Drained : DrainState::Draining;
+}
+
+void
+ContinuousRunaheadEngine::drainResume()
+{
+    scheduleTick();
+}
+
+ContinuousRunaheadEngine::EngineStats::EngineStats(ContinuousRunaheadEngine *engine)
+    : statistics::Group(engine),
+      ADD_STAT(chainsReceived, statistics::units::Count::get(),
+           "Number of dependence chains handed over by the core"),
+      ADD_STAT(noPattern, statistics::units::Count::get(),
+           "Number of chains without an address pattern the engine can run"),
+      ADD_STAT(chainEvictions, statistics::units::Count::get(),
+           "Number of chains evicted from the chain cache"),
+      ADD_STAT(chainsExecuted, statistics::units::Count::get(),
+           "Number of chain iterations executed by the engine"),
+      ADD_STAT(indexLoads, statistics::units::Count::get(),
+           "Number of index loads sent for indirect chains"),
+      ADD_STAT(prefetchesIssued, statistics::units::Count::get(),
+           "Number of prefetches sent to the LLC"),
+      ADD_STAT(droppedRequests, statistics::units::Count::get(),
+           "Number of requests dropped due to failed translation or crossing a line"),
+      ADD_STAT(usefulPrefetches, statistics::units::Count::get(),
+           "Number of engine prefetches demanded by the core"),
+      ADD_STAT(uncoveredMisses, statistics::units::Count::get(),
+           "Number of long latency demand loads not prefetched by the engine"),
+      ADD_STAT(accuracy, statistics::units::Ratio::get(),
+           "Fraction of engine prefetches demanded by the core",
+           usefulPrefetches / prefetchesIssued),
+      ADD_STAT(coverage, statistics::units::Ratio::get(),
+           "Fraction of long latency demand loads prefetched by the engine",
+           usefulPrefetches / (usefulPrefetches + uncoveredMisses))
+{
+    accuracy.precision(6);
+    coverage.precision(6);
+}
+
+} // namespace runahead
+} // namespace gem5
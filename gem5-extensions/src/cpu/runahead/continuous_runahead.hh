@@ -0,0 +1,215 @@
+#ifndef __CPU_RUNAHEAD_CONTINUOUS_RUNAHEAD_HH__
+#define __CPU_RUNAHEAD_CONTINUOUS_RUNAHEAD_HH__
+
+#include <deque>
+#include <list>
+#include <unordered_map>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/runahead/chain_pattern.hh"
+#include "cpu/runahead/dyn_inst_ptr.hh"
+#include "mem/packet.hh"
+#include "mem/port.hh"
+#include "params/ContinuousRunaheadEngine.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+class System;
+
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * Continuous runahead engine. Keeps running the hottest dependence chains of the core on
+ * a small in-order datapath on the memory side, whether or not the core is stalled, and
+ * prefetches the addresses they generate into the LLC.
+ *
+ * The core hands the engine a chain every time it generates one on runahead entry. The
+ * engine keeps a small cache of chains, each reduced to the address pattern of its LLL
+ * (see ChainPattern). Executing a chain iteration advances its strided load by one stride.
+ * Direct chains then prefetch the LLL address. Indirect chains load the index first, and
+ * prefetch the LLL address computed from it once the index returns.
+ *
+ * A chain is run at most maxDistance iterations ahead of where the core last was. Every time
+ * the core hands over the chain again, the engine resyncs to the core's position.
+ */
+class ContinuousRunaheadEngine : public ClockedObject
+{
+  private:
+    class EnginePort : public RequestPort
+    {
+      private:
+        ContinuousRunaheadEngine &engine;
+
+      public:
+        EnginePort(const std::string &_name, ContinuousRunaheadEngine &_engine)
+            : RequestPort(_name, &_engine), engine(_engine)
+        {}
+
+      protected:
+        bool recvTimingResp(PacketPtr pkt) override;
+        void recvReqRetry() override;
+    };
+
+    struct ChainEntry
+    {
+        ThreadID tid;
+        ChainPattern pattern;
+        /** Iterations executed past the core's last known position */
+        unsigned iteration;
+        /** Bumped on every resync, so stale index loads are ignored */
+        uint64_t generation;
+        /** Times the core handed over this chain, to pick the hottest chain */
+        uint64_t uses;
+        /** Tick of the last handover, for replacement */
+        Tick lastUse;
+    };
+
+    /** Sender state of engine packets */
+    struct EngineState : public Packet::SenderState
+    {
+        /** PC of the LLL of the chain the request belongs to */
+        Addr chainPC;
+        uint64_t generation;
+        /** Whether the request loads an index rather than prefetching the LLL address */
+        bool gather;
+        unsigned size;
+
+        EngineState(Addr _chainPC, uint64_t _generation, bool _gather, unsigned _size)
+            : chainPC(_chainPC), generation(_generation), gather(_gather), size(_size)
+        {}
+    };
+
+    /** A LLL address computed from a returned index, waiting to be prefetched */
+    struct PendingPrefetch
+    {
+        Addr chainPC;
+        Addr vaddr;
+    };
+
+    EnginePort port;
+
+    /** System, to get a requestor id */
+    System *system;
+
+    /** The core the engine runs chains for */
+    CPU *cpu = nullptr;
+
+    /** Requestor id of the engine's requests */
+    RequestorID requestorId;
+
+    const unsigned chainCacheEntries;
+    const unsigned issueWidth;
+    const unsigned maxDistance;
+    const unsigned maxOutstanding;
+    const unsigned trackedPrefetches;
+
+    /** Chain cache, by LLL PC */
+    std::unordered_map<Addr, ChainEntry> chains;
+
+    /** LLL addresses computed from returned indices, in the order they returned */
+    std::deque<PendingPrefetch> pendingPrefetches;
+
+    /** Requests sent and not yet responded to */
+    unsigned outstanding = 0;
+
+    /** Packet the LLC refused, to resend on retry */
+    PacketPtr retryPkt = nullptr;
+
+    /** Blocks prefetched by the engine and not yet demanded, oldest first */
+    std::list<Addr> prefetchedBlocks;
+    std::unordered_map<Addr, std::list<Addr>::iterator> prefetchedMap;
+
+    EventFunctionWrapper tickEvent;
+
+    void tick();
+
+    /** Schedule the engine to tick next cycle if it has work to do */
+    void scheduleTick();
+
+    /** Whether or not there is an operation the engine can execute */
+    bool hasWork() const;
+
+    /** The hottest chain that has not run far enough ahead yet */
+    ChainEntry *hottestChain();
+
+    /** Translate and send a request. Returns false if the operation could not execute */
+    bool sendRequest(const ChainEntry &chain, Addr vaddr, unsigned size, bool gather);
+
+    /** Remember a prefetched block to measure coverage */
+    void trackPrefetch(Addr paddr);
+
+    /** Cache line size of the core */
+    unsigned blockSize = 0;
+
+    Addr blockAlign(Addr addr) const { return addr & ~((Addr)blockSize - 1); }
+
+    void recvTimingResp(PacketPtr pkt);
+    void recvReqRetry();
+
+  public:
+    PARAMS(ContinuousRunaheadEngine);
+    ContinuousRunaheadEngine(const Params &p);
+
+    Port &getPort(const std::string &if_name, PortID idx=InvalidPortID) override;
+
+    void init() override;
+
+    DrainState drain() override;
+    void drainResume() override;
+
+    /** Attach the engine to the core it runs chains for. Called before ports are bound */
+    void registerCore(CPU *_cpu);
+
+    /** The core generated a chain for the given LLL. Cache it, or resync it if cached */
+    void chainGenerated(ThreadID tid, const DynInstPtr &lll);
+
+    /**
+     * A normal mode load of the core accessed the given physical address.
+     * Returns true if the block was prefetched by the engine.
+     */
+    bool demandAccess(Addr paddr);
+
+    /** A normal mode load not covered by the engine was serviced at the given depth */
+    void demandFilled(int depth);
+
+  private:
+    struct EngineStats : public statistics::Group
+    {
+        EngineStats(ContinuousRunaheadEngine *engine);
+
+        /** Chains handed over by the core */
+        statistics::Scalar chainsReceived;
+        /** Chains without an address pattern the engine can run */
+        statistics::Scalar noPattern;
+        /** Chains evicted from the chain cache */
+        statistics::Scalar chainEvictions;
+        /** Chain iterations executed */
+        statistics::Scalar chainsExecuted;
+        /** Index loads sent for indirect chains */
+        statistics::Scalar indexLoads;
+        /** Prefetches sent to the LLC */
+        statistics::Scalar prefetchesIssued;
+        /** Requests dropped because they could not be translated or crossed a line */
+        statistics::Scalar droppedRequests;
+        /** Prefetched blocks demanded by the core */
+        statistics::Scalar usefulPrefetches;
+        /** Long latency demand loads of the core not prefetched by the engine */
+        statistics::Scalar uncoveredMisses;
+        /** Fraction of prefetches demanded by the core */
+        statistics::Formula accuracy;
+        /** Fraction of long latency demand loads prefetched by the engine */
+        statistics::Formula coverage;
+    } stats;
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_CONTINUOUS_RUNAHEAD_HH__
@@ -41,6 +41,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 
 #include "cpu/runahead/cpu.hh"
 
@@ -48,6 +49,7 @@
 #include "cpu/activity.hh"
 #include "cpu/checker/cpu.hh"
 #include "cpu/checker/thread_context.hh"
+#include "cpu/runahead/continuous_runahead.hh"
 #include "cpu/runahead/dyn_inst.hh"
 #include "cpu/runahead/limits.hh"
 #include "cpu/runahead/thread_context.hh"
@@ -56,6 +58,7 @@
 #include "debug/Activity.hh"
 #include "debug/Drain.hh"
 #include "debug/RunaheadCPU.hh"
+#include "debug/RunaheadPoison.hh"
 #include "debug/RunaheadCheckpoint.hh"
 #include "debug/O3CPU.hh"
 #include "debug/Quiesce.hh"
@@ -63,6 +66,7 @@
 #include "sim/cur_tick.hh"
 #include "sim/full_system.hh"
 #include "sim/process.hh"
+#include "sim/sim_exit.hh"
 #include "sim/stat_control.hh"
 #include "sim/system.hh"
 
@@ -77,20 +81,33 @@ namespace runahead
 CPU::CPU(const BaseRunaheadCPUParams &params)
     : BaseCPU(params),
       mmu(params.mmu),
+      dynInstAllocator(this, params),
       tickEvent([this]{ tick(); }, "RunaheadCPU tick",
                 false, Event::CPU_Tick_Pri),
       threadExitEvent([this]{ exitThreads(); }, "RunaheadCPU exit threads",
                 false, Event::CPU_Exit_Pri),
+      commitWatchdogEvent([this]{ checkCommitProgress(); }, "RunaheadCPU commit watchdog",
+                false, Event::CPU_Tick_Pri),
+      commitWatchdogCycles(params.commitWatchdogCycles),
+      commitWatchdogExit(params.commitWatchdogExit),
+      skipStalledCycles(params.skipStalledCycles != "Off"),
+      checkStalledCycles(params.skipStalledCycles == "Check"),
+      stallSettleTicks(params.backComSize + params.forwardComSize + 1),
       runaheadEnabled(params.enableRunahead),
       filteredRunahead(params.filteredRunahead),
+      hashedChainFilter(params.runaheadChainFilter),
+      preciseRunahead(params.preciseRunahead),
+      earlyLLLDetection(params.enableRunahead && params.earlyLLLDetection),
       runaheadInFlightThreshold(params.runaheadInFlightThreshold),
       allowOverlappingRunahead(params.allowOverlappingRunahead),
+      smtDeprioritizeRunahead(params.smtRunaheadPolicy == "Deprioritize"),
       lllDepthThreshold(params.lllDepthThreshold),
       runaheadEagerEntry(params.runaheadEagerEntry),
 #ifndef NDEBUG
       instcount(0),
 #endif
-      removeInstsThisCycle(false),
+      // Room for the ROB and the instructions in the front end, grown if needed
+      instWindow(params.numROBEntries * 2),
       fetch(this, params),
       decode(this, params),
       rename(this, params),
@@ -109,7 +126,18 @@ CPU::CPU(const BaseRunaheadCPUParams &params)
       rob(this, params),
 
       // TODO? revisit RE cache block size (parametrize)
-      runaheadCache(name() + ".rcache", this, params.runaheadCacheSize, 64),
+      runaheadCache(name() + ".rcache", this, params.runaheadCacheSize, 64,
+                    params.runaheadCacheAssoc, params.runaheadCacheReplPolicy,
+                    params.runaheadCacheLatency),
+
+      runaheadBuffer(this, params),
+
+      prefetchTracker(this, params),
+      entryPredictor(this, params),
+      valuePredictor(this, params),
+      vectorRunahead(this, params),
+      reuseBuffer(this, params),
+      periodTrace(this, params),
 
       scoreboard(name() + ".scoreboard", regFile.totalNumPhysRegs()),
 
@@ -134,10 +162,26 @@ CPU::CPU(const BaseRunaheadCPUParams &params)
     fatal_if(FullSystem && params.numThreads > 1,
             "SMT is not supported in Runahead in full system mode currently.");
 
+    fatal_if(params.smtRunaheadPolicy != "None" && params.smtRunaheadPolicy != "Deprioritize",
+            "Invalid SMT runahead policy '%s'. Must be one of: None, Deprioritize.",
+            params.smtRunaheadPolicy);
+
+    fatal_if(params.skipStalledCycles != "Off" && params.skipStalledCycles != "Skip" &&
+             params.skipStalledCycles != "Check",
+            "Invalid stalled cycle skipping '%s'. Must be one of: Off, Skip, Check.",
+            params.skipStalledCycles);
+
     fatal_if(!FullSystem && params.numThreads < params.workload.size(),
             "More workload items (%d) than threads (%d) on CPU %s.",
             params.workload.size(), params.numThreads, name());
 
+    if (params.continuousRunaheadEngine) {
+        fatal_if(!runaheadEnabled || !filteredRunahead,
+                 "The continuous runahead engine needs the chains of filtered runahead.\n");
+        continuousEngine = params.continuousRunaheadEngine;
+        continuousEngine->registerCore(this);
+    }
+
     if (!params.switched_out) {
         _status = Running;
     } else {
@@ -187,6 +231,8 @@ CPU::CPU(const BaseRunaheadCPUParams &params)
     iew.setIEWQueue(&iewQueue);
     commit.setIEWQueue(&iewQueue);
     commit.setRenameQueue(&renameQueue);
+    runaheadBuffer.setDecodeQueue(&decodeQueue);
+    runaheadBuffer.setDecodeStage(&decode);
 
     commit.setIEWStage(&iew);
     rename.setIEWStage(&iew);
@@ -357,6 +403,11 @@ CPU::CPUStats::CPUStats(CPU *cpu)
       ADD_STAT(quiesceCycles, statistics::units::Cycle::get(),
                "Total number of cycles that CPU has spent quiesced or waiting "
                "for an interrupt"),
+      ADD_STAT(skippedCycles, statistics::units::Cycle::get(),
+               "Total number of cycles skipped while no stage could make "
+               "progress"),
+      ADD_STAT(stallSkips, statistics::units::Count::get(),
+               "Number of times that the CPU stopped ticking to skip a stall"),
       ADD_STAT(committedInsts, statistics::units::Count::get(),
                "Number of Instructions Simulated"),
       ADD_STAT(pseudoRetiredInsts, statistics::units::Count::get(),
@@ -413,6 +464,10 @@ CPU::CPUStats::CPUStats(CPU *cpu)
                "number of misc regfile writes"),
       ADD_STAT(runaheadPeriods, statistics::units::Count::get(),
                "Amount of times runahead was entered"),
+      ADD_STAT(threadRunaheadPeriods, statistics::units::Count::get(),
+               "Amount of times each thread entered runahead"),
+      ADD_STAT(threadRunaheadCycles, statistics::units::Cycle::get(),
+               "Amount of cycles each thread spent in runahead"),
       ADD_STAT(runaheadCycleDist, statistics::units::Cycle::get(),
                "Distribution of amount of cycles spent in runahead mode"),
       ADD_STAT(refusedRunaheadEntries, statistics::units::Count::get(),
@@ -427,6 +482,14 @@ CPU::CPUStats::CPUStats(CPU *cpu)
                "Amount of cycles a load has been in-flight when it triggered runahead"),
       ADD_STAT(dependenceChainLength, statistics::units::Count::get(),
                "Amount of instructions in runahead dependence chains"),
+      ADD_STAT(earlyLLLs, statistics::units::Count::get(),
+               "Amount of LLLs detected before reaching the ROB head"),
+      ADD_STAT(earlyChainsGenerated, statistics::units::Count::get(),
+               "Amount of dependence chains generated before the LLL reached the ROB head"),
+      ADD_STAT(earlyChainsUsed, statistics::units::Count::get(),
+               "Amount of runahead periods that used a dependence chain generated early"),
+      ADD_STAT(earlyLLLLeadCycles, statistics::units::Cycle::get(),
+               "Amount of cycles between detecting a LLL and it triggering runahead"),
       ADD_STAT(intRegPoisoned, statistics::units::Count::get(),
                "Amount of times an integer register was marked as poisoned"),
       ADD_STAT(intRegCured, statistics::units::Count::get(),
@@ -450,7 +513,9 @@ CPU::CPUStats::CPUStats(CPU *cpu)
       ADD_STAT(miscRegPoisoned, statistics::units::Count::get(),
                "Amount of times a misc register was marked as poisoned"),
       ADD_STAT(miscRegCured, statistics::units::Count::get(),
-               "Amount of times a misc register's poison was reset in runahead")
+               "Amount of times a misc register's poison was reset in runahead"),
+      ADD_STAT(poisonedRegsAtExit, statistics::units::Count::get(),
+               "Amount of poisoned physical registers when exiting runahead")
 {
     // Register any of the RunaheadCPU's stats here.
     runaheadCycles.prereq(runaheadCycles);
@@ -467,6 +532,12 @@ CPU::CPUStats::CPUStats(CPU *cpu)
     quiesceCycles
         .prereq(quiesceCycles);
 
+    skippedCycles
+        .prereq(skippedCycles);
+
+    stallSkips
+        .prereq(stallSkips);
+
     // Number of Instructions simulated
     // --------------------------------
     // Should probably be in Base CPU but need templated
@@ -548,12 +619,20 @@ CPU::CPUStats::CPUStats(CPU *cpu)
     runaheadPeriods
         .prereq(runaheadPeriods);
 
+    threadRunaheadPeriods
+        .init(cpu->numThreads)
+        .flags(statistics::total);
+
+    threadRunaheadCycles
+        .init(cpu->numThreads)
+        .flags(statistics::total);
+
     runaheadCycleDist
         .init(0, 1000, 50)
         .flags(statistics::total);
 
     refusedRunaheadEntries
-        .init(OverlappingPeriod + 1)
+        .init(EntryPredicted + 1)
         .flags(statistics::total);
 
     instsPseudoRetiredPerPeriod
@@ -576,6 +655,10 @@ CPU::CPUStats::CPUStats(CPU *cpu)
         .init(1, 64, 8)
         .flags(statistics::total);
 
+    earlyLLLLeadCycles
+        .init(8)
+        .flags(statistics::total);
+
     intRegPoisoned
         .prereq(intRegPoisoned);
     
@@ -611,6 +694,26 @@ CPU::CPUStats::CPUStats(CPU *cpu)
     
     miscRegCured
         .prereq(miscRegCured);
+
+    regPoisonedByClass[IntRegClass] = &intRegPoisoned;
+    regPoisonedByClass[FloatRegClass] = &floatRegPoisoned;
+    regPoisonedByClass[VecRegClass] = &vecRegPoisoned;
+    regPoisonedByClass[VecElemClass] = &vecRegPoisoned;
+    regPoisonedByClass[VecPredRegClass] = &vecPredRegPoisoned;
+    regPoisonedByClass[CCRegClass] = &ccRegPoisoned;
+    regPoisonedByClass[MiscRegClass] = &miscRegPoisoned;
+
+    regCuredByClass[IntRegClass] = &intRegCured;
+    regCuredByClass[FloatRegClass] = &floatRegCured;
+    regCuredByClass[VecRegClass] = &vecRegCured;
+    regCuredByClass[VecElemClass] = &vecRegCured;
+    regCuredByClass[VecPredRegClass] = &vecPredRegCured;
+    regCuredByClass[CCRegClass] = &ccRegCured;
+    regCuredByClass[MiscRegClass] = &miscRegCured;
+
+    poisonedRegsAtExit
+        .init(0, 256, 16)
+        .flags(statistics::total);
 }
 
 void
@@ -622,6 +725,10 @@ CPU::tick()
     assert(!switchedOut());
     assert(drainState() != DrainState::Drained);
 
+    // Only a check skips a cycle without descheduling the tick
+    if (skippingStall)
+        beginStallCheck();
+
     ++baseStats.numCycles;
     if (rob.numFreeEntries(0) == 0) {
         ++cpuStats.numROBFullCycles;
@@ -629,11 +736,14 @@ CPU::tick()
             cpuStats.numRealROBFullCycles++;
     }
 
-    // todo: per thread
     if (inRunahead(0))
         ++cpuStats.runaheadCycles;
     else
         ++cpuStats.realCycles;
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        if (inRunahead(tid))
+            ++cpuStats.threadRunaheadCycles[tid];
+    }
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
     
 //    activity = false;
@@ -643,10 +753,16 @@ CPU::tick()
 
     decode.tick();
 
+    // Supplies rename in place of fetch/decode in runahead, if active
+    runaheadBuffer.tick();
+
     rename.tick();
 
     iew.tick();
 
+    // Lanes use the load ports left over by the LSQ this cycle
+    vectorRunahead.tick();
+
     commit.tick();
 
     // Now advance the time buffers
@@ -659,10 +775,16 @@ CPU::tick()
 
     activityRec.advance();
 
-    if (removeInstsThisCycle) {
+    if (instWindow.hasRemovals()) {
         cleanUpRemovedInsts();
     }
 
+    if (skipStalledCycles)
+        stalledTicks = allStagesStalled() ? stalledTicks + 1 : 0;
+
+    if (stallCheck)
+        endStallCheck();
+
     if (!tickEvent.scheduled()) {
         if (_status == SwitchedOut) {
             DPRINTF(O3CPU, "Switched out!\n");
@@ -672,6 +794,15 @@ CPU::tick()
             DPRINTF(Activity, "Idle!\n");
             lastRunningCycle = curCycle();
             cpuStats.timesIdled++;
+        } else if (stalledTicks > stallSettleTicks) {
+            DPRINTF(Activity, "All stages stalled, skipping cycles until woken.\n");
+            lastRunningCycle = curCycle();
+            stallCountedCycle = lastRunningCycle;
+            skippingStall = true;
+            cpuStats.stallSkips++;
+            // Skip a single cycle, and check it against ticking the next one
+            if (checkStalledCycles)
+                schedule(tickEvent, clockEdge(Cycles(2)));
         } else {
             DPRINTF(O3CPU, "Scheduling next tick!\n");
             schedule(tickEvent, clockEdge(Cycles(1)));
@@ -715,6 +846,251 @@ CPU::startup()
     iew.startupStage();
     rename.startupStage();
     commit.startupStage();
+
+    if (!switchedOut())
+        startCommitWatchdog();
+}
+
+void
+CPU::startCommitWatchdog()
+{
+    if (commitWatchdogCycles == 0 || commitWatchdogEvent.scheduled())
+        return;
+
+    watchdogInsts = totalInsts();
+    schedule(commitWatchdogEvent, clockEdge(commitWatchdogCycles));
+}
+
+void
+CPU::checkCommitProgress()
+{
+    // Stop watching once switched out, the CPU taking over watches itself
+    if (switchedOut())
+        return;
+
+    // An idle CPU has nothing to commit, e.g. when the guest halts
+    Counter insts = totalInsts();
+    if (insts == watchdogInsts && _status == Running) {
+        warn("%s: No instruction committed in %llu cycles.\n", name(), commitWatchdogCycles);
+        dumpCommitState();
+
+        if (commitWatchdogExit)
+            exitSimLoop("runahead CPU commit watchdog fired", 1);
+    }
+
+    watchdogInsts = insts;
+    schedule(commitWatchdogEvent, clockEdge(commitWatchdogCycles));
+}
+
+void
+CPU::dumpCommitState()
+{
+    for (ThreadID tid : activeThreads) {
+        warn("[tid:%i] %s. ROB: %i insts, IQ: %i insts, LQ: %i loads, SQ: %i stores.\n",
+             tid, inRunahead(tid) ? "In runahead" : "In normal mode",
+             rob.getThreadEntries(tid), iew.instQueue.getCount(tid),
+             iew.ldstQueue.numLoads(tid), iew.ldstQueue.numStores(tid));
+
+        if (rob.isEmpty(tid))
+            continue;
+
+        const DynInstPtr &head = rob.readHeadInst(tid);
+        warn("[tid:%i] ROB head [sn:%llu] PC %s (%s): issued %i, executed %i, can commit %i, "
+             "runahead %i, poisoned %i.\n",
+             tid, head->seqNum, head->pcState(), head->staticInst->disassemble(
+                 head->pcState().instAddr()),
+             head->isIssued(), head->isExecuted(), head->readyToCommit(),
+             head->isRunahead(), head->isPoisoned());
+    }
+}
+
+bool
+CPU::allStagesStalled()
+{
+    // Only a single thread in normal mode, with nothing left for runahead to issue
+    if (numThreads != 1 || activeThreads.size() != 1 || _status != Running ||
+        drainState() != DrainState::Running || inRunahead(0) ||
+        runaheadBufferActive(0) || vectorRunahead.hasPendingLanes() ||
+        instWindow.hasRemovals())
+        return false;
+
+    // Commit goes last, it records what it counts every stalled cycle
+    return fetch.isStalled() && decode.isStalled() && rename.isStalled() &&
+           iew.isStalled() && commit.isStalled();
+}
+
+void
+CPU::countSkippedCycles(Cycles last)
+{
+    if (last <= stallCountedCycle)
+        return;
+
+    Cycles cycles(last - stallCountedCycle);
+    stallCountedCycle = last;
+
+    // What tick() counts, the CPU stays in normal mode and the ROB does not change
+    baseStats.numCycles += cycles;
+    cpuStats.realCycles += cycles;
+    if (rob.numFreeEntries(0) == 0) {
+        cpuStats.numROBFullCycles += cycles;
+        cpuStats.numRealROBFullCycles += cycles;
+    }
+    cpuStats.skippedCycles += cycles;
+
+    fetch.countStalledCycles(cycles);
+    decode.countStalledCycles(cycles);
+    rename.countStalledCycles(cycles);
+    iew.countStalledCycles(cycles);
+    commit.countStalledCycles(cycles);
+}
+
+void
+CPU::endStallSkip()
+{
+    // Memory responses are ordered before the tick of their cycle, so it ticks
+    // next. The tick of the cycle the skip started in already ran.
+    Cycles next_cycle = std::max(curCycle(), lastRunningCycle + Cycles(1));
+    countSkippedCycles(next_cycle - Cycles(1));
+
+    DPRINTF(Activity, "Woken after skipping %llu stalled cycles.\n",
+            next_cycle - lastRunningCycle - 1);
+
+    skippingStall = false;
+    stalledTicks = 0;
+    // A check tick may already be scheduled
+    reschedule(tickEvent, clockEdge(next_cycle - curCycle()), true);
+}
+
+namespace
+{
+
+bool
+sameChange(statistics::Result from_a, statistics::Result to_a,
+           statistics::Result from_b, statistics::Result to_b)
+{
+    statistics::Result a = to_a - from_a, b = to_b - from_b;
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+} // anonymous namespace
+
+void
+CPU::recordStats(const statistics::Group &group, StatValues &values)
+{
+    for (statistics::Info *info : group.getStats()) {
+        std::vector<statistics::Result> &value = values[info];
+        // Formulas only derive from the other stats
+        if (dynamic_cast<statistics::FormulaInfo *>(info)) {
+            continue;
+        } else if (auto scalar = dynamic_cast<statistics::ScalarInfo *>(info)) {
+            value.push_back(scalar->result());
+        } else if (auto vector = dynamic_cast<statistics::VectorInfo *>(info)) {
+            value = vector->result();
+        } else if (auto vector2d = dynamic_cast<statistics::Vector2dInfo *>(info)) {
+            vector2d->prepare();
+            value.assign(vector2d->cvec.begin(), vector2d->cvec.end());
+        } else if (auto dist = dynamic_cast<statistics::DistInfo *>(info)) {
+            // Min and max are not additive, and any other sample changes the rest anyway
+            dist->prepare();
+            value.assign(dist->data.cvec.begin(), dist->data.cvec.end());
+            value.insert(value.end(), {dist->data.sum, dist->data.squares, dist->data.samples,
+                                       dist->data.underflow, dist->data.overflow});
+        } else if (auto vector_dist = dynamic_cast<statistics::VectorDistInfo *>(info)) {
+            vector_dist->prepare();
+            for (const statistics::DistData &data : vector_dist->data) {
+                value.insert(value.end(), data.cvec.begin(), data.cvec.end());
+                value.insert(value.end(), {data.sum, data.squares, data.samples});
+            }
+        }
+    }
+
+    for (const auto &[name, child] : group.getStatGroups())
+        recordStats(*child, values);
+}
+
+void
+CPU::beginStallCheck()
+{
+    assert(checkStalledCycles && !stallCheck);
+
+    // A stats dump counted the skipped cycle already, leaving nothing to compare
+    if (stallCountedCycle >= curCycle() - Cycles(1)) {
+        skippingStall = false;
+        return;
+    }
+
+    stallCheck = std::make_unique<StallCheck>();
+
+    recordStats(*this, stallCheck->beforeSkip);
+    stallCheck->genBeforeSkip = random_mt.gen;
+
+    // Nothing woke the CPU, so the previous cycle is skipped
+    countSkippedCycles(curCycle() - Cycles(1));
+    skippingStall = false;
+
+    recordStats(*this, stallCheck->afterSkip);
+    stallCheck->genAfterSkip = random_mt.gen;
+}
+
+void
+CPU::endStallCheck()
+{
+    // Nothing woke the CPU since the skip started, so this cycle must stall as well
+    panic_if(stalledTicks == 0,
+             "Skipped a stall, but cycle %llu no longer stalls without being woken.\n",
+             curCycle());
+
+    StatValues ticked;
+    recordStats(*this, ticked);
+    for (const auto &[info, values] : ticked) {
+        // Only counted by skips
+        if (info == cpuStats.skippedCycles.info())
+            continue;
+
+        const std::vector<statistics::Result> &before = stallCheck->beforeSkip.at(info);
+        const std::vector<statistics::Result> &skipped = stallCheck->afterSkip.at(info);
+        panic_if(values.size() != skipped.size(),
+                 "Stat %s changed size while checking a skipped stall.\n", info->name);
+        for (size_t i = 0; i < values.size(); i++) {
+            panic_if(!sameChange(before[i], skipped[i], skipped[i], values[i]),
+                     "Skipping cycle %llu changed stat %s[%i] by %f, but ticking cycle %llu "
+                     "changed it by %f.\n", curCycle() - 1, info->name, i,
+                     skipped[i] - before[i], curCycle(), values[i] - skipped[i]);
+        }
+    }
+
+    // Same amount of random numbers drawn, so later draws stay the same
+    Random::RandomGenerator gen = stallCheck->genBeforeSkip;
+    unsigned long long draws = 0;
+    for (; gen != stallCheck->genAfterSkip; draws++)
+        gen();
+    gen = stallCheck->genAfterSkip;
+    gen.discard(draws);
+    panic_if(gen != random_mt.gen,
+             "Skipping cycle %llu drew %llu random numbers, but ticking cycle %llu drew a "
+             "different amount.\n", curCycle() - 1, draws, curCycle());
+
+    stallCheck.reset();
+}
+
+void
+CPU::preDumpStats()
+{
+    // Up to the last cycle whose tick would have run by now
+    if (skippingStall)
+        countSkippedCycles(clockEdge() == curTick() ? curCycle() : curCycle() - Cycles(1));
+
+    BaseCPU::preDumpStats();
+}
+
+void
+CPU::resetStats()
+{
+    // The cycles skipped so far belong before the reset
+    if (skippingStall)
+        countSkippedCycles(clockEdge() == curTick() ? curCycle() : curCycle() - Cycles(1));
+
+    BaseCPU::resetStats();
 }
 
 void
@@ -1086,7 +1462,7 @@ CPU::isCpuDrained() const
 {
     bool drained(true);
 
-    if (!instList.empty() || !removeList.empty()) {
+    if (!instWindow.empty() || instWindow.hasRemovals()) {
         DPRINTF(Drain, "Main CPU structures not drained.\n");
         drained = false;
     }
@@ -1148,6 +1524,8 @@ CPU::drainResume()
 
     // Reschedule any power gating event (if any)
     schedulePowerGatingEvent();
+
+    startCommitWatchdog();
 }
 
 void
@@ -1183,6 +1561,8 @@ CPU::takeOverFrom(BaseCPU *oldCPU)
 
     lastRunningCycle = curCycle();
     _status = Idle;
+
+    startCommitWatchdog();
 }
 
 void
@@ -1403,21 +1783,24 @@ CPU::squashFromTC(ThreadID tid)
 {
     thread[tid]->noSquashFromTC = true;
     commit.generateTCEvent(tid);
+
+    // Commit squashes on its next tick
+    if (skippingStall)
+        wakeCPU();
 }
 
-CPU::ListIt
+InstWindow::Pos
 CPU::addInst(const DynInstPtr &inst)
 {
-    instList.push_back(inst);
-
-    return --(instList.end());
+    return instWindow.push(inst);
 }
 
 void
 CPU::removeInst(const DynInstPtr &inst)
 {
-    squashInstIt(inst->getInstListIt(), inst->threadNumber);
-    removeInstsThisCycle = true;
+    // The instruction may have been squashed and cleaned up already
+    if (instWindow.contains(inst->getWindowPos(), inst))
+        squashInstAt(inst->getWindowPos(), inst->threadNumber);
 }
 
 void
@@ -1451,161 +1834,98 @@ CPU::removeFrontInst(const DynInstPtr &inst)
             "[sn:%lli]\n",
             inst->threadNumber, inst->pcState(), inst->seqNum);
 
-    removeInstsThisCycle = true;
+    assert(instWindow.contains(inst->getWindowPos(), inst));
 
     // Remove the front instruction.
     inst->removeFromCPU();
-    removeList.push(inst->getInstListIt());
+    instWindow.remove(inst->getWindowPos());
 }
 
 void
 CPU::removeInstsNotInROB(ThreadID tid)
 {
     DPRINTF(O3CPU, "Thread %i: Deleting instructions from instruction"
-            " list.\n", tid);
+            " window.\n", tid);
 
-    ListIt end_it;
-
-    bool rob_empty = false;
-
-    if (instList.empty()) {
+    if (instWindow.empty())
         return;
-    } else if (rob.isEmpty(tid)) {
+
+    // Remove everything younger than the ROB tail, or everything if the ROB is empty
+    InstWindow::Pos end_pos;
+    if (rob.isEmpty(tid)) {
         DPRINTF(O3CPU, "ROB is empty, squashing all insts.\n");
-        end_it = instList.begin();
-        rob_empty = true;
+        end_pos = instWindow.headPos();
     } else {
-        end_it = (rob.readTailInst(tid))->getInstListIt();
+        end_pos = rob.readTailInst(tid)->getWindowPos() + 1;
         DPRINTF(O3CPU, "ROB is not empty, squashing insts not in ROB.\n");
     }
 
-    removeInstsThisCycle = true;
-
-    ListIt inst_it = instList.end();
-
-    inst_it--;
-
-    // Walk through the instruction list, removing any instructions
-    // that were inserted after the given instruction iterator, end_it.
-    while (inst_it != end_it) {
-        assert(!instList.empty());
-
-        squashInstIt(inst_it, tid);
-
-        inst_it--;
-    }
-
-    // If the ROB was empty, then we actually need to remove the first
-    // instruction as well.
-    if (rob_empty) {
-        squashInstIt(inst_it, tid);
-    }
+    // Walk the window from the youngest instruction down to end_pos.
+    for (InstWindow::Pos pos = instWindow.tailPos(); pos > end_pos; pos--)
+        squashInstAt(pos - 1, tid);
 }
 
 void
 CPU::removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid)
 {
-    assert(!instList.empty());
-
-    removeInstsThisCycle = true;
-
-    ListIt inst_iter = instList.end();
-
-    inst_iter--;
+    assert(!instWindow.empty());
 
     DPRINTF(O3CPU, "Deleting instructions from instruction "
-            "list that are from [tid:%i] and above [sn:%lli] (end=%lli).\n",
-            tid, seq_num, (*inst_iter)->seqNum);
-
-    while ((*inst_iter)->seqNum > seq_num) {
-
-        bool break_loop = (inst_iter == instList.begin());
+            "window that are from [tid:%i] and above [sn:%lli] (end=%lli).\n",
+            tid, seq_num, instWindow.at(instWindow.tailPos() - 1)->seqNum);
 
-        squashInstIt(inst_iter, tid);
-
-        inst_iter--;
-
-        if (break_loop)
+    // The window is in program order, so stop at the first older instruction
+    for (InstWindow::Pos pos = instWindow.tailPos(); pos > instWindow.headPos(); pos--) {
+        const DynInstPtr &inst = instWindow.at(pos - 1);
+        if (!inst)
+            continue;
+        if (inst->seqNum <= seq_num)
             break;
+
+        squashInstAt(pos - 1, tid);
     }
 }
 
 void
-CPU::squashInstIt(const ListIt &instIt, ThreadID tid)
+CPU::squashInstAt(InstWindow::Pos pos, ThreadID tid)
 {
-    if ((*instIt)->threadNumber == tid) {
+    const DynInstPtr &inst = instWindow.at(pos);
+    if (inst && inst->threadNumber == tid) {
         DPRINTF(O3CPU, "Squashing instruction, "
                 "[tid:%i] [sn:%lli] PC %s\n",
-                (*instIt)->threadNumber,
-                (*instIt)->seqNum,
-                (*instIt)->pcState());
+                inst->threadNumber,
+                inst->seqNum,
+                inst->pcState());
 
         // Mark it as squashed.
-        (*instIt)->setSquashed();
-        (*instIt)->removeFromCPU();
+        inst->setSquashed();
+        inst->removeFromCPU();
 
-        // @todo: Formulate a consistent method for deleting
-        // instructions from the instruction list
-        // Remove the instruction from the list.
-        removeList.push(instIt);
+        // Queue the instruction for removal from the window.
+        instWindow.remove(pos);
     }
 }
 
 void
 CPU::cleanUpRemovedInsts()
 {
-    std::queue<ListIt> toRemove;
-    for (ListIt it = instList.begin(); it != instList.end(); it++) {
-        DynInstPtr inst = *it;
-        if (inst->shouldRemove())
-            toRemove.push(it);
-    }
-
-    while (!toRemove.empty()) {
-        ListIt removeIt = toRemove.front();
-        toRemove.pop();
-
-        instList.erase(removeIt);
-    }
-
-    // while (!removeList.empty()) {
-    //     DPRINTF(O3CPU, "Removing instruction, "
-    //             "[tid:%i] [sn:%lli] PC %s\n",
-    //             (*removeList.front())->threadNumber,
-    //             (*removeList.front())->seqNum,
-    //             (*removeList.front())->pcState());
-
-    //     instList.erase(removeList.front());
-
-    //     removeList.pop();
-    // }
-
-    removeInstsThisCycle = false;
-}
-/*
-void
-CPU::removeAllInsts()
-{
-    instList.clear();
+    instWindow.cleanUp();
 }
-*/
+
 void
 CPU::dumpInsts()
 {
     int num = 0;
 
-    ListIt inst_list_it = instList.begin();
-
-    cprintf("Dumping Instruction List\n");
+    cprintf("Dumping Instruction Window\n");
 
-    while (inst_list_it != instList.end()) {
+    for (const DynInstPtr &inst : instWindow) {
         cprintf("Instruction:%i\nPC:%#x\n[tid:%i]\n[sn:%lli]\nIssued:%i\n"
                 "Squashed:%i\n\n",
-                num, (*inst_list_it)->pcState().instAddr(),
-                (*inst_list_it)->threadNumber,
-                (*inst_list_it)->seqNum, (*inst_list_it)->isIssued(),
-                (*inst_list_it)->isSquashed());
-        inst_list_it++;
+                num, inst->pcState().instAddr(),
+                inst->threadNumber,
+                inst->seqNum, inst->isIssued(),
+                inst->isSquashed());
         ++num;
     }
 }
@@ -1654,19 +1974,13 @@ CPU::canEnterRunahead(ThreadID tid, const DynInstPtr &inst)
         return false;
     }
 
-    // Check if we should be waiting for a full ROB or not
-    if (!runaheadEagerEntry && commit.rob->numFreeEntries(tid) > 0) {
-        DPRINTF(RunaheadCPU, "[tid:%i] Cannot enter runahead, ROB is not full yet.\n", tid);
-        cpuStats.refusedRunaheadEntries[cpuStats.NotStalling]++;
-        return false;
-    }
-
-    // Check if this period is potentially too short
-    Cycles inFlightCycles = ticksToCycles(curTick() - inst->firstIssue);
-    assert(inFlightCycles > Cycles(0));
-    if (inFlightCycles > runaheadInFlightThreshold) {
-        DPRINTF(RunaheadCPU, "[tid:%i] Cannot enter runahead, load has been in-flight too long.\n", tid);
-        cpuStats.refusedRunaheadEntries[cpuStats.ExpectedReturnSoon]++;
+    // Check if the ROB stalls, and if this period is potentially too short
+    int refused = stallEntryRefusal(tid, inst);
+    if (refused >= 0) {
+        DPRINTF(RunaheadCPU, "[tid:%i] Cannot enter runahead, %s.\n", tid,
+                refused == cpuStats.NotStalling ? "ROB is not full yet" :
+                "load has been in-flight too long");
+        cpuStats.refusedRunaheadEntries[refused]++;
         return false;
     }
 
@@ -1678,9 +1992,51 @@ CPU::canEnterRunahead(ThreadID tid, const DynInstPtr &inst)
         return false;
     }
 
+    // Check that runahead has historically been useful for this LLL
+    // A vetoed LLL keeps being vetoed while it waits at the ROB head, count it once
+    auto decision = entryPredictor.allowEntry(tid, inst->pcState().instAddr(), inst->seqNum);
+    if (decision == RunaheadEntryPredictor::StillVetoed)
+        return false;
+
+    if (decision == RunaheadEntryPredictor::Veto) {
+        DPRINTF(RunaheadCPU, "[tid:%i] Cannot enter runahead, predicted useless for PC %s.\n",
+                tid, inst->pcState());
+        cpuStats.refusedRunaheadEntries[cpuStats.EntryPredicted]++;
+        return false;
+    }
+
     return true;
 }
 
+int
+CPU::stallEntryRefusal(ThreadID tid, const DynInstPtr &inst)
+{
+    // Check if we should be waiting for a full ROB or not
+    if (!runaheadEagerEntry && commit.rob->numFreeEntries(tid) > 0)
+        return cpuStats.NotStalling;
+
+    Cycles inFlightCycles = ticksToCycles(curTick() - inst->firstIssue);
+    assert(inFlightCycles > Cycles(0));
+    if (inFlightCycles > runaheadInFlightThreshold)
+        return cpuStats.ExpectedReturnSoon;
+
+    return -1;
+}
+
+bool
+CPU::entryDecisionFinal(ThreadID tid, const DynInstPtr &inst, int &refused)
+{
+    refused = -1;
+    if (!runaheadEnabled)
+        return true;
+
+    // A stalled ROB stays as full and the inst only gets older, so these refusals
+    // hold until the CPU is woken. Any later check flips to ExpectedReturnSoon
+    // once the inst is in flight for long enough, so none of them is final.
+    refused = stallEntryRefusal(tid, inst);
+    return refused >= 0;
+}
+
 bool
 CPU::enterRunahead(ThreadID tid)
 {
@@ -1694,17 +2050,22 @@ CPU::enterRunahead(ThreadID tid)
                          tid, robHead->seqNum, robHead->pcState());
     Cycles inFlightCycles = ticksToCycles(curTick() - robHead->firstIssue);
     cpuStats.triggerLLLinFlightCycles.sample(inFlightCycles);
-
-    // DEBUG - dump before runahead starts
-    //dumpArchRegs(tid);
-    // Also debug, save regs in a simple way to make sure they're the same on exit
+    if (robHead->isDetectedLLL())
+        cpuStats.earlyLLLLeadCycles.sample(ticksToCycles(curTick() - robHead->lllDetectedTick));
+
+    // Precise runahead never touches the ROB, so there is no architectural state to save
+    if (!preciseRunahead) {
+        // DEBUG - dump before runahead starts
+        //dumpArchRegs(tid);
+        // Also debug, save regs in a simple way to make sure they're the same on exit
 #if !defined(NDEBUG)
-    saveStateForValidation(tid);
+        saveStateForValidation(tid);
 #endif
 
-    DPRINTF(RunaheadCPU, "[tid:%i] Saving architectural state. Commit PC: %s\n", tid, commit.pcState(tid));
-    archStateCheckpoint.fullSave(tid);
-    commit.storeCurrentPC(tid);
+        DPRINTF(RunaheadCPU, "[tid:%i] Saving architectural state. Commit PC: %s\n", tid, commit.pcState(tid));
+        archStateCheckpoint.fullSave(tid);
+        commit.storeCurrentPC(tid);
+    }
 
     DPRINTF(RunaheadCPU, "[tid:%i] Switching CPU mode to runahead.\n", tid);
     inRunahead(tid, true);
@@ -1716,11 +2077,14 @@ CPU::enterRunahead(ThreadID tid)
       * Note that it is not enough to mark all ROB instructions as runahead.
       * Some instructions may be in frontend buffers,
       * and we need to mark the entire instruction window.
+      * In precise runahead, the ROB is left alone and only the insts beyond it run ahead.
       */
-    for (DynInstPtr inst : instList) {
+    for (const DynInstPtr &inst : instWindow) {
         // Committed instructions are not considered in-flight
         if (inst->threadNumber != tid || inst->isCommitted())
             continue;
+        if (preciseRunahead && inst->isInROB())
+            continue;
 
         DPRINTF(RunaheadCPU, "[tid:%i] Marking instruction [sn:%llu] PC %s as runahead\n",
                 tid, inst->seqNum, inst->pcState());
@@ -1729,34 +2093,105 @@ CPU::enterRunahead(ThreadID tid)
 
     // Invalidate R cache for the upcoming runahead period
     runaheadCache.invalidateCache();
+    // Attribute the prefetches of this period to it
+    prefetchTracker.startPeriod();
+    valuePredictor.startPeriod();
+    reuseBuffer.startPeriod(tid);
+    periodTrace.startPeriod(tid);
     // Poison the LLL and "execute" it so it can drain out.
-    handleRunaheadLLL(robHead);
+    // In precise runahead, the LLL instead waits at the ROB head for its data.
+    if (!preciseRunahead)
+        handleRunaheadLLL(robHead);
 
     // Attempt to generate a load chain and place it in the CPU's buffer
     if (filteredRunahead) {
-        runaheadChain.clear();
-        rob.generateChainBuffer(robHead, runaheadChain);
-        if (runaheadChain.size() > 0)
-            cpuStats.dependenceChainLength.sample(runaheadChain.size());
+        runaheadChain[tid].clear();
+        std::vector<DynInstPtr> chainInsts;
+        if (earlyChainLLL[tid] == robHead && !earlyChain[tid].empty()) {
+            // The chain was generated when the LLL missed
+            DPRINTF(RunaheadCPU, "[tid:%i] Using chain generated when sn:%llu was detected.\n",
+                    tid, robHead->seqNum);
+            runaheadChain[tid].swap(earlyChain[tid]);
+            chainInsts.swap(earlyChainInsts[tid]);
+            cpuStats.earlyChainsUsed++;
+        } else {
+            rob.generateChainBuffer(robHead, runaheadChain[tid],
+                                    runaheadBuffer.isEnabled() ? &chainInsts : nullptr);
+        }
+        if (runaheadChain[tid].size() > 0)
+            cpuStats.dependenceChainLength.sample(runaheadChain[tid].size());
+        if (hashedChainFilter)
+            runaheadChainFilter[tid].build(runaheadChain[tid]);
+
+        // Hand the chain to the engine so it keeps running it after this period
+        if (continuousEngine && runaheadChain[tid].size() > 0)
+            continuousEngine->chainGenerated(tid, robHead);
+
+        // Replay the chain from the runahead buffer if it fits, otherwise fall back to filtered fetch
+        if (runaheadBuffer.isEnabled())
+            runaheadBuffer.activate(tid, chainInsts);
     }
 
+    // Issue lanes for future iterations of the LLL, if it follows a pattern
+    vectorRunahead.start(tid, robHead);
+
+    earlyChainLLL[tid] = nullptr;
+    earlyChain[tid].clear();
+    earlyChainInsts[tid].clear();
+
     // Reset and record stats related stuff
     commit.instsPseudoretired[tid] = 0;
-    runaheadEnteredTick = curTick();
+    commit.loadsPseudoretired[tid] = 0;
+    commit.validLoadsPseudoretired[tid] = 0;
+    runaheadEnteredTick[tid] = curTick();
     cpuStats.runaheadPeriods++;
+    cpuStats.threadRunaheadPeriods[tid]++;
 
     return true;
 }
 
+void
+CPU::lllDetected(const DynInstPtr &inst)
+{
+    ThreadID tid = inst->threadNumber;
+    inst->lllDetectedTick = curTick();
+    cpuStats.earlyLLLs++;
+
+    if (!filteredRunahead || inRunahead(tid) || !inst->isInROB())
+        return;
+
+    // Only the oldest outstanding LLL can cause runahead, so only it needs a chain
+    const DynInstPtr &current = earlyChainLLL[tid];
+    if (current && current->seqNum < inst->seqNum && !current->isSquashed() &&
+        !current->isCommitted() && !current->isExecuted())
+        return;
+
+    earlyChain[tid].clear();
+    earlyChainInsts[tid].clear();
+    rob.generateChainBuffer(inst, earlyChain[tid],
+                            runaheadBuffer.isEnabled() ? &earlyChainInsts[tid] : nullptr);
+    earlyChainLLL[tid] = inst;
+
+    DPRINTF(RunaheadCPU, "[tid:%i] sn:%llu detected as LLL before the ROB head. "
+            "Generated chain of %i insts.\n", tid, inst->seqNum, earlyChain[tid].size());
+    if (!earlyChain[tid].empty())
+        cpuStats.earlyChainsGenerated++;
+}
+
 bool
 CPU::inRunaheadChain(const DynInstPtr &inst)
 {
+    ThreadID tid = inst->threadNumber;
+
     // If there is no chain, every inst is "in the runahead chain"
-    if (runaheadChain.size() == 0)
+    if (runaheadChain[tid].size() == 0)
         return true;
 
+    if (hashedChainFilter)
+        return runaheadChainFilter[tid].contains(inst->pcState());
+
     const PCStateBase &pc = inst->pcState();
-    for (ChainIt it = runaheadChain.begin(); it != runaheadChain.end(); it++) {
+    for (ChainIt it = runaheadChain[tid].begin(); it != runaheadChain[tid].end(); it++) {
         if (*it == pc)
             return true;
     }
@@ -1764,13 +2199,12 @@ CPU::inRunaheadChain(const DynInstPtr &inst)
 }
 
 bool
-CPU::isEndOfRunaheadChain(const PCStateBase &pc)
+CPU::isEndOfRunaheadChain(ThreadID tid, const PCStateBase &pc)
 {
-    if (runaheadChain.size() == 0)
-        return false;
+    if (hashedChainFilter)
+        return runaheadChainFilter[tid].isEnd(pc);
 
-    std::vector<PCPair>::iterator lastIt = --runaheadChain.end();
-    return (*lastIt == pc);
+    return runaheadChain[tid].size() > 0 && runaheadChain[tid].back() == pc;
 }
 
 void
@@ -1787,7 +2221,7 @@ CPU::runaheadLLLReturn(ThreadID tid)
 void
 CPU::exitRunahead(ThreadID tid)
 {
-    Tick timeInRunahead = ticksToCycles(curTick() - runaheadEnteredTick);
+    Tick timeInRunahead = ticksToCycles(curTick() - runaheadEnteredTick[tid]);
     DPRINTF(RunaheadCPU, "[tid:%i] Exiting runahead after %llu cycles. Instructions pseudoretired: %i\n",
                          tid, timeInRunahead, commit.instsPseudoretired[tid]);
 
@@ -1796,9 +2230,27 @@ CPU::exitRunahead(ThreadID tid)
     cpuStats.instsFetchedBetweenRunahead.sample(fetch.instsBetweenRunahead[tid]);
     cpuStats.instsRetiredBetweenRunahead.sample(commit.instsBetweenRunahead[tid]);
 
+    periodTrace.endPeriod(tid, runaheadCause[tid]->pcState().instAddr(), runaheadChain[tid]);
+
+    // Learn whether or not the period was worth entering
+    entryPredictor.train(tid, runaheadCause[tid]->pcState().instAddr(),
+                         commit.numLLLsThisPeriod[tid], commit.validLoadsPseudoretired[tid]);
+
     // Resume normal mode
     DPRINTF(RunaheadCPU, "[tid:%i] Switching CPU mode to normal.\n", tid);
     inRunahead(tid, false);
+    runaheadBuffer.deactivate(tid);
+    vectorRunahead.stop(tid);
+    reuseBuffer.endPeriod(tid);
+
+    // Precise runahead skips the checkpoint restore, so clear runahead register state here.
+    // Any registers marked by runahead belonged to runahead insts that are being squashed.
+    if (preciseRunahead) {
+        cpuStats.poisonedRegsAtExit.sample(regFile.numPoisoned());
+        regFile.clearPoison();
+        regFile.clearPredicted();
+        possiblyDiverging(tid, false);
+    }
 
     fetch.instsBetweenRunahead[tid] = 0;
     commit.instsBetweenRunahead[tid] = 0;
@@ -1809,7 +2261,19 @@ CPU::handleRunaheadLLL(const DynInstPtr &inst)
 {
     assert(inst->isLoad() && inst->hasRequest());
 
+    // Predict the value of the LLL if possible. The forged response then completes it normally
+    uint64_t value;
+    if (valuePredictor.predict(inst, value)) {
+        DPRINTF(RunaheadPoison, "[sn:%llu] PC %s value predicted as runahead LLL\n",
+                inst->seqNum, inst->pcState());
+        inst->setPredicted();
+        iew.ldstQueue.forgeResponse(inst, value);
+        return;
+    }
+
     // Poison the LLL, mark it as executed
+    DPRINTF(RunaheadPoison, "[sn:%llu] PC %s poisoned as runahead-causing LLL\n",
+            inst->seqNum, inst->pcState());
     inst->setPoisoned();
     inst->setExecuted();
 
@@ -1859,7 +2323,9 @@ CPU::restoreCheckpointState(ThreadID tid)
     // Restore architectural registers
     archStateCheckpoint.restore(tid);
     // Clear all register poison
+    cpuStats.poisonedRegsAtExit.sample(regFile.numPoisoned());
     regFile.clearPoison();
+    regFile.clearPredicted();
     possiblyDiverging(tid, false);
 
     // DEBUG - dump arch regs after checkpoint restore
@@ -1906,62 +2372,17 @@ CPU::updateArchCheckpoint(ThreadID tid, const DynInstPtr &inst)
 void
 CPU::regPoisoned(PhysRegIdPtr physReg, bool poisoned)
 {
-    if (poisoned) {
-        switch (physReg->classValue()) {
-        case IntRegClass:
-            cpuStats.intRegPoisoned++;
-            break;
-        case FloatRegClass:
-            cpuStats.floatRegPoisoned++;
-            break;
-        case CCRegClass:
-            cpuStats.ccRegPoisoned++;
-            break;
-        case VecRegClass:
-        case VecElemClass:
-            cpuStats.vecRegPoisoned++;
-            break;
-        case VecPredRegClass:
-            cpuStats.vecPredRegPoisoned++;
-            break;
-        case MiscRegClass:
-            cpuStats.miscRegPoisoned++;
-            break;
-        default:
-            break;
-        }
-    } else {
-        switch (physReg->classValue()) {
-        case IntRegClass:
-            cpuStats.intRegCured++;
-            break;
-        case FloatRegClass:
-            cpuStats.floatRegCured++;
-            break;
-        case CCRegClass:
-            cpuStats.ccRegCured++;
-            break;
-        case VecRegClass:
-        case VecElemClass:
-            cpuStats.vecRegCured++;
-            break;
-        case VecPredRegClass:
-            cpuStats.vecPredRegCured++;
-            break;
-        case MiscRegClass:
-            cpuStats.miscRegCured++;
-            break;
-        default:
-            break;
-        }
-    }
-    if (poisoned) {
-        DPRINTF(RunaheadCPU, "Poisoning physreg %i (flat: %i) (type: %s)\n",
-                physReg->index(), physReg->flatIndex(), physReg->className());
-    } else {
-        DPRINTF(RunaheadCPU, "Curing physreg %i (flat: %i) (type: %s)\n",
-                physReg->index(), physReg->flatIndex(), physReg->className());
+    RegClassType type = physReg->classValue();
+    if (type <= MiscRegClass) {
+        if (poisoned)
+            (*cpuStats.regPoisonedByClass[type])++;
+        else
+            (*cpuStats.regCuredByClass[type])++;
     }
+
+    DPRINTF(RunaheadCPU, "%s physreg %i (flat: %i) (type: %s)\n",
+            poisoned ? "Poisoning" : "Curing",
+            physReg->index(), physReg->flatIndex(), physReg->className());
     regFile.regPoisoned(physReg, poisoned);
 }
 
@@ -2055,6 +2476,12 @@ CPU::checkStateForValidation(ThreadID tid)
 void
 CPU::wakeCPU()
 {
+    // The activity recorder is still active while a stall is skipped
+    if (skippingStall) {
+        endStallSkip();
+        return;
+    }
+
     if (activityRec.active() || tickEvent.scheduled()) {
         DPRINTF(Activity, "CPU already running.\n");
         return;
@@ -2087,6 +2514,10 @@ CPU::wakeCPU()
 void
 CPU::wakeup(ThreadID tid)
 {
+    // Posted interrupts are only noticed by commit, which has to tick for it
+    if (skippingStall)
+        wakeCPU();
+
     if (thread[tid]->status() != gem5::ThreadContext::Suspended)
         return;
 
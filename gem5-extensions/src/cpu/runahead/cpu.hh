@@ -45,27 +45,40 @@
 
 #include <iostream>
 #include <list>
+#include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <vector>
 
 #include "arch/generic/pcstate.hh"
+#include "base/random.hh"
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
 #include "cpu/runahead/arch_checkpoint.hh"
+#include "cpu/runahead/chain_filter.hh"
 #include "cpu/runahead/comm.hh"
 #include "cpu/runahead/commit.hh"
 #include "cpu/runahead/decode.hh"
+#include "cpu/runahead/dyn_inst_alloc.hh"
 #include "cpu/runahead/dyn_inst_ptr.hh"
+#include "cpu/runahead/entry_predictor.hh"
 #include "cpu/runahead/fetch.hh"
 #include "cpu/runahead/free_list.hh"
 #include "cpu/runahead/iew.hh"
+#include "cpu/runahead/inst_window.hh"
 #include "cpu/runahead/limits.hh"
+#include "cpu/runahead/prefetch_tracker.hh"
 #include "cpu/runahead/rename.hh"
+#include "cpu/runahead/reuse_buffer.hh"
 #include "cpu/runahead/rob.hh"
+#include "cpu/runahead/runahead_buffer.hh"
 #include "cpu/runahead/runahead_cache.hh"
+#include "cpu/runahead/runahead_trace.hh"
 #include "cpu/runahead/scoreboard.hh"
 #include "cpu/runahead/thread_state.hh"
+#include "cpu/runahead/value_predictor.hh"
+#include "cpu/runahead/vector_runahead.hh"
 #include "cpu/runahead/pc_defs.hh"
 #include "cpu/activity.hh"
 #include "cpu/base.hh"
@@ -87,6 +100,7 @@ class Process;
 namespace runahead
 {
 
+class ContinuousRunaheadEngine;
 class ThreadContext;
 
 /**
@@ -97,10 +111,10 @@ class ThreadContext;
 class CPU : public BaseCPU
 {
   public:
-    typedef std::list<DynInstPtr>::iterator ListIt;
-
     friend class ThreadContext;
     friend class ArchCheckpoint;
+    friend class VectorRunahead;
+    friend class RunaheadTrace;
 
   public:
     enum Status
@@ -118,6 +132,12 @@ class CPU : public BaseCPU
     /** Overall CPU status. */
     Status _status;
 
+    /**
+     * Recycles DynInst buffers. Declared before anything holding instructions, so it is
+     * destroyed after all of them are returned.
+     */
+    DynInstAllocator dynInstAllocator;
+
   private:
 
     /** The tick event used for scheduling CPU ticks. */
@@ -126,6 +146,88 @@ class CPU : public BaseCPU
     /** The exit event used for terminating all ready-to-exit threads */
     EventFunctionWrapper threadExitEvent;
 
+    /** Periodically checks that the CPU still commits instructions */
+    EventFunctionWrapper commitWatchdogEvent;
+
+    /** Cycles between commit watchdog checks. 0 disables the watchdog */
+    const Cycles commitWatchdogCycles;
+
+    /** Whether the watchdog exits the simulation loop, or only dumps diagnostic state */
+    const bool commitWatchdogExit;
+
+    /** Committed instruction count at the last watchdog check */
+    Counter watchdogInsts = 0;
+
+    /** Fire the watchdog if nothing committed since the last check, then check again later */
+    void checkCommitProgress();
+
+    /** Start watching commit progress, if the watchdog is enabled */
+    void startCommitWatchdog();
+
+    /** Print the state of the pipeline, to tell why it stopped committing */
+    void dumpCommitState();
+
+    /** Whether or not to stop ticking while no stage can make progress */
+    const bool skipStalledCycles;
+
+    /**
+     * Whether or not to check the skipped cycles against ticking: skip only
+     * one cycle at a time, tick the next and panic if it changes the stats
+     * or draws random numbers differently than the skipped cycle counted
+     */
+    const bool checkStalledCycles;
+
+    /** Ticks in a row at the end of which all stages were stalled */
+    unsigned stalledTicks = 0;
+
+    /**
+     * Stalled ticks needed before skipping, so the time buffers and the
+     * activity recorder no longer hold anything from before the stall
+     */
+    const unsigned stallSettleTicks;
+
+    /** Whether or not the tick event is descheduled to skip a stall */
+    bool skippingStall = false;
+
+    /** Last cycle whose stats were counted while skipping a stall */
+    Cycles stallCountedCycle;
+
+    /**
+     * Whether or not every stage only counts stall stats until something
+     * wakes the CPU, so ticking can stop without changing the results
+     */
+    bool allStagesStalled();
+
+    /** Count the stats of the skipped cycles, up to and including the given one */
+    void countSkippedCycles(Cycles last);
+
+    /** Count the skipped cycles and resume ticking */
+    void endStallSkip();
+
+    /** Values of the statistics of the CPU and its children, see checkStalledCycles */
+    using StatValues = std::map<const statistics::Info *, std::vector<statistics::Result>>;
+
+    /** Record the values of the statistics of the group and its subgroups */
+    static void recordStats(const statistics::Group &group, StatValues &values);
+
+    /** State before and after counting the cycle skipped ahead of a check tick */
+    struct StallCheck
+    {
+        StatValues beforeSkip;
+        StatValues afterSkip;
+        Random::RandomGenerator genBeforeSkip;
+        Random::RandomGenerator genAfterSkip;
+    };
+
+    /** Set during a tick that checks the cycle skipped before it */
+    std::unique_ptr<StallCheck> stallCheck;
+
+    /** Count the cycle skipped before this tick, recording the state around it */
+    void beginStallCheck();
+
+    /** Panic if this tick changed the stats differently than the skipped cycle */
+    void endStallCheck();
+
     /** Schedule tick event, regardless of its current state. */
     void
     scheduleTickEvent(Cycles delay)
@@ -181,6 +283,10 @@ class CPU : public BaseCPU
     /** Register probe points. */
     void regProbePoints() override;
 
+    /** Count the cycles skipped so far before the stats are dumped or reset. */
+    void preDumpStats() override;
+    void resetStats() override;
+
     void
     demapPage(Addr vaddr, uint64_t asn)
     {
@@ -347,12 +453,13 @@ class CPU : public BaseCPU
      */
     void squashFromTC(ThreadID tid);
 
-    /** Function to add instruction onto the head of the list of the
-     *  instructions.  Used when new instructions are fetched.
+    /** Function to add instruction onto the head of the instruction
+     *  window.  Used when new instructions are fetched.  Returns the
+     *  position of the instruction in the window.
      */
-    ListIt addInst(const DynInstPtr &inst);
+    InstWindow::Pos addInst(const DynInstPtr &inst);
 
-    /** Remove an instruction from the instruction list */
+    /** Remove an instruction from the instruction window */
     void removeInst(const DynInstPtr &inst);
 
     /** Function to tell the CPU that an instruction has completed. */
@@ -370,13 +477,13 @@ class CPU : public BaseCPU
     /** Remove all instructions younger than the given sequence number. */
     void removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid);
 
-    /** Removes the instruction pointed to by the iterator. */
-    void squashInstIt(const ListIt &instIt, ThreadID tid);
+    /** Removes the instruction at the given window position. */
+    void squashInstAt(InstWindow::Pos pos, ThreadID tid);
 
-    /** Cleans up all instructions on the remove list. */
+    /** Cleans up all instructions queued for removal. */
     void cleanUpRemovedInsts();
 
-    /** Debug function to print all instructions on the list. */
+    /** Debug function to print all instructions in the window. */
     void dumpInsts();
 
     /** Debug function to print all architectural registers */
@@ -389,6 +496,15 @@ private:
     /** Whether or not filtered runahead is enabled */
     bool filteredRunahead;
 
+    /** Whether chain membership is looked up in the hashed filter, or by scanning the chain */
+    bool hashedChainFilter;
+
+    /** Whether or not runahead is precise, i.e. runs outside of the ROB without a checkpoint */
+    bool preciseRunahead;
+
+    /** Whether or not LLLs are detected as soon as they miss, instead of at the ROB head */
+    bool earlyLLLDetection;
+
     /** The in-flight threshold for runahead entry */
     Cycles runaheadInFlightThreshold;
 
@@ -398,6 +514,9 @@ private:
     /** Tracks which threads are in runahead */
     bool runaheadStatus[MaxThreads] = { false };
 
+    /** Whether or not threads in runahead are deprioritized in favor of normal mode threads (SMT) */
+    bool smtDeprioritizeRunahead;
+
     /**
      * True if the CPU is not currently processing a cycle (i.e. the CPU is between ticks)
      * Mostly for debugging purposes (e.g. setting breakpoints on events that happen off-tick)
@@ -425,9 +544,34 @@ public:
     /** Whether or not the CPU is using filtered runahead */
     bool usingFilteredRunahead() { return filteredRunahead; }
 
+    /** Whether or not the CPU is using precise runahead */
+    bool usingPreciseRunahead() { return preciseRunahead; }
+
+    /** Whether or not LLLs are detected as soon as they miss deep enough */
+    bool usingEarlyLLLDetection() { return earlyLLLDetection; }
+
+    /** Whether or not the thread is in precise runahead, i.e. runahead insts bypass the ROB */
+    bool inPreciseRunahead(ThreadID tid) { return preciseRunahead && runaheadStatus[tid]; }
+
+    /** Whether or not SMT fetch and IQ allocation should deprioritize threads in runahead */
+    bool deprioritizeRunaheadThreads() { return smtDeprioritizeRunahead; }
+
     /** Check if we can enter runahead right now, caused by the given inst */
     bool canEnterRunahead(ThreadID tid, const DynInstPtr &inst);
 
+    /**
+     * The refusal of canEnterRunahead() for the given inst that holds for as
+     * long as the ROB stalls on it, or -1 if there is none
+     */
+    int stallEntryRefusal(ThreadID tid, const DynInstPtr &inst);
+
+    /**
+     * Whether or not canEnterRunahead() gives the same answer for the given
+     * inst every cycle until something wakes the CPU. If so, refused is the
+     * refusal it counts every cycle, or -1 if it counts none.
+     */
+    bool entryDecisionFinal(ThreadID tid, const DynInstPtr &inst, int &refused);
+
     /**
      * Try to enter runahead, starting from the instruction at the head of the ROB.
      * Returns true if runahead was entered.
@@ -447,6 +591,13 @@ public:
     /** Unblock a long latency load at the head of the ROB */
     void handleRunaheadLLL(const DynInstPtr &inst);
 
+    /**
+     * A normal mode load missed deep enough in the memory hierarchy to be a LLL.
+     * Generates its chain in the background so runahead can be entered as soon as it
+     * reaches the ROB head.
+     */
+    void lllDetected(const DynInstPtr &inst);
+
     /** Restore the CPU's architectural state to the last checkpoint */
     void restoreCheckpointState(ThreadID tid);
 
@@ -474,32 +625,68 @@ public:
     /** Mark/unmark a register as poisoned */
     void regPoisoned(PhysRegIdPtr reg, bool poisoned);
 
+    /** Check if a register holds a value derived from a value predicted load */
+    bool regPredicted(PhysRegIdPtr reg) { return regFile.regPredicted(reg); }
+
+    /** Mark/unmark a register as holding a value derived from a value predicted load */
+    void regPredicted(PhysRegIdPtr reg, bool predicted) { regFile.regPredicted(reg, predicted); }
+
     /**
-     * PCs of instructions that should be executed by runahead. This acts as a filter for fetch.
-     * If the chain is not empty, insts that do not hit in this chain are discarded by fetch
+     * PCs of instructions that should be executed by runahead, per thread. This acts as a filter
+     * for fetch. If the chain is not empty, insts that do not hit in this chain are discarded by fetch
      */
-    std::vector<PCPair> runaheadChain;
+    std::vector<PCPair> runaheadChain[MaxThreads];
+
+    /** Hashed membership filters built from the runahead chains when runahead is entered */
+    RunaheadChainFilter runaheadChainFilter[MaxThreads];
 
-    /** Whether or not the given inst is in the runahead chain */
+    /** LLL the early chain of each thread was generated for, if any */
+    DynInstPtr earlyChainLLL[MaxThreads];
+
+    /** Chains generated when a LLL was detected, before it reached the ROB head */
+    std::vector<PCPair> earlyChain[MaxThreads];
+
+    /** Insts of the early chains, for the runahead buffer */
+    std::vector<DynInstPtr> earlyChainInsts[MaxThreads];
+
+    /** Whether or not the given inst is in its thread's runahead chain */
     bool inRunaheadChain(const DynInstPtr &inst);
 
-    /** Whether or not the given PC is the last PC of the runahead chain */
-    bool isEndOfRunaheadChain(const PCStateBase &pc);
+    /** Whether or not the given PC is the last PC of the thread's runahead chain */
+    bool isEndOfRunaheadChain(ThreadID tid, const PCStateBase &pc);
 
     /** Whether or not there is an active runahead chain */
-    bool runaheadChainInUse(ThreadID tid) { return (inRunahead(tid) && runaheadChain.size() > 0); }
+    bool runaheadChainInUse(ThreadID tid) { return (inRunahead(tid) && runaheadChain[tid].size() > 0); }
 
     /** Get an iterator to the beginning of the runahead chain */
-    ChainIt runaheadChainBegin() { return runaheadChain.begin(); }
+    ChainIt runaheadChainBegin(ThreadID tid) { return runaheadChain[tid].begin(); }
 
     /** Get an iterator to the end of the runahead chain */
-    ChainIt runaheadChainEnd() { return runaheadChain.end(); }
+    ChainIt runaheadChainEnd(ThreadID tid) { return runaheadChain[tid].end(); }
 
     /** Get the size of the runahead chain */
-    size_t runaheadChainSize() { return runaheadChain.size(); }
+    size_t runaheadChainSize(ThreadID tid) { return runaheadChain[tid].size(); }
+
+    /** Whether or not the runahead buffer is supplying instructions in place of fetch/decode */
+    bool runaheadBufferActive(ThreadID tid) { return runaheadBuffer.isActive(tid); }
+
+    /** Get the tracker that classifies runahead prefetches */
+    RunaheadPrefetchTracker &runaheadPrefetchTracker() { return prefetchTracker; }
 
-    /** The tick at which runahead was last entered */
-    Tick runaheadEnteredTick;
+    /** Get the predictor for the values of runahead LLLs */
+    LoadValuePredictor &loadValuePredictor() { return valuePredictor; }
+
+    /** Get vector runahead, which issues lanes of future LLL iterations */
+    VectorRunahead &vectorRunaheadUnit() { return vectorRunahead; }
+
+    /** Get the buffer holding runahead results for reuse after exit */
+    RunaheadReuseBuffer &resultReuseBuffer() { return reuseBuffer; }
+
+    /** Get the continuous runahead engine, or nullptr if there is none */
+    ContinuousRunaheadEngine *continuousRunaheadEngine() { return continuousEngine; }
+
+    /** The tick at which each thread last entered runahead */
+    Tick runaheadEnteredTick[MaxThreads] = { 0 };
 
     /** The depth at which a blocking memory request is considered a long latency load */
     uint8_t lllDepthThreshold;
@@ -513,25 +700,10 @@ public:
     int instcount;
 #endif
 
-    /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
-
-    /** List of all the instructions that will be removed at the end of this
-     *  cycle.
-     */
-    std::queue<ListIt> removeList;
-
-#ifdef DEBUG
-    /** Debug structure to keep track of the sequence numbers still in
-     * flight.
-     */
-    std::set<InstSeqNum> snList;
-#endif
-
-    /** Records if instructions need to be removed this cycle due to
-     *  being retired or squashed.
+    /** All the instructions in flight, and the ones that will be removed
+     *  at the end of this cycle.
      */
-    bool removeInstsThisCycle;
+    InstWindow instWindow;
 
   protected:
     /** The fetch stage. */
@@ -567,6 +739,30 @@ public:
     /** Runahead cache for holding store writebacks in runahead execution */
     RunaheadCache runaheadCache;
 
+    /** Runahead buffer, replays the dependence chain in place of fetch/decode */
+    RunaheadBuffer runaheadBuffer;
+
+    /** Classifies the blocks fetched by runahead loads by their usefulness */
+    RunaheadPrefetchTracker prefetchTracker;
+
+    /** Vetoes runahead entry for LLLs that cause useless periods */
+    RunaheadEntryPredictor entryPredictor;
+
+    /** Predicts the values of runahead LLLs so their dependents need not be poisoned */
+    LoadValuePredictor valuePredictor;
+
+    /** Replicates strided and indirect LLL patterns across lanes of prefetches */
+    VectorRunahead vectorRunahead;
+
+    /** Holds valid runahead results so normal mode need not execute them again */
+    RunaheadReuseBuffer reuseBuffer;
+
+    /** Binary trace of runahead periods */
+    RunaheadTrace periodTrace;
+
+    /** Runs the hottest dependence chains on the memory side, if configured */
+    ContinuousRunaheadEngine *continuousEngine = nullptr;
+
     /** Active Threads List */
     std::list<ThreadID> activeThreads;
 
@@ -747,6 +943,11 @@ public:
         /** Stat for total number of cycles the CPU spends descheduled due to a
          * quiesce operation or waiting for an interrupt. */
         statistics::Scalar quiesceCycles;
+        /** Stat for total number of cycles skipped while no stage could make
+         * progress, also counted in numCycles. */
+        statistics::Scalar skippedCycles;
+        /** Stat for total number of times the CPU started skipping a stall. */
+        statistics::Scalar stallSkips;
         /** Stat for the number of committed instructions per thread. */
         statistics::Vector committedInsts;
         /** Stat for the number of pseudoretired instructions per thread. */
@@ -794,6 +995,10 @@ public:
 
         // Amount of times runahead was entered
         statistics::Scalar runaheadPeriods;
+        // Amount of times each thread entered runahead
+        statistics::Vector threadRunaheadPeriods;
+        // Amount of cycles each thread spent in runahead
+        statistics::Vector threadRunaheadCycles;
         // Distribution of amount of cycles spent in runahead periods
         statistics::Distribution runaheadCycleDist;
         // Amount of times the CPU refused to enter into runahead
@@ -810,6 +1015,15 @@ public:
         // Distribution of dependence chain lengths
         statistics::Distribution dependenceChainLength;
 
+        // Amount of LLLs detected before reaching the ROB head
+        statistics::Scalar earlyLLLs;
+        // Amount of chains generated for LLLs before they reached the ROB head
+        statistics::Scalar earlyChainsGenerated;
+        // Amount of runahead periods that used a chain generated early
+        statistics::Scalar earlyChainsUsed;
+        // Histogram of cycles between detecting a LLL and it causing runahead
+        statistics::Histogram earlyLLLLeadCycles;
+
         // Amount of times an integer register was marked as poisoned
         statistics::Scalar intRegPoisoned;
         // Amount of times an integer register's poison was reset
@@ -834,11 +1048,17 @@ public:
         statistics::Scalar miscRegPoisoned;
         // Amount of times a misc register's poison was reset
         statistics::Scalar miscRegCured;
+        // Poison/cure counters above, indexed by register class
+        statistics::Scalar *regPoisonedByClass[MiscRegClass + 1];
+        statistics::Scalar *regCuredByClass[MiscRegClass + 1];
+        // Distribution of poisoned physical registers when exiting runahead
+        statistics::Distribution poisonedRegsAtExit;
 
         enum {
             NotStalling,
             ExpectedReturnSoon,
-            OverlappingPeriod
+            OverlappingPeriod,
+            EntryPredicted
         };
 
     } cpuStats;
@@ -144,7 +144,10 @@ Decode::DecodeStats::DecodeStats(CPU *cpu)
       ADD_STAT(decodedInsts, statistics::units::Count::get(),
                "Number of instructions handled by decode"),
       ADD_STAT(squashedInsts, statistics::units::Count::get(),
-               "Number of squashed instructions handled by decode")
+               "Number of squashed instructions handled by decode"),
+      ADD_STAT(runaheadBufferDiscardedInsts, statistics::units::Count::get(),
+               "Number of runahead instructions dropped by decode while the "
+               "runahead buffer supplied rename")
 {
     idleCycles.prereq(idleCycles);
     blockedCycles.prereq(blockedCycles);
@@ -157,6 +160,7 @@ Decode::DecodeStats::DecodeStats(CPU *cpu)
     controlMispred.prereq(controlMispred);
     decodedInsts.prereq(decodedInsts);
     squashedInsts.prereq(squashedInsts);
+    runaheadBufferDiscardedInsts.prereq(runaheadBufferDiscardedInsts);
 }
 
 void
@@ -217,6 +221,20 @@ Decode::isDrained() const
     return true;
 }
 
+bool
+Decode::isStalled() const
+{
+    assert(numThreads == 1);
+    ThreadID tid = activeThreads->front();
+    return decodeStatus[tid] == Blocked && stalls[tid].rename && insts[tid].empty();
+}
+
+void
+Decode::countStalledCycles(Cycles cycles)
+{
+    stats.blockedCycles += cycles;
+}
+
 bool
 Decode::checkStall(ThreadID tid) const
 {
@@ -630,6 +648,21 @@ Decode::decodeInsts(ThreadID tid)
     int insts_available = decodeStatus[tid] == Unblocking ?
         skidBuffer[tid].size() : insts[tid].size();
 
+    // Decode is gated while the runahead buffer supplies rename.
+    // Anything still in the frontend is not part of the chain, so drop it.
+    if (cpu->runaheadBufferActive(tid)) {
+        std::queue<DynInstPtr> &gated_insts = decodeStatus[tid] == Unblocking ?
+            skidBuffer[tid] : insts[tid];
+        while (!gated_insts.empty()) {
+            DPRINTF(Decode, "[tid:%i] [sn:%llu] Runahead buffer is active, "
+                    "dropping inst.\n", tid, gated_insts.front()->seqNum);
+            cpu->removeInst(gated_insts.front());
+            gated_insts.pop();
+            ++stats.runaheadBufferDiscardedInsts;
+        }
+        return;
+    }
+
     if (insts_available == 0) {
         DPRINTF(Decode, "[tid:%i] Nothing to do, breaking out"
                 " early.\n",tid);
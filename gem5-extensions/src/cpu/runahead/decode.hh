@@ -128,6 +128,12 @@ class Decode
     /** Has the stage drained? */
     bool isDrained() const;
 
+    /** Whether or not decode is blocked by rename, only counting blocked cycles */
+    bool isStalled() const;
+
+    /** Count the stats of cycles the CPU skipped while decode was blocked */
+    void countStalledCycles(Cycles cycles);
+
     /** Takes over from another CPU's thread. */
     void takeOverFrom() { resetStage(); }
 
@@ -150,6 +156,17 @@ class Decode
      */
     void decodeInsts(ThreadID tid);
 
+    /**
+     * Whether or not the runahead buffer may send instructions of a thread to rename.
+     * The buffer takes decode's place, so it obeys the same stall and squash signals.
+     */
+    bool canSendToRename(ThreadID tid) const
+    {
+        return !stalls[tid].rename && (decodeStatus[tid] == Running ||
+                                       decodeStatus[tid] == Idle ||
+                                       decodeStatus[tid] == Unblocking);
+    }
+
   private:
     /** Inserts a thread's instructions into the skid buffer, to be decoded
      * once decode unblocks.
@@ -322,6 +339,8 @@ class Decode
         statistics::Scalar decodedInsts;
         /** Stat for total number of squashed instructions. */
         statistics::Scalar squashedInsts;
+        /** Stat for number of runahead insts dropped while the runahead buffer supplies rename. */
+        statistics::Scalar runaheadBufferDiscardedInsts;
     } stats;
 };
 
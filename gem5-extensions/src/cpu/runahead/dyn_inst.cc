@@ -76,7 +76,6 @@ DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &static_inst,
     if (cpu->instcount > 1500) {
 #ifdef DEBUG
         cpu->dumpInsts();
-        dumpSNList();
 #endif
         assert(cpu->instcount <= 1500);
     }
@@ -85,11 +84,6 @@ DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &static_inst,
         "DynInst: [sn:%lli] Instruction created. Instcount for %s = %i\n",
         seqNum, cpu->name(), cpu->instcount);
 #endif
-
-#ifdef DEBUG
-    cpu->snList.insert(seqNum);
-#endif
-
 }
 
 DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &static_inst,
@@ -167,8 +161,10 @@ DynInst::operator new(size_t count, Arrays &arrays)
     // Figure out how much space we need in total.
     size_t total_size = ready_src_idx + ready_src_idx_size;
 
-    // Actually allocate it.
-    uint8_t *buf = (uint8_t *)::operator new(total_size);
+    // Actually allocate it, recycling the buffer of an older instruction if possible.
+    uint8_t *buf = arrays.allocator ?
+        (uint8_t *)arrays.allocator->allocate(total_size, num_srcs, num_dests) :
+        (uint8_t *)DynInstAllocator::allocateUntracked(total_size);
 
     // Fill in "arrays" with pointers to all the arrays.
     arrays.flatDestIdx = (RegId *)(buf + flat_dest_idx);
@@ -187,6 +183,18 @@ DynInst::operator new(size_t count, Arrays &arrays)
     return buf;
 }
 
+void
+DynInst::operator delete(void *ptr)
+{
+    DynInstAllocator::deallocate(ptr);
+}
+
+void
+DynInst::operator delete(void *ptr, Arrays &arrays)
+{
+    DynInstAllocator::deallocate(ptr);
+}
+
 DynInst::~DynInst()
 {
     /*
@@ -253,27 +261,9 @@ DynInst::~DynInst()
         "DynInst: [sn:%lli] Instruction destroyed. Instcount for %s = %i\n",
         seqNum, cpu->name(), cpu->instcount);
 #endif
-#ifdef DEBUG
-    cpu->snList.erase(seqNum);
-#endif
 };
 
 
-#ifdef DEBUG
-void
-DynInst::dumpSNList()
-{
-    std::set<InstSeqNum>::iterator sn_it = cpu->snList.begin();
-
-    int count = 0;
-    while (sn_it != cpu->snList.end()) {
-        cprintf("%i: [sn:%lli] not destroyed\n", count, (*sn_it));
-        count++;
-        sn_it++;
-    }
-}
-#endif
-
 void
 DynInst::dump()
 {
@@ -57,6 +57,7 @@
 #include "cpu/inst_res.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/runahead/cpu.hh"
+#include "cpu/runahead/dyn_inst_alloc.hh"
 #include "cpu/runahead/dyn_inst_ptr.hh"
 #include "cpu/runahead/lsq_unit.hh"
 #include "cpu/op_class.hh"
@@ -88,6 +89,9 @@ class DynInst : public ExecContext, public RefCounted
         size_t numSrcs;
         size_t numDests;
 
+        /** Allocator to get the buffer from, straight from the heap if nullptr */
+        DynInstAllocator *allocator = nullptr;
+
         RegId *flatDestIdx;
         PhysRegIdPtr *destIdx;
         PhysRegIdPtr *prevDestIdx;
@@ -97,6 +101,12 @@ class DynInst : public ExecContext, public RefCounted
 
     static void *operator new(size_t count, Arrays &arrays);
 
+    /** Return the buffer to the allocator it came from */
+    static void operator delete(void *ptr);
+
+    /** Called instead if a constructor throws */
+    static void operator delete(void *ptr, Arrays &arrays);
+
     /** BaseDynInst constructor given a binary instruction. */
     DynInst(const Arrays &arrays, const StaticInstPtr &staticInst,
             const StaticInstPtr &macroop, InstSeqNum seq_num, CPU *cpu);
@@ -191,6 +201,9 @@ class DynInst : public ExecContext, public RefCounted
         Poisoned,
         Runahead,
         ForgedResponse,
+        Predicted,
+        Reused,
+        DetectedLLL,
         MaxFlags,
     };
 
@@ -327,8 +340,8 @@ class DynInst : public ExecContext, public RefCounted
     /** The thread this instruction is from. */
     ThreadID threadNumber = 0;
 
-    /** Iterator pointing to this BaseDynInst in the list of all insts. */
-    ListIt instListIt;
+    /** Position of this instruction in the CPU's instruction window. */
+    InstWindow::Pos windowPos = 0;
 
     ////////////////////// Branch Data ///////////////
     /** Predicted PC state after this instruction. */
@@ -468,10 +481,6 @@ class DynInst : public ExecContext, public RefCounted
     }
 
   public:
-#ifdef DEBUG
-    void dumpSNList();
-#endif
-
     /** Renames a destination register to a physical register.  Also records
      *  the previous physical register that the logical register mapped to.
      */
@@ -902,6 +911,29 @@ class DynInst : public ExecContext, public RefCounted
     /** Returns whether or not this instruction has been issued a forged cache reply. */
     bool hasForgedResponse() const { return instFlags[ForgedResponse]; }
 
+    /** Marks this instruction as producing a value derived from a value predicted load */
+    void
+    setPredicted()
+    {
+        assert(isRunahead());
+        instFlags.set(Predicted);
+    }
+
+    /** Returns whether or not this instruction produces a value derived from a value prediction */
+    bool isPredicted() const { return instFlags[Predicted]; }
+
+    /** Marks this instruction as reusing a result of runahead instead of executing */
+    void setReused() { instFlags.set(Reused); }
+
+    /** Returns whether or not this instruction reused a result of runahead */
+    bool isReused() const { return instFlags[Reused]; }
+
+    /** Marks this load as a LLL, detected while its request was in flight */
+    void setDetectedLLL() { instFlags.set(DetectedLLL); }
+
+    /** Returns whether or not this load was detected as a LLL while in flight */
+    bool isDetectedLLL() const { return instFlags[DetectedLLL]; }
+
     /** Sets the destination registers as renamed */
     void
     setPinnedRegsRenamed()
@@ -995,11 +1027,11 @@ class DynInst : public ExecContext, public RefCounted
     void updateMemDepth(int depth) { _maxMemDepth = (depth > _maxMemDepth) ? depth : _maxMemDepth; }
     int getMemDepth() { return _maxMemDepth; }
 
-    /** Returns iterator to this instruction in the list of all insts. */
-    ListIt &getInstListIt() { return instListIt; }
+    /** Returns the position of this instruction in the instruction window. */
+    InstWindow::Pos getWindowPos() const { return windowPos; }
 
-    /** Sets iterator for this instruction in the list of all insts. */
-    void setInstListIt(ListIt _instListIt) { instListIt = _instListIt; }
+    /** Sets the position of this instruction in the instruction window. */
+    void setWindowPos(InstWindow::Pos pos) { windowPos = pos; }
 
   public:
     /** Returns the number of consecutive store conditional failures. */
@@ -1063,6 +1095,9 @@ class DynInst : public ExecContext, public RefCounted
     Tick firstIssue = -1;
     Tick lastWakeDependents = -1;
 
+    /** Tick at which the load was detected as a LLL */
+    Tick lllDetectedTick = 0;
+
     /** Reads a misc. register, including any side-effects the read
      * might have as defined by the architecture.
      */
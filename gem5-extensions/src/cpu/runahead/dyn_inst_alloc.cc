@@ -0,0 +1,133 @@
+#include "cpu/runahead/dyn_inst_alloc.hh"
+
+#include <new>
+
+#include "base/logging.hh"
+#include "cpu/runahead/cpu.hh"
+#include "params/BaseRunaheadCPU.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+DynInstAllocator::DynInstAllocator(CPU *_cpu, const BaseRunaheadCPUParams &params)
+    : cpu(_cpu),
+      enabled(params.dynInstFreeList),
+      stats(_cpu)
+{
+}
+
+DynInstAllocator::~DynInstAllocator()
+{
+    warn_if(live > 0, "%s: destroyed with %llu instructions still allocated.\n",
+            name(), live);
+
+    for (auto &free_list : freeLists) {
+        for (Header *header : free_list)
+            ::operator delete(header);
+    }
+}
+
+std::string
+DynInstAllocator::name() const
+{
+    return cpu->name() + ".dyninstalloc";
+}
+
+uint32_t
+DynInstAllocator::sizeClass(size_t num_srcs, size_t num_dests)
+{
+    // Static instructions have a handful of registers at most
+    assert(num_srcs < 256 && num_dests < 256);
+    return (num_srcs << 8) | num_dests;
+}
+
+DynInstAllocator::Header *
+DynInstAllocator::heapAllocate(size_t size)
+{
+    Header *header = (Header *)::operator new(sizeof(Header) + size);
+    header->owner = nullptr;
+    header->sizeClass = 0;
+    header->size = size;
+    return header;
+}
+
+void *
+DynInstAllocator::allocate(size_t size, size_t num_srcs, size_t num_dests)
+{
+    uint32_t size_class = sizeClass(num_srcs, num_dests);
+    Header *header = nullptr;
+
+    if (enabled && size_class < freeLists.size() && !freeLists[size_class].empty()) {
+        header = freeLists[size_class].back();
+        freeLists[size_class].pop_back();
+        // The DynInst part has a fixed size, so a class always has one buffer size
+        assert(header->size == size);
+        stats.reuseHits++;
+    } else {
+        header = heapAllocate(size);
+        header->owner = this;
+        header->sizeClass = size_class;
+    }
+
+    stats.allocations++;
+    live++;
+    if (live > stats.peakLive.value())
+        stats.peakLive = live;
+
+    return header + 1;
+}
+
+void *
+DynInstAllocator::allocateUntracked(size_t size)
+{
+    return heapAllocate(size) + 1;
+}
+
+void
+DynInstAllocator::deallocate(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    Header *header = (Header *)ptr - 1;
+    if (header->owner)
+        header->owner->release(header);
+    else
+        ::operator delete(header);
+}
+
+void
+DynInstAllocator::release(Header *header)
+{
+    assert(live > 0);
+    live--;
+
+    if (!enabled) {
+        ::operator delete(header);
+        return;
+    }
+
+    if (header->sizeClass >= freeLists.size())
+        freeLists.resize(header->sizeClass + 1);
+    freeLists[header->sizeClass].push_back(header);
+}
+
+DynInstAllocator::DynInstAllocatorStats::DynInstAllocatorStats(CPU *cpu)
+    : statistics::Group(cpu, "dyninstalloc"),
+      ADD_STAT(allocations, statistics::units::Count::get(),
+           "Number of DynInst buffers handed out"),
+      ADD_STAT(reuseHits, statistics::units::Count::get(),
+           "Number of DynInst buffers recycled from a free list"),
+      ADD_STAT(peakLive, statistics::units::Count::get(),
+           "Most DynInsts allocated at the same time"),
+      ADD_STAT(reuseRate, statistics::units::Ratio::get(),
+           "Fraction of DynInst buffers that did not come from the heap",
+           reuseHits / allocations)
+{
+    reuseRate.precision(6);
+}
+
+} // namespace runahead
+} // namespace gem5
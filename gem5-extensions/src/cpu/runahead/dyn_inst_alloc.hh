@@ -0,0 +1,103 @@
+#ifndef __CPU_RUNAHEAD_DYN_INST_ALLOC_HH__
+#define __CPU_RUNAHEAD_DYN_INST_ALLOC_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+
+namespace gem5
+{
+
+struct BaseRunaheadCPUParams;
+
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * Recycles the buffers DynInsts are allocated in. A DynInst and its register index arrays
+ * share one buffer, sized by its amount of source and destination registers. Buffers of
+ * squashed and committed instructions go to a free list per (sources, destinations) size
+ * class, and are handed out again to the next instruction of the same class instead of going
+ * back to the heap. Runahead refetches and squashes a whole window of instructions every
+ * period, so nearly all of them reuse a buffer.
+ *
+ * Every buffer starts with a header pointing back to its allocator, so the DynInst delete
+ * operator needs no CPU. The allocator must outlive every DynInst it handed out, which is why
+ * the CPU declares it before anything that holds instructions.
+ */
+class DynInstAllocator
+{
+  private:
+    /** Prefix of every buffer, keeps the DynInst after it aligned */
+    struct alignas(std::max_align_t) Header
+    {
+        /** Allocator to return the buffer to, nullptr if it came straight from the heap */
+        DynInstAllocator *owner;
+        /** Free list the buffer belongs on */
+        uint32_t sizeClass;
+        /** Size of the DynInst part of the buffer */
+        uint32_t size;
+    };
+
+    /** Pointer to the CPU */
+    CPU *cpu;
+
+    /** Whether or not buffers are recycled. If not, they are only counted */
+    const bool enabled;
+
+    /** Free buffers, indexed by size class */
+    std::vector<std::vector<Header *>> freeLists;
+
+    /** Amount of buffers handed out and not yet returned */
+    uint64_t live = 0;
+
+    /** Size class of an instruction with the given amount of registers */
+    static uint32_t sizeClass(size_t num_srcs, size_t num_dests);
+
+    /** Get a buffer with a header from the heap */
+    static Header *heapAllocate(size_t size);
+
+  public:
+    DynInstAllocator(CPU *_cpu, const BaseRunaheadCPUParams &params);
+    ~DynInstAllocator();
+
+    /** Returns the name of the allocator */
+    std::string name() const;
+
+    /** Get a buffer of size bytes for an instruction with the given amount of registers */
+    void *allocate(size_t size, size_t num_srcs, size_t num_dests);
+
+    /** Get a buffer that is not tracked by any allocator */
+    static void *allocateUntracked(size_t size);
+
+    /** Return a buffer from either of the allocate functions */
+    static void deallocate(void *ptr);
+
+  private:
+    /** Take back a buffer this allocator handed out */
+    void release(Header *header);
+
+    struct DynInstAllocatorStats : public statistics::Group
+    {
+        DynInstAllocatorStats(CPU *cpu);
+
+        /** Buffers handed out */
+        statistics::Scalar allocations;
+        /** Buffers handed out from a free list */
+        statistics::Scalar reuseHits;
+        /** Most buffers handed out at the same time */
+        statistics::Scalar peakLive;
+        /** Fraction of buffers that did not come from the heap */
+        statistics::Formula reuseRate;
+    } stats;
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_DYN_INST_ALLOC_HH__
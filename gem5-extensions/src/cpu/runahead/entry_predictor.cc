@@ -0,0 +1,162 @@
+#include "cpu/runahead/entry_predictor.hh"
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "cpu/runahead/cpu.hh"
+#include "debug/RunaheadEntryPredictor.hh"
+#include "params/BaseRunaheadCPU.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+RunaheadEntryPredictor::RunaheadEntryPredictor(CPU *_cpu, const BaseRunaheadCPUParams &params)
+    : cpu(_cpu),
+      enabled(params.enableRunahead && params.runaheadEntryPredictor),
+      indexMask(params.runaheadEntryPredictorEntries - 1),
+      tagMask(mask(params.runaheadEntryPredictorTagBits)),
+      threshold(params.runaheadEntryPredictorThreshold),
+      initialConfidence(params.runaheadEntryPredictorInitial),
+      probeInterval(params.runaheadEntryPredictorProbeInterval),
+      minLLLs(params.runaheadEntryPredictorMinLLLs),
+      minValidLoads(params.runaheadEntryPredictorMinValidLoads),
+      indexBits(floorLog2(params.runaheadEntryPredictorEntries)),
+      stats(_cpu)
+{
+    unsigned counterBits = params.runaheadEntryPredictorCounterBits;
+    fatal_if(!isPowerOf2(params.runaheadEntryPredictorEntries),
+             "Runahead entry predictor size must be a power of 2.\n");
+    fatal_if(counterBits == 0 || counterBits > 8,
+             "Runahead entry predictor counters must be 1 to 8 bits wide.\n");
+    fatal_if(threshold > (1U << counterBits) - 1 || initialConfidence > (1U << counterBits) - 1,
+             "Runahead entry predictor threshold and initial confidence must fit in the counters.\n");
+
+    if (enabled)
+        table.resize(params.runaheadEntryPredictorEntries, Entry(counterBits, initialConfidence));
+
+    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
+        predictedUseful[tid] = false;
+        lastVetoed[tid] = 0;
+    }
+}
+
+std::string
+RunaheadEntryPredictor::name() const
+{
+    return cpu->name() + ".entrypredictor";
+}
+
+RunaheadEntryPredictor::Decision
+RunaheadEntryPredictor::allowEntry(ThreadID tid, Addr pc, InstSeqNum seq_num)
+{
+    if (!enabled)
+        return Allow;
+
+    // Still waiting at the ROB head after being vetoed
+    if (vetoed(tid, seq_num))
+        return StillVetoed;
+
+    stats.lookups++;
+    Entry &entry = table[index(pc)];
+
+    // Never seen this LLL, give it a chance
+    if (!entry.valid || entry.tag != tag(pc)) {
+        DPRINTF(RunaheadEntryPredictor, "[tid:%i] No prediction for PC %#x, allowing entry.\n",
+                tid, pc);
+        stats.misses++;
+        predictedUseful[tid] = true;
+        return Allow;
+    }
+
+    if (entry.confidence >= threshold) {
+        DPRINTF(RunaheadEntryPredictor, "[tid:%i] PC %#x has confidence %i, allowing entry.\n",
+                tid, pc, (unsigned)entry.confidence);
+        predictedUseful[tid] = true;
+        return Allow;
+    }
+
+    // Let an instance through every now and then so the entry can recover
+    if (probeInterval > 0 && ++entry.vetoes >= probeInterval) {
+        DPRINTF(RunaheadEntryPredictor, "[tid:%i] PC %#x was vetoed %i times, probing.\n",
+                tid, pc, entry.vetoes);
+        entry.vetoes = 0;
+        stats.probes++;
+        predictedUseful[tid] = false;
+        return Allow;
+    }
+
+    DPRINTF(RunaheadEntryPredictor, "[tid:%i] PC %#x has confidence %i, vetoing entry.\n",
+            tid, pc, (unsigned)entry.confidence);
+    lastVetoed[tid] = seq_num;
+    stats.vetoes++;
+    return Veto;
+}
+
+void
+RunaheadEntryPredictor::train(ThreadID tid, Addr pc, unsigned lllsGenerated, unsigned validLoads)
+{
+    if (!enabled)
+        return;
+
+    bool useful = lllsGenerated >= minLLLs && validLoads >= minValidLoads;
+    Entry &entry = table[index(pc)];
+
+    // Replace whatever was in the entry
+    if (!entry.valid || entry.tag != tag(pc)) {
+        entry.valid = true;
+        entry.tag = tag(pc);
+        entry.confidence.reset();
+        for (unsigned i = 0; i < initialConfidence; i++)
+            entry.confidence++;
+    }
+
+    if (useful) {
+        entry.confidence++;
+        stats.usefulPeriods++;
+    } else {
+        entry.confidence--;
+        stats.uselessPeriods++;
+    }
+    entry.vetoes = 0;
+
+    if (predictedUseful[tid]) {
+        stats.predictedUseful++;
+        if (useful)
+            stats.correctPredictions++;
+    }
+    predictedUseful[tid] = false;
+
+    DPRINTF(RunaheadEntryPredictor, "[tid:%i] Period caused by PC %#x was %s "
+            "(%i LLLs, %i valid loads). Confidence is now %i.\n",
+            tid, pc, useful ? "useful" : "useless", lllsGenerated, validLoads,
+            (unsigned)entry.confidence);
+}
+
+RunaheadEntryPredictor::EntryPredictorStats::EntryPredictorStats(CPU *cpu)
+    : statistics::Group(cpu, "entrypredictor"),
+      ADD_STAT(lookups, statistics::units::Count::get(),
+           "Number of runahead entry predictor lookups"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+           "Number of lookups for LLLs not in the entry predictor"),
+      ADD_STAT(vetoes, statistics::units::Count::get(),
+           "Number of LLL instances vetoed by the entry predictor"),
+      ADD_STAT(probes, statistics::units::Count::get(),
+           "Number of vetoed runahead entries let through to retrain the predictor"),
+      ADD_STAT(usefulPeriods, statistics::units::Count::get(),
+           "Number of runahead periods trained as useful"),
+      ADD_STAT(uselessPeriods, statistics::units::Count::get(),
+           "Number of runahead periods trained as useless"),
+      ADD_STAT(predictedUseful, statistics::units::Count::get(),
+           "Number of runahead periods predicted useful"),
+      ADD_STAT(correctPredictions, statistics::units::Count::get(),
+           "Number of runahead periods predicted useful that turned out useful"),
+      ADD_STAT(accuracy, statistics::units::Ratio::get(),
+           "Fraction of runahead periods predicted useful that turned out useful",
+           correctPredictions / predictedUseful)
+{
+    accuracy.precision(6);
+}
+
+} // namespace runahead
+} // namespace gem5
@@ -0,0 +1,157 @@
+#ifndef __CPU_RUNAHEAD_ENTRY_PREDICTOR_HH__
+#define __CPU_RUNAHEAD_ENTRY_PREDICTOR_HH__
+
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/runahead/limits.hh"
+
+namespace gem5
+{
+
+struct BaseRunaheadCPUParams;
+
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * PC-indexed confidence table used to veto runahead entry for LLLs that
+ * historically cause useless runahead periods.
+ *
+ * Every runahead period trains the entry of the LLL that caused it. A period is useful
+ * if it generated enough new LLLs (L3 misses) and pseudoretired enough valid loads.
+ * Useful periods increment the entry's confidence, useless periods decrement it.
+ * Entry is vetoed while the confidence of the LLL's entry is below the threshold.
+ *
+ * A vetoed LLL would never train its entry again, so every so often a vetoed LLL
+ * is let through anyway to probe whether runahead has become useful for it.
+ * Commit asks again every cycle the LLL waits at the ROB head, so each dynamic
+ * instance of the LLL is vetoed, and counts towards the probe interval, only once.
+ */
+class RunaheadEntryPredictor
+{
+  private:
+    struct Entry
+    {
+        /** Partial tag of the LLL PC */
+        Addr tag = 0;
+        /** Whether or not the entry is in use */
+        bool valid = false;
+        /** Confidence that runahead is useful for this LLL */
+        SatCounter8 confidence;
+        /** Amount of vetoed instances of this LLL since its last period */
+        unsigned vetoes = 0;
+
+        Entry(unsigned counterBits, unsigned initial) : confidence(counterBits, initial) {}
+    };
+
+    /** Pointer to the CPU */
+    CPU *cpu;
+
+    /** Whether or not the predictor is enabled */
+    bool enabled;
+
+    /** Confidence table, direct mapped */
+    std::vector<Entry> table;
+
+    /** Mask to turn a PC hash into a table index */
+    const Addr indexMask;
+
+    /** Mask to cut the tag to the configured amount of bits */
+    const Addr tagMask;
+
+    /** Entry is vetoed when confidence is below this */
+    const unsigned threshold;
+
+    /** Initial confidence of new entries */
+    const unsigned initialConfidence;
+
+    /** A vetoed LLL is let through after this many vetoes */
+    const unsigned probeInterval;
+
+    /** A period must generate at least this many new LLLs to be useful */
+    const unsigned minLLLs;
+
+    /** A period must pseudoretire at least this many valid loads to be useful */
+    const unsigned minValidLoads;
+
+    /** Number of index bits */
+    const unsigned indexBits;
+
+    Addr index(Addr pc) const { return (pc ^ (pc >> indexBits)) & indexMask; }
+    Addr tag(Addr pc) const { return (pc >> indexBits) & tagMask; }
+
+    /** Whether or not the current period of each thread was predicted useful */
+    bool predictedUseful[MaxThreads];
+
+    /** Sequence number of the last LLL vetoed per thread */
+    InstSeqNum lastVetoed[MaxThreads];
+
+    /** Whether or not the given LLL instance was already vetoed */
+    bool vetoed(ThreadID tid, InstSeqNum seq_num) const
+    { return lastVetoed[tid] == seq_num; }
+
+  public:
+    /** Outcome of an entry prediction */
+    enum Decision
+    {
+        /** Runahead may be entered */
+        Allow,
+        /** Entry is vetoed for this LLL instance */
+        Veto,
+        /** Entry was already vetoed for this LLL instance by an earlier call */
+        StillVetoed
+    };
+
+    RunaheadEntryPredictor(CPU *_cpu, const BaseRunaheadCPUParams &params);
+
+    /** Returns the name of the entry predictor */
+    std::string name() const;
+
+    /** Whether or not the predictor is enabled */
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * Whether or not runahead should be entered for the LLL with the given PC and
+     * sequence number. Only call this when runahead would otherwise be entered.
+     */
+    Decision allowEntry(ThreadID tid, Addr pc, InstSeqNum seq_num);
+
+    /** Train the predictor on the outcome of the runahead period caused by the LLL at pc */
+    void train(ThreadID tid, Addr pc, unsigned lllsGenerated, unsigned validLoads);
+
+  private:
+    struct EntryPredictorStats : public statistics::Group
+    {
+        EntryPredictorStats(CPU *cpu);
+
+        /** Number of predictor lookups */
+        statistics::Scalar lookups;
+        /** Number of lookups that did not find the LLL in the table */
+        statistics::Scalar misses;
+        /** Number of LLL instances vetoed */
+        statistics::Scalar vetoes;
+        /** Number of vetoed entries let through to probe */
+        statistics::Scalar probes;
+        /** Number of periods trained as useful */
+        statistics::Scalar usefulPeriods;
+        /** Number of periods trained as useless */
+        statistics::Scalar uselessPeriods;
+        /** Number of periods allowed because they were predicted useful, i.e. not probes */
+        statistics::Scalar predictedUseful;
+        /** Number of periods predicted useful that turned out useful */
+        statistics::Scalar correctPredictions;
+        /** Fraction of periods predicted useful that turned out useful */
+        statistics::Formula accuracy;
+    } stats;
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_ENTRY_PREDICTOR_HH__
@@ -0,0 +1,149 @@
+#include "cpu/runahead/exit_policy.hh"
+
+#include "cpu/runahead/commit.hh"
+#include "cpu/runahead/cpu.hh"
+#include "cpu/runahead/dyn_inst.hh"
+#include "cpu/runahead/rob.hh"
+#include "debug/RunaheadCommit.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+ExitPolicy::Decision
+EagerExitPolicy::lllReturned(ThreadID tid, const DynInstPtr &lll)
+{
+    DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead ASAP due to eager exit policy.\n",
+            tid);
+    return ExitEager;
+}
+
+MinimumWorkExitPolicy::MinimumWorkExitPolicy(const Params &p)
+    : ExitPolicy(p), minWork(p.minWork)
+{}
+
+ExitPolicy::Decision
+MinimumWorkExitPolicy::lllReturned(ThreadID tid, const DynInstPtr &lll)
+{
+    if (commit->instsPseudoretired[tid] >= minWork) {
+        DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead now because minimum work has been done.\n",
+                tid);
+        return ExitMinWork;
+    }
+
+    DPRINTF(RunaheadCommit, "[tid:%i] %llu/%llu insts have been pseudoretired. Runahead will exit later.\n",
+            tid, commit->instsPseudoretired[tid], minWork);
+    return Stay;
+}
+
+ExitPolicy::Decision
+MinimumWorkExitPolicy::update(ThreadID tid)
+{
+    if (commit->instsPseudoretired[tid] >= minWork) {
+        DPRINTF(RunaheadCommit,
+                "[tid:%i] Exiting runahead because minimum work has been done.\n",
+                tid);
+        return ExitMinWork;
+    }
+
+    DPRINTF(RunaheadCommit,
+            "[tid:%i] %llu/%llu insts pseudoretired towards runahead exit.\n",
+            tid, commit->instsPseudoretired[tid], minWork);
+    return Stay;
+}
+
+NLLBExitPolicy::NLLBExitPolicy(const Params &p)
+    : ExitPolicy(p)
+{
+    for (ThreadID tid = 0; tid < MaxThreads; tid++)
+        exitSeqNum[tid] = 0;
+}
+
+ExitPolicy::Decision
+NLLBExitPolicy::lllReturned(ThreadID tid, const DynInstPtr &lll)
+{
+    DPRINTF(RunaheadCommit, "[tid:%i] Inspecting ROB for unsent loads.\n", tid);
+
+    InstSeqNum loadSn = rob->findUnsentValidLoad(tid);
+    if (!loadSn) {
+        DPRINTF(RunaheadCommit, "Unable to find any unsent loads, exiting ASAP.\n");
+        return ExitEager;
+    }
+
+    InstSeqNum instsToPseudoRetire = loadSn - rob->readHeadInst(tid)->seqNum;
+    DPRINTF(RunaheadCommit, "Youngest load in ROB has sn:%llu, which is %llu insts away.\n",
+            loadSn, instsToPseudoRetire);
+
+    exitSeqNum[tid] = loadSn;
+    return Stay;
+}
+
+ExitPolicy::Decision
+NLLBExitPolicy::update(ThreadID tid)
+{
+    if (!exitSeqNum[tid])
+        return Stay;
+
+    DynInstPtr loadInst = rob->findInst(tid, exitSeqNum[tid]);
+    // Could've been squashed or something
+    if (!loadInst) {
+        DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead because the exit-after load in the ROB disappeared.\n", tid);
+        return ExitDynamic;
+    } else if (loadInst->isExecuted()) {
+        DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead because the exit-after load was executed.\n", tid);
+        return ExitDynamic;
+    }
+
+    if (rob->countInsts(tid) == 0) {
+        DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead because the ROB is empty\n", tid);
+        return ExitDynamic;
+    }
+
+    // I don't think this should happen?
+    InstSeqNum oldestInst = rob->readHeadInst(tid)->seqNum;
+    if (oldestInst > exitSeqNum[tid]) {
+        DPRINTF(RunaheadCommit, "[tid:%i] Exiting runahead because the ROB head is too young.\n", tid);
+        return ExitDynamic;
+    }
+
+    InstSeqNum instsToExit = exitSeqNum[tid] - oldestInst;
+    DPRINTF(RunaheadCommit, "[tid:%i] Runahead will exit in %llu insts.\n", tid, instsToExit);
+    return Stay;
+}
+
+DynamicDelayedExitPolicy::DynamicDelayedExitPolicy(const Params &p)
+    : ExitPolicy(p), loadSearchLimit(p.loadSearchLimit)
+{}
+
+ExitPolicy::Decision
+DynamicDelayedExitPolicy::lllReturned(ThreadID tid, const DynInstPtr &lll)
+{
+    DPRINTF(RunaheadCommit, "[tid:%i] Inspecting ROB for nearby loads.\n", tid);
+
+    // First of all, make sure we even worked through the insts in the ROB on entry
+    if (commit->instsPseudoretired[tid] < commit->robInstsOnEntry()) {
+        DPRINTF(RunaheadCommit, "[tid:%i] Runahead did not clear the ROB, exiting ASAP.\n", tid);
+        return ExitEager;
+    }
+
+    // Check if there's an unsent, valid load near the ROB head
+    InstSeqNum loadSn = rob->findUnsentValidLoad(tid, loadSearchLimit);
+    if (!loadSn) {
+        DPRINTF(RunaheadCommit, "No nearby unsent loads in the ROB, exiting ASAP.\n");
+        return ExitEager;
+    }
+
+    DPRINTF(RunaheadCommit, "[tid:%i] Checking that we have a runahead chain.\n", tid);
+    // Default to true so we delay even if we're not using filtered runahead
+    bool hasChain = cpu->usingFilteredRunahead() ? (cpu->runaheadChainSize(tid) > 0) : true;
+    if (!hasChain) {
+        DPRINTF(RunaheadCommit, "[tid:%i] Not executing a chain, exiting ASAP.\n", tid);
+        return ExitEager;
+    }
+
+    return Stay;
+}
+
+} // namespace runahead
+} // namespace gem5
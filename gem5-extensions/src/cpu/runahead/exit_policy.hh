@@ -0,0 +1,149 @@
+#ifndef __CPU_RUNAHEAD_EXIT_POLICY_HH__
+#define __CPU_RUNAHEAD_EXIT_POLICY_HH__
+
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/runahead/dyn_inst_ptr.hh"
+#include "cpu/runahead/limits.hh"
+#include "params/DynamicDelayedExitPolicy.hh"
+#include "params/EagerExitPolicy.hh"
+#include "params/MinimumWorkExitPolicy.hh"
+#include "params/NLLBExitPolicy.hh"
+#include "params/RunaheadExitPolicy.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+class CPU;
+class Commit;
+class ROB;
+
+/**
+ * Decides when a thread leaves runahead once the LLL that caused it has returned.
+ *
+ * Commit calls into the policy through a set of hooks, and acts on the returned decision.
+ * The hooks are only called while the thread is exitable (the LLL has returned) and
+ * is not already exiting, except for lllReturned which makes the thread exitable.
+ * The runahead exit deadline is enforced by commit regardless of the policy.
+ */
+class ExitPolicy : public SimObject
+{
+  public:
+    /** What commit should do with the thread */
+    enum Decision
+    {
+        /** Keep running ahead */
+        Stay,
+        /** Exit because there was no reason to stay */
+        ExitEager,
+        /** Exit because enough work was done */
+        ExitMinWork,
+        /** Exit because the policy's dynamic condition was met */
+        ExitDynamic,
+    };
+
+  protected:
+    /** Pointer to the CPU */
+    CPU *cpu = nullptr;
+
+    /** Pointer to the commit stage */
+    Commit *commit = nullptr;
+
+    /** Pointer to the ROB */
+    ROB *rob = nullptr;
+
+  public:
+    typedef RunaheadExitPolicyParams Params;
+    ExitPolicy(const Params &p) : SimObject(p) {}
+
+    /** Give the policy access to the pipeline it makes decisions for */
+    void
+    setPipeline(CPU *_cpu, Commit *_commit, ROB *_rob)
+    {
+        cpu = _cpu;
+        commit = _commit;
+        rob = _rob;
+    }
+
+    /** A thread entered runahead. Reset any per-period state */
+    virtual void enteredRunahead(ThreadID tid) {}
+
+    /** The LLL that caused runahead returned, making the thread exitable */
+    virtual Decision lllReturned(ThreadID tid, const DynInstPtr &lll) = 0;
+
+    /** Called every cycle the thread is exitable but has not yet been told to exit */
+    virtual Decision update(ThreadID tid) { return Stay; }
+
+    /** A runahead instruction was pseudoretired while the thread was exitable */
+    virtual Decision pseudoretired(ThreadID tid, const DynInstPtr &inst) { return Stay; }
+};
+
+/** Exit as soon as the LLL returns. This is the traditional runahead exit. */
+class EagerExitPolicy : public ExitPolicy
+{
+  public:
+    typedef EagerExitPolicyParams Params;
+    EagerExitPolicy(const Params &p) : ExitPolicy(p) {}
+
+    Decision lllReturned(ThreadID tid, const DynInstPtr &lll) override;
+};
+
+/** Delay the exit until a minimum amount of instructions have been pseudoretired */
+class MinimumWorkExitPolicy : public ExitPolicy
+{
+  private:
+    /** Minimum insts to pseudoretire before exiting runahead */
+    const uint64_t minWork;
+
+  public:
+    typedef MinimumWorkExitPolicyParams Params;
+    MinimumWorkExitPolicy(const Params &p);
+
+    Decision lllReturned(ThreadID tid, const DynInstPtr &lll) override;
+    Decision update(ThreadID tid) override;
+};
+
+/**
+ * No Load Left Behind. Delay the exit until the youngest valid load in the ROB that
+ * has not yet been sent to memory has executed.
+ */
+class NLLBExitPolicy : public ExitPolicy
+{
+  private:
+    /** Seqnum of the load to exit after, 0 if none */
+    InstSeqNum exitSeqNum[MaxThreads];
+
+  public:
+    typedef NLLBExitPolicyParams Params;
+    NLLBExitPolicy(const Params &p);
+
+    void enteredRunahead(ThreadID tid) override { exitSeqNum[tid] = 0; }
+    Decision lllReturned(ThreadID tid, const DynInstPtr &lll) override;
+    Decision update(ThreadID tid) override;
+};
+
+/**
+ * Delay the exit if runahead worked through the ROB it started with, is executing a chain,
+ * and there is an unsent valid load nearby in the ROB. Otherwise exit immediately.
+ * A delayed exit happens at the runahead exit deadline.
+ */
+class DynamicDelayedExitPolicy : public ExitPolicy
+{
+  private:
+    /** Valid loads from the ROB head to look at for unsent ones, see ROB::findUnsentValidLoad() */
+    const int loadSearchLimit;
+
+  public:
+    typedef DynamicDelayedExitPolicyParams Params;
+    DynamicDelayedExitPolicy(const Params &p);
+
+    Decision lllReturned(ThreadID tid, const DynInstPtr &lll) override;
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_EXIT_POLICY_HH__
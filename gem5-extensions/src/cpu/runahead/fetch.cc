@@ -222,7 +222,17 @@ Fetch::FetchStatGroup::FetchStatGroup(CPU *cpu, Fetch *fetch)
     ADD_STAT(runaheadInstsToDecode, statistics::units::Count::get(),
              "Number of insts that were sent to decode in runahead"),
     ADD_STAT(runaheadChainLoops, statistics::units::Count::get(),
-             "Number of times fetch reset to the head of the runahead chain")
+             "Number of times fetch reset to the head of the runahead chain"),
+    ADD_STAT(runaheadChainCycles, statistics::units::Cycle::get(),
+             "Number of cycles fetch filtered the instruction stream to the runahead chain"),
+    ADD_STAT(runaheadChainRate, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Cycle>::get(),
+             "Number of runahead insts sent to decode per filtered runahead cycle",
+             runaheadInstsToDecode / runaheadChainCycles),
+    ADD_STAT(runaheadBufferGatedCycles, statistics::units::Cycle::get(),
+             "Number of cycles fetch was gated by the runahead buffer"),
+    ADD_STAT(runaheadThreadsDeprioritized, statistics::units::Count::get(),
+             "Number of times fetch picked a normal mode thread over a runahead thread")
 {
         icacheStallCycles
             .prereq(icacheStallCycles);
@@ -280,6 +290,14 @@ Fetch::FetchStatGroup::FetchStatGroup(CPU *cpu, Fetch *fetch)
             .prereq(runaheadInstsToDecode);
         runaheadChainLoops
             .prereq(runaheadChainLoops);
+        runaheadChainCycles
+            .prereq(runaheadChainCycles);
+        runaheadChainRate
+            .precision(6);
+        runaheadBufferGatedCycles
+            .prereq(runaheadBufferGatedCycles);
+        runaheadThreadsDeprioritized
+            .prereq(runaheadThreadsDeprioritized);
 
         icacheStallRealCycles.prereq(icacheStallRealCycles);
         tlbRealCycles.prereq(tlbRealCycles);
@@ -473,6 +491,32 @@ Fetch::isDrained() const
     return !finishTranslationEvent.scheduled();
 }
 
+bool
+Fetch::isStalled()
+{
+    assert(numThreads == 1);
+    ThreadID tid = activeThreads->front();
+
+    if (fetchStatus[tid] != Running || !stalls[tid].decode || stalls[tid].drain ||
+        interruptPending || fetchQueue[tid].size() < fetchQueueSize)
+        return false;
+
+    // Without an I-cache access to start, nothing changes until decode unblocks
+    Addr fetch_addr = (pc[tid]->instAddr() + fetchOffset[tid]) & decoder[tid]->pcMask();
+    return fetchBufferValid[tid] && fetchBufferAlignPC(fetch_addr) == fetchBufferPC[tid];
+}
+
+void
+Fetch::countStalledCycles(Cycles cycles)
+{
+    fetchStats.cycles += cycles;
+    fetchStats.nisnDist.sample(0, cycles);
+
+    // tick() draws the thread to send instructions from every cycle, keep later draws the same
+    for (uint64_t i = 0; i < cycles; i++)
+        random_mt.random<uint8_t>(0, activeThreads->size() - 1);
+}
+
 void
 Fetch::takeOverFrom()
 {
@@ -819,6 +863,9 @@ Fetch::squashFromDecode(const PCStateBase &new_pc, const DynInstPtr squashInst,
     // Tell the CPU to remove any instructions that are in flight between
     // fetch and decode.
     cpu->removeInstsUntil(seq_num, tid);
+
+    // Keep the sequence positions of runahead results in line with the refetched insts
+    cpu->resultReuseBuffer().squash(tid, seq_num, false);
 }
 
 bool
@@ -883,7 +930,13 @@ Fetch::squash(const PCStateBase &new_pc, const InstSeqNum seq_num,
     doSquash(new_pc, squashInst, tid);
 
     // Tell the CPU to remove any instructions that are not in the ROB.
-    cpu->removeInstsNotInROB(tid);
+    // Precise runahead insts are never in the ROB, so only remove those younger than the squash.
+    if (cpu->inPreciseRunahead(tid))
+        cpu->removeInstsUntil(seq_num, tid);
+    else
+        cpu->removeInstsNotInROB(tid);
+
+    cpu->resultReuseBuffer().squash(tid, seq_num, true);
 }
 
 void
@@ -906,6 +959,9 @@ Fetch::tick()
         // for each thread.
         bool updated_status = checkSignalsAndUpdate(tid);
         status_change =  status_change || updated_status;
+
+        if (cpu->runaheadChainInUse(tid) && !cpu->runaheadBufferActive(tid))
+            ++fetchStats.runaheadChainCycles;
     }
 
     DPRINTF(Fetch, "Running stage.\n");
@@ -962,7 +1018,10 @@ Fetch::tick()
         if (!stalls[tid].decode && !fetchQueue[tid].empty()) {
             const auto& inst = fetchQueue[tid].front();
 
-            if (!cpu->inRunahead(inst->threadNumber) || cpu->inRunaheadChain(inst)) {
+            // While the runahead buffer supplies rename, fetch is gated and drops its queue
+            bool send_inst = !cpu->inRunahead(inst->threadNumber) ||
+                (!cpu->runaheadBufferActive(inst->threadNumber) && cpu->inRunaheadChain(inst));
+            if (send_inst) {
                 toDecode->insts[toDecode->size++] = inst;
                 DPRINTF(Fetch, "[tid:%i] [sn:%llu] Sending instruction to decode "
                         "from fetch queue. Fetch queue size: %i.\n",
@@ -976,6 +1035,7 @@ Fetch::tick()
                 DPRINTF(RunaheadFetch, "[tid:%i] [sn:%llu] Inst was not in the runahead chain, discarding.\n",
                         tid, inst->seqNum);
                 fetchStats.discardedRunaheadInsts++;
+                cpu->resultReuseBuffer().filtered(tid, inst->seqNum);
                 cpu->removeInst(inst);
             }
 
@@ -1119,6 +1179,7 @@ Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
     DynInst::Arrays arrays;
     arrays.numSrcs = staticInst->numSrcRegs();
     arrays.numDests = staticInst->numDestRegs();
+    arrays.allocator = &cpu->dynInstAllocator;
 
     // Create a new DynInst from the instruction fetched.
     DynInstPtr instruction = new (arrays) DynInst(
@@ -1153,7 +1214,7 @@ Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
 #endif
 
     // Add instruction to the CPU's list of instructions.
-    instruction->setInstListIt(cpu->addInst(instruction));
+    instruction->setWindowPos(cpu->addInst(instruction));
 
     // Write the instruction to the first slot in the queue
     // that heads to decode.
@@ -1191,6 +1252,13 @@ Fetch::fetch(bool &status_change)
         return;
     }
 
+    // The runahead buffer supplies instructions in place of fetch, so don't fetch at all
+    if (cpu->runaheadBufferActive(tid)) {
+        DPRINTF(RunaheadFetch, "[tid:%i] Runahead buffer is active, fetch is gated.\n", tid);
+        ++fetchStats.runaheadBufferGatedCycles;
+        return;
+    }
+
     DPRINTF(Fetch, "Attempting to fetch from [tid:%i]\n", tid);
 
     // The current PC.
@@ -1379,7 +1447,7 @@ Fetch::fetch(bool &status_change)
                 DPRINTF(Fetch, "Branch detected with PC = %s\n", this_pc);
             }
 
-            if (cpu->isEndOfRunaheadChain(this_pc))
+            if (cpu->isEndOfRunaheadChain(tid, this_pc))
                 fetchStats.runaheadChainLoops++;
 
             newMacro |= this_pc.instAddr() != next_pc->instAddr();
@@ -1476,18 +1544,37 @@ ThreadID
 Fetch::getFetchingThread()
 {
     if (numThreads > 1) {
+        ThreadID tid;
         switch (fetchPolicy) {
           case SMTFetchPolicy::RoundRobin:
-            return roundRobin();
+            tid = roundRobin();
+            break;
           case SMTFetchPolicy::IQCount:
-            return iqCount();
+            tid = iqCount();
+            break;
           case SMTFetchPolicy::LSQCount:
-            return lsqCount();
+            tid = lsqCount();
+            break;
           case SMTFetchPolicy::Branch:
-            return branchCount();
+            tid = branchCount();
+            break;
           default:
             return InvalidThreadID;
         }
+
+        // Let a thread in runahead fetch only if no normal mode thread can
+        if (cpu->deprioritizeRunaheadThreads() && tid != InvalidThreadID &&
+            cpu->inRunahead(tid)) {
+            ThreadID normal_tid = normalModeThread();
+            if (normal_tid != InvalidThreadID) {
+                DPRINTF(RunaheadFetch, "[tid:%i] Deprioritizing runahead thread, "
+                        "fetching from [tid:%i] instead.\n", tid, normal_tid);
+                ++fetchStats.runaheadThreadsDeprioritized;
+                return normal_tid;
+            }
+        }
+
+        return tid;
     } else {
         std::list<ThreadID>::iterator thread = activeThreads->begin();
         if (thread == activeThreads->end()) {
@@ -1507,6 +1594,22 @@ Fetch::getFetchingThread()
 }
 
 
+ThreadID
+Fetch::normalModeThread()
+{
+    for (ThreadID tid : *activeThreads) {
+        if (cpu->inRunahead(tid))
+            continue;
+
+        if (fetchStatus[tid] == Running ||
+            fetchStatus[tid] == IcacheAccessComplete ||
+            fetchStatus[tid] == Idle)
+            return tid;
+    }
+
+    return InvalidThreadID;
+}
+
 ThreadID
 Fetch::roundRobin()
 {
@@ -243,6 +243,15 @@ class Fetch
     /** Has the stage drained? */
     bool isDrained() const;
 
+    /**
+     * Whether or not fetch only counts stall stats until something wakes the CPU:
+     * its queue is full and decode is blocked, with the fetch buffer holding the PC.
+     */
+    bool isStalled();
+
+    /** Count the stats of cycles the CPU skipped while fetch was stalled */
+    void countStalledCycles(Cycles cycles);
+
     /** Takes over from another CPU's thread. */
     void takeOverFrom();
 
@@ -372,6 +381,9 @@ class Fetch
     /** Returns the appropriate thread to fetch, given the fetch policy. */
     ThreadID getFetchingThread();
 
+    /** Returns the first fetchable thread that is not in runahead, if any. */
+    ThreadID normalModeThread();
+
     /** Returns the appropriate thread to fetch using a round robin policy. */
     ThreadID roundRobin();
 
@@ -605,6 +617,14 @@ class Fetch
         statistics::Scalar runaheadInstsToDecode;
         /** Number of times fetch reset to the head of the runahead chain */
         statistics::Scalar runaheadChainLoops;
+        /** Number of cycles fetch filtered the instruction stream to the runahead chain */
+        statistics::Scalar runaheadChainCycles;
+        /** Runahead insts sent to decode per filtered cycle, comparable to the runahead buffer */
+        statistics::Formula runaheadChainRate;
+        /** Number of cycles fetch was gated because the runahead buffer was active */
+        statistics::Scalar runaheadBufferGatedCycles;
+        /** Number of times a normal mode thread was picked over a runahead thread (SMT) */
+        statistics::Scalar runaheadThreadsDeprioritized;
     } fetchStats;
 };
 
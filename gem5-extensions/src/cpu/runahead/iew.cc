@@ -57,6 +57,7 @@
 #include "debug/Drain.hh"
 #include "debug/IEW.hh"
 #include "debug/RunaheadIEW.hh"
+#include "debug/RunaheadPoison.hh"
 #include "debug/O3PipeView.hh"
 #include "params/BaseRunaheadCPU.hh"
 
@@ -398,6 +399,36 @@ IEW::isDrained() const
     return drained;
 }
 
+bool
+IEW::isStalled()
+{
+    assert(numThreads == 1);
+    ThreadID tid = activeThreads->front();
+    if (exeStatus != Idle || updateLSQNextCycle || !insts[tid].empty() ||
+        (dispatchStatus[tid] != Running && dispatchStatus[tid] != Idle &&
+         dispatchStatus[tid] != Blocked))
+        return false;
+
+    if (!instQueue.isStalled() || ldstQueue.hasStoresToWB() || ldstQueue.willWB())
+        return false;
+
+    // Early LLL detection polls the depth of in-flight loads every cycle
+    return !cpu->usingEarlyLLLDetection() || !ldstQueue.pendingLLLDetection();
+}
+
+void
+IEW::countStalledCycles(Cycles cycles)
+{
+    assert(numThreads == 1);
+    ThreadID tid = activeThreads->front();
+    if (dispatchStatus[tid] == Blocked)
+        iewStats.blockCycles += cycles;
+
+    // Read by updateStatus() every cycle
+    instQueue.iqIOStats.intInstQueueReads += cycles;
+    instQueue.countStalledCycles(cycles);
+}
+
 void
 IEW::drainSanityCheck() const
 {
@@ -981,6 +1012,33 @@ IEW::dispatchInsts(ThreadID tid)
             continue;
         }
 
+        // Precise runahead insts never reach the ROB head, so insts that wait for commit can not run.
+        // Poison them instead, writeback then poisons their destinations and wakes dependents.
+        if (inst->isRunahead() && cpu->usingPreciseRunahead() &&
+            (inst->isNonSpeculative() || inst->isAtomic() || inst->isStoreConditional() ||
+             inst->isReadBarrier() || inst->isWriteBarrier())) {
+            DPRINTF(RunaheadIEW, "[sn:%llu] Precise runahead inst PC %s must wait for commit. "
+                    "Poisoning.\n", inst->seqNum, inst->pcState());
+
+            inst->setPoisoned();
+            inst->setIssued();
+            inst->setExecuted();
+            inst->setCanCommit();
+            instQueue.recordProducer(inst);
+            instToCommit(inst);
+
+            ++iewStats.executedInstStats.numNonSpecRunaheadInsts;
+
+            insts_to_dispatch.pop();
+            if (inst->isLoad())
+                toRename->iewInfo[tid].dispatchedToLQ++;
+            if (inst->isStore() || inst->isAtomic())
+                toRename->iewInfo[tid].dispatchedToSQ++;
+            toRename->iewInfo[tid].dispatched++;
+            ++iewStats.dispatchedInsts;
+            continue;
+        }
+
         // Check for full conditions.
         if (instQueue.isFull(tid)) {
             DPRINTF(IEW, "[tid:%i] Issue: IQ has become full.\n", tid);
@@ -1358,7 +1416,8 @@ IEW::executeInsts()
             // Such case can happen when it faulted during ITLB translation.
             // If we execute the instruction (even if it's a nop) the fault
             // will be replaced and we will lose it.
-            if (inst->getFault() == NoFault) {
+            // Reused ops had their results written when they issued.
+            if (inst->getFault() == NoFault && !inst->isReused()) {
                 inst->execute();
                 if (!inst->readPredicate())
                     inst->forwardOldRegs();
@@ -1517,11 +1576,15 @@ IEW::writebackInsts()
                                 "[sn:%llu] Poisoning destination register %i (%s) (flat:%i)\n",
                                 inst->seqNum, destReg->index(),
                                 destReg->className(), destReg->flatIndex());
+                        DPRINTF(RunaheadPoison, "[sn:%llu] PC %s -> %s reg %i (flat: %i)\n",
+                                inst->seqNum, inst->pcState(), destReg->className(),
+                                destReg->index(), destReg->flatIndex());
                         cpu->regPoisoned(destReg, true);
                     } else if (destReg->classValue() != MiscRegClass) {
                         // And "cure" the register if the instruction was valid
                         cpu->regPoisoned(destReg, false);
                     }
+                    cpu->regPredicted(destReg, inst->isPredicted() && !inst->isPoisoned());
                 }
             }
 
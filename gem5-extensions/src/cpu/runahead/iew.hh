@@ -166,6 +166,15 @@ class IEW
     /** Has the stage drained? */
     bool isDrained() const;
 
+    /**
+     * Whether or not IEW has nothing to dispatch, issue, execute or write
+     * back until something wakes the CPU.
+     */
+    bool isStalled();
+
+    /** Count the stats of cycles the CPU skipped while IEW was stalled */
+    void countStalledCycles(Cycles cycles);
+
     /** Takes over from another CPU's thread. */
     void takeOverFrom();
 
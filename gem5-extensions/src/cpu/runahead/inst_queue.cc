@@ -50,6 +50,7 @@
 #include "cpu/runahead/limits.hh"
 #include "debug/IQ.hh"
 #include "debug/RunaheadIQ.hh"
+#include "debug/RunaheadPoison.hh"
 #include "enums/OpClass.hh"
 #include "params/BaseRunaheadCPU.hh"
 #include "sim/core.hh"
@@ -90,7 +91,11 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
     : cpu(cpu_ptr),
       iewStage(iew_ptr),
       fuPool(params.fuPool),
+      ageMatrix(params.numIQEntries),
+      useAgeMatrix(params.iqScheduler != "List"),
+      checkAgeMatrix(params.iqScheduler == "Check"),
       iqPolicy(params.smtIQPolicy),
+      smtRunaheadIQShare(params.smtRunaheadIQShare),
       numThreads(params.numThreads),
       numEntries(params.numIQEntries),
       totalWidth(params.issueWidth),
@@ -111,9 +116,20 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
                     params.numPhysVecPredRegs +
                     params.numPhysCCRegs;
 
+    fatal_if(params.iqScheduler != "List" && params.iqScheduler != "AgeMatrix" &&
+             params.iqScheduler != "Check",
+             "Invalid IQ scheduler '%s'. Must be one of: List, AgeMatrix, Check.\n",
+             params.iqScheduler);
+    fatal_if(params.iqDependencyGraph != "Linked" && params.iqDependencyGraph != "Pooled",
+             "Invalid IQ dependency graph '%s'. Must be one of: Linked, Pooled.\n",
+             params.iqDependencyGraph);
+    fatal_if(params.iqDependencyGraph == "Pooled" && params.iqDependencyGraphSlots == 0,
+             "The pooled IQ dependency graph needs at least one slot per register.\n");
+
     //Create an entry for each physical register within the
     //dependency graph.
-    dependGraph.resize(numPhysRegs);
+    dependGraph.init(params.iqDependencyGraph == "Pooled", numPhysRegs,
+                     params.iqDependencyGraphSlots);
 
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
@@ -167,7 +183,7 @@ InstructionQueue::~InstructionQueue()
     dependGraph.reset();
 #ifdef DEBUG
     cprintf("Nodes traversed: %i, removed: %i\n",
-            dependGraph.nodesTraversed, dependGraph.nodesRemoved);
+            dependGraph.nodesTraversed(), dependGraph.nodesRemoved());
 #endif
 }
 
@@ -205,6 +221,9 @@ InstructionQueue::IQStats::IQStats(CPU *cpu, const unsigned &total_width)
              "removed from graph"),
     ADD_STAT(squashedNonSpecRemoved, statistics::units::Count::get(),
              "Number of squashed non-spec instructions that were removed"),
+    ADD_STAT(spilledDependents, statistics::units::Count::get(),
+             "Number of dependents that did not fit in the slots of their "
+             "register in the pooled dependency graph"),
     ADD_STAT(numIssuedDist, statistics::units::Count::get(),
              "Number of insts issued each cycle"),
     ADD_STAT(statFuBusy, statistics::units::Count::get(),
@@ -254,6 +273,9 @@ InstructionQueue::IQStats::IQStats(CPU *cpu, const unsigned &total_width)
 
     squashedNonSpecRemoved
         .prereq(squashedNonSpecRemoved);
+
+    spilledDependents
+        .prereq(spilledDependents);
 /*
     queueResDist
         .init(Num_OpClasses, 0, 99, 2)
@@ -421,6 +443,7 @@ InstructionQueue::resetState()
         queueOnList[i] = false;
         readyIt[i] = listOrder.end();
     }
+    ageMatrix.clear();
     nonSpecInsts.clear();
     listOrder.clear();
     deferredMemInsts.clear();
@@ -470,6 +493,25 @@ InstructionQueue::drainSanityCheck() const
         memDepUnit[tid].drainSanityCheck();
 }
 
+bool
+InstructionQueue::isStalled()
+{
+    // Blocked memory instructions wait for cacheUnblocked(), which wakes the
+    // CPU. FU completions wake it too, but after the tick of their cycle
+    // would have run, so don't skip while an op is in an FU.
+    return !hasReadyInsts() &&
+           instsToExecute.empty() &&
+           deferredMemInsts.empty() &&
+           retryMemInsts.empty() &&
+           wbOutstanding == 0;
+}
+
+void
+InstructionQueue::countStalledCycles(Cycles cycles)
+{
+    iqStats.numIssuedDist.sample(0, cycles);
+}
+
 void
 InstructionQueue::takeOverFrom()
 {
@@ -518,6 +560,12 @@ InstructionQueue::numFreeEntries()
 unsigned
 InstructionQueue::numFreeEntries(ThreadID tid)
 {
+    // Threads in runahead only get a share of their entries so co-runners keep progressing
+    if (numThreads > 1 && cpu->deprioritizeRunaheadThreads() && cpu->inRunahead(tid)) {
+        unsigned runahead_max = maxEntries[tid] * smtRunaheadIQShare / 100;
+        return count[tid] >= runahead_max ? 0 : runahead_max - count[tid];
+    }
+
     return maxEntries[tid] - count[tid];
 }
 
@@ -546,6 +594,9 @@ InstructionQueue::isFull(ThreadID tid)
 bool
 InstructionQueue::hasReadyInsts()
 {
+    if (useAgeMatrix)
+        return !ageMatrix.empty();
+
     if (!listOrder.empty()) {
         return true;
     }
@@ -725,6 +776,47 @@ InstructionQueue::moveToYoungerInst(ListOrderIt list_order_it)
     readyIt[op_class] = listOrder.insert(next_it, queue_entry);
 }
 
+InstructionQueue::ListOrderIt
+InstructionQueue::popReadyInst(OpClass op_class)
+{
+    ListOrderIt order_it = readyIt[op_class];
+
+    readyInsts[op_class].pop();
+
+    if (!readyInsts[op_class].empty()) {
+        moveToYoungerInst(order_it);
+    } else {
+        readyIt[op_class] = listOrder.end();
+        queueOnList[op_class] = false;
+    }
+
+    return listOrder.erase(order_it);
+}
+
+void
+InstructionQueue::addToReadyList(const DynInstPtr &inst)
+{
+    OpClass op_class = inst->opClass();
+
+    if (useAgeMatrix)
+        ageMatrix.insert(inst, op_class);
+
+    if (useAgeMatrix && !checkAgeMatrix)
+        return;
+
+    readyInsts[op_class].push(inst);
+
+    // Will need to reorder the list if either a queue is not on the list,
+    // or it has an older instruction than last time.
+    if (!queueOnList[op_class]) {
+        addToOrderList(op_class);
+    } else if (readyInsts[op_class].top()->seqNum  <
+               (*readyIt[op_class]).oldestInst) {
+        listOrder.erase(readyIt[op_class]);
+        addToOrderList(op_class);
+    }
+}
+
 void
 InstructionQueue::processFUCompletion(const DynInstPtr &inst, int fu_idx)
 {
@@ -766,6 +858,26 @@ InstructionQueue::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
+    int total_issued = useAgeMatrix ? scheduleFromAgeMatrix(i2e_info) :
+                                      scheduleFromList(i2e_info);
+
+    iqStats.numIssuedDist.sample(total_issued);
+    iqStats.instsIssued+= total_issued;
+
+    // If we issued any instructions, tell the CPU we had activity.
+    // @todo If the way deferred memory instructions are handeled due to
+    // translation changes then the deferredMemInsts condition should be
+    // removed from the code below.
+    if (total_issued || !retryMemInsts.empty() || !deferredMemInsts.empty()) {
+        cpu->activityThisCycle();
+    } else {
+        DPRINTF(IQ, "Not able to schedule any instructions.\n");
+    }
+}
+
+int
+InstructionQueue::scheduleFromList(IssueStruct *i2e_info)
+{
     // Have iterator to head of the list
     // While I haven't exceeded bandwidth or reached the end of the list,
     // Try to get a FU that can do what this op needs.
@@ -785,152 +897,194 @@ InstructionQueue::scheduleReadyInsts()
 
         DynInstPtr issuing_inst = readyInsts[op_class].top();
 
-        if (issuing_inst->isFloating()) {
-            iqIOStats.fpInstQueueReads++;
-        } else if (issuing_inst->isVector()) {
-            iqIOStats.vecInstQueueReads++;
-        } else {
-            iqIOStats.intInstQueueReads++;
-        }
-
         assert(issuing_inst->seqNum == (*order_it).oldestInst);
 
-        // If in runahead, check if any source regs are poisoned
-        if (issuing_inst->isRunahead()) {
-            for (int idx = 0; idx < issuing_inst->numSrcRegs(); idx++) {
-                PhysRegIdPtr reg = issuing_inst->renamedSrcIdx(idx);
-                // If so, poison the instruction
-                if (cpu->regPoisoned(reg)) {
-                    DPRINTF(RunaheadIQ, "[sn:%llu] Issuing instruction (PC %s) "
-                                        "was poisoned by source reg %i (flat: %i) (type: %s)\n",
-                                        issuing_inst->seqNum, issuing_inst->pcState(),
-                                        idx, reg->flatIndex(), reg->className());
-                    issuing_inst->setPoisoned();
-                    break;
-                }
-            }
+        IssueResult result = issueInst(issuing_inst, op_class, i2e_info);
+        if (result == IssueResult::NoFreeFU) {
+            ++order_it;
+            continue;
         }
 
-        if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
+        order_it = popReadyInst(op_class);
+        if (result == IssueResult::Issued)
+            ++total_issued;
+    }
 
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+    return total_issued;
+}
+
+int
+InstructionQueue::scheduleFromAgeMatrix(IssueStruct *i2e_info)
+{
+    // Same selection as the age order list: the oldest ready instruction of
+    // the op classes that did not run out of FUs this cycle.
+    int total_issued = 0;
+    ageMatrix.unblockAll();
+
+    // Walked like in scheduleFromList() when checking the age matrix
+    ListOrderIt order_it = listOrder.begin();
+
+    while (total_issued < totalWidth) {
+        int slot = ageMatrix.oldest();
+
+        if (checkAgeMatrix) {
+            bool list_done = order_it == listOrder.end();
+            panic_if((slot == AgeMatrix::NoSlot) != list_done ||
+                     (!list_done &&
+                      ageMatrix.inst(slot)->seqNum != (*order_it).oldestInst),
+                     "IQ age matrix selected [sn:%lli], age order list "
+                     "selected [sn:%lli].\n",
+                     slot == AgeMatrix::NoSlot ? 0 : ageMatrix.inst(slot)->seqNum,
+                     list_done ? 0 : (*order_it).oldestInst);
+        }
 
-            listOrder.erase(order_it++);
+        if (slot == AgeMatrix::NoSlot)
+            break;
 
-            ++iqStats.squashedInstsIssued;
+        DynInstPtr issuing_inst = ageMatrix.inst(slot);
+        OpClass op_class = ageMatrix.opClass(slot);
 
+        IssueResult result = issueInst(issuing_inst, op_class, i2e_info);
+        if (result == IssueResult::NoFreeFU) {
+            ageMatrix.block(op_class);
+            if (checkAgeMatrix)
+                ++order_it;
             continue;
         }
 
-        int idx = FUPool::NoCapableFU;
-        Cycles op_latency = Cycles(1);
-        ThreadID tid = issuing_inst->threadNumber;
+        ageMatrix.remove(slot);
+        if (checkAgeMatrix)
+            order_it = popReadyInst(op_class);
+        if (result == IssueResult::Issued)
+            ++total_issued;
+    }
 
-        if (op_class != No_OpClass) {
-            idx = fuPool->getUnit(op_class);
-            if (issuing_inst->isFloating()) {
-                iqIOStats.fpAluAccesses++;
-            } else if (issuing_inst->isVector()) {
-                iqIOStats.vecAluAccesses++;
-            } else {
-                iqIOStats.intAluAccesses++;
-            }
-            if (idx > FUPool::NoFreeFU) {
-                op_latency = fuPool->getOpLatency(op_class);
+    return total_issued;
+}
+
+InstructionQueue::IssueResult
+InstructionQueue::issueInst(const DynInstPtr &issuing_inst, OpClass op_class,
+                            IssueStruct *i2e_info)
+{
+    if (issuing_inst->isFloating()) {
+        iqIOStats.fpInstQueueReads++;
+    } else if (issuing_inst->isVector()) {
+        iqIOStats.vecInstQueueReads++;
+    } else {
+        iqIOStats.intInstQueueReads++;
+    }
+
+    // If in runahead, check if any source regs are poisoned
+    if (issuing_inst->isRunahead()) {
+        for (int idx = 0; idx < issuing_inst->numSrcRegs(); idx++) {
+            PhysRegIdPtr reg = issuing_inst->renamedSrcIdx(idx);
+            // If so, poison the instruction
+            if (cpu->regPoisoned(reg)) {
+                DPRINTF(RunaheadIQ, "[sn:%llu] Issuing instruction (PC %s) "
+                                    "was poisoned by source reg %i (flat: %i) (type: %s)\n",
+                                    issuing_inst->seqNum, issuing_inst->pcState(),
+                                    idx, reg->flatIndex(), reg->className());
+                DPRINTF(RunaheadPoison, "[sn:%llu] PC %s <- %s reg %i (flat: %i)\n",
+                                        issuing_inst->seqNum, issuing_inst->pcState(),
+                                        reg->className(), reg->index(), reg->flatIndex());
+                issuing_inst->setPoisoned();
+                break;
             }
+
+            // Values derived from value predicted loads are still valid, but track them
+            if (cpu->regPredicted(reg))
+                issuing_inst->setPredicted();
         }
+    }
 
-        // If we have an instruction that doesn't require a FU, or a
-        // valid FU, then schedule for execution.
-        if (idx != FUPool::NoFreeFU) {
-            if (op_latency == Cycles(1)) {
-                i2e_info->size++;
-                instsToExecute.push_back(issuing_inst);
-
-                // Add the FU onto the list of FU's to be freed next
-                // cycle if we used one.
-                if (idx >= 0)
-                    fuPool->freeUnitNextCycle(idx);
-            } else {
-                bool pipelined = fuPool->isPipelined(op_class);
-                // Generate completion event for the FU
-                ++wbOutstanding;
-                FUCompletion *execution = new FUCompletion(issuing_inst,
-                                                           idx, this);
-
-                cpu->schedule(execution,
-                              cpu->clockEdge(Cycles(op_latency - 1)));
-
-                if (!pipelined) {
-                    // If FU isn't pipelined, then it must be freed
-                    // upon the execution completing.
-                    execution->setFreeFU();
-                } else {
-                    // Add the FU onto the list of FU's to be freed next cycle.
-                    fuPool->freeUnitNextCycle(idx);
-                }
-            }
+    if (issuing_inst->isSquashed()) {
+        ++iqStats.squashedInstsIssued;
+        return IssueResult::Squashed;
+    }
 
-            DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
-                    "[sn:%llu]\n",
-                    tid, issuing_inst->pcState(),
-                    issuing_inst->seqNum);
+    int idx = FUPool::NoCapableFU;
+    Cycles op_latency = Cycles(1);
+    ThreadID tid = issuing_inst->threadNumber;
 
-            readyInsts[op_class].pop();
+    // Ops reusing a runahead result already have it, so they need no FU
+    if (op_class != No_OpClass && cpu->resultReuseBuffer().reuse(issuing_inst)) {
+        issuing_inst->setReused();
+        cpu->resultReuseBuffer().savedCycles(fuPool->getOpLatency(op_class));
+    } else if (op_class != No_OpClass) {
+        idx = fuPool->getUnit(op_class);
+        if (issuing_inst->isFloating()) {
+            iqIOStats.fpAluAccesses++;
+        } else if (issuing_inst->isVector()) {
+            iqIOStats.vecAluAccesses++;
+        } else {
+            iqIOStats.intAluAccesses++;
+        }
+        if (idx > FUPool::NoFreeFU) {
+            op_latency = fuPool->getOpLatency(op_class);
+        }
+    }
 
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
+    // If we have an instruction that doesn't require a FU, or a
+    // valid FU, then schedule for execution.
+    if (idx != FUPool::NoFreeFU) {
+        if (op_latency == Cycles(1)) {
+            i2e_info->size++;
+            instsToExecute.push_back(issuing_inst);
+
+            // Add the FU onto the list of FU's to be freed next
+            // cycle if we used one.
+            if (idx >= 0)
+                fuPool->freeUnitNextCycle(idx);
+        } else {
+            bool pipelined = fuPool->isPipelined(op_class);
+            // Generate completion event for the FU
+            ++wbOutstanding;
+            FUCompletion *execution = new FUCompletion(issuing_inst,
+                                                       idx, this);
+
+            cpu->schedule(execution,
+                          cpu->clockEdge(Cycles(op_latency - 1)));
+
+            if (!pipelined) {
+                // If FU isn't pipelined, then it must be freed
+                // upon the execution completing.
+                execution->setFreeFU();
             } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
+                // Add the FU onto the list of FU's to be freed next cycle.
+                fuPool->freeUnitNextCycle(idx);
             }
+        }
 
-            issuing_inst->setIssued();
-            ++total_issued;
+        DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
+                "[sn:%llu]\n",
+                tid, issuing_inst->pcState(),
+                issuing_inst->seqNum);
+
+        issuing_inst->setIssued();
 
 #if TRACING_ON
-            issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
+        issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
 #endif
 
-            if (issuing_inst->firstIssue == -1)
-                issuing_inst->firstIssue = curTick();
-
-            if (!issuing_inst->isMemRef()) {
-                // Memory instructions can not be freed from the IQ until they
-                // complete.
-                ++freeEntries;
-                count[tid]--;
-                issuing_inst->clearInIQ();
-            } else {
-                memDepUnit[tid].issue(issuing_inst);
-            }
+        if (issuing_inst->firstIssue == -1)
+            issuing_inst->firstIssue = curTick();
 
-            listOrder.erase(order_it++);
-            iqStats.statIssuedInstType[tid][op_class]++;
+        if (!issuing_inst->isMemRef()) {
+            // Memory instructions can not be freed from the IQ until they
+            // complete.
+            ++freeEntries;
+            count[tid]--;
+            issuing_inst->clearInIQ();
         } else {
-            iqStats.statFuBusy[op_class]++;
-            iqStats.fuBusy[tid]++;
-            ++order_it;
+            memDepUnit[tid].issue(issuing_inst);
         }
-    }
-
-    iqStats.numIssuedDist.sample(total_issued);
-    iqStats.instsIssued+= total_issued;
 
-    // If we issued any instructions, tell the CPU we had activity.
-    // @todo If the way deferred memory instructions are handeled due to
-    // translation changes then the deferredMemInsts condition should be
-    // removed from the code below.
-    if (total_issued || !retryMemInsts.empty() || !deferredMemInsts.empty()) {
-        cpu->activityThisCycle();
+        iqStats.statIssuedInstType[tid][op_class]++;
+        return IssueResult::Issued;
     } else {
-        DPRINTF(IQ, "Not able to schedule any instructions.\n");
+        iqStats.statFuBusy[op_class]++;
+        iqStats.fuBusy[tid]++;
+        return IssueResult::NoFreeFU;
     }
 }
 
@@ -1085,17 +1239,7 @@ InstructionQueue::addReadyMemInst(const DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
-    }
+    addToReadyList(ready_inst);
 
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
@@ -1380,7 +1524,8 @@ InstructionQueue::addToDependents(const DynInstPtr &new_inst)
                         new_inst->pcState(), src_reg->index(),
                         src_reg->className());
 
-                dependGraph.insert(src_reg->flatIndex(), new_inst);
+                if (dependGraph.insert(src_reg->flatIndex(), new_inst))
+                    ++iqStats.spilledDependents;
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1463,17 +1608,7 @@ InstructionQueue::addIfReady(const DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%llu].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        addToReadyList(inst);
     }
 }
 
@@ -1487,7 +1622,8 @@ void
 InstructionQueue::dumpLists()
 {
     for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        cprintf("Ready list %i size: %i\n", i, useAgeMatrix ?
+                ageMatrix.size((OpClass)i) : readyInsts[i].size());
 
         cprintf("\n");
     }
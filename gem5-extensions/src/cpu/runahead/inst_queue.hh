@@ -50,8 +50,9 @@
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
+#include "cpu/runahead/age_matrix.hh"
 #include "cpu/runahead/comm.hh"
-#include "cpu/runahead/dep_graph.hh"
+#include "cpu/runahead/pooled_dep_graph.hh"
 #include "cpu/runahead/dyn_inst_ptr.hh"
 #include "cpu/runahead/limits.hh"
 #include "cpu/runahead/mem_dep_unit.hh"
@@ -157,6 +158,12 @@ class InstructionQueue
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Whether or not nothing can issue or complete until the CPU is woken up. */
+    bool isStalled();
+
+    /** Count the stats of cycles the CPU skipped while the IQ was stalled. */
+    void countStalledCycles(Cycles cycles);
+
     /** Takes over execution from another CPU's thread. */
     void takeOverFrom();
 
@@ -405,7 +412,51 @@ class InstructionQueue
      */
     void moveToYoungerInst(ListOrderIt age_order_it);
 
-    DependencyGraph<DynInstPtr> dependGraph;
+    /**
+     * Removes the oldest instruction of an op class from its ready queue.
+     * Returns the age order list entry after the one of the op class.
+     */
+    ListOrderIt popReadyInst(OpClass op_class);
+
+    /** Ready instructions in an age matrix, used instead of the ready queues
+     *  and the age order list if useAgeMatrix is set.
+     */
+    AgeMatrix ageMatrix;
+
+    /** Whether or not the age matrix selects the instructions to issue. */
+    bool useAgeMatrix;
+
+    /** Whether or not to keep the ready queues next to the age matrix, and
+     *  panic if they select a different instruction.
+     */
+    bool checkAgeMatrix;
+
+    /** Outcome of trying to issue a ready instruction. */
+    enum class IssueResult
+    {
+        Issued,
+        Squashed,
+        NoFreeFU
+    };
+
+    /** Puts an instruction that is ready to issue onto the ready list. */
+    void addToReadyList(const DynInstPtr &inst);
+
+    /** Tries to issue the oldest ready instruction of an op class. */
+    IssueResult issueInst(const DynInstPtr &issuing_inst, OpClass op_class,
+                          IssueStruct *i2e_info);
+
+    /** Issues ready instructions in age order using the age order list.
+     *  Returns the number of instructions issued.
+     */
+    int scheduleFromList(IssueStruct *i2e_info);
+
+    /** Issues ready instructions in age order using the age matrix.
+     *  Returns the number of instructions issued.
+     */
+    int scheduleFromAgeMatrix(IssueStruct *i2e_info);
+
+    IQDependencyGraph<DynInstPtr> dependGraph;
 
     //////////////////////////////////////
     // Various parameters
@@ -414,6 +465,9 @@ class InstructionQueue
     /** IQ sharing policy for SMT. */
     SMTQueuePolicy iqPolicy;
 
+    /** Percentage of its entries a thread in runahead may use when runahead is deprioritized */
+    unsigned smtRunaheadIQShare;
+
     /** Number of Total Threads*/
     ThreadID numThreads;
 
@@ -505,6 +559,10 @@ class InstructionQueue
          *  a squash.
          */
         statistics::Scalar squashedNonSpecRemoved;
+        /** Stat for number of consumers that did not fit in the slots of
+         *  their register in the pooled dependency graph.
+         */
+        statistics::Scalar spilledDependents;
         // Also include number of instructions rescheduled and replayed.
 
         /** Distribution of number of instructions in the queue.
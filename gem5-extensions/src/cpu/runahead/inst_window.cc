@@ -0,0 +1,81 @@
+#include "cpu/runahead/inst_window.hh"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/intmath.hh"
+#include "cpu/runahead/dyn_inst.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+InstWindow::InstWindow(size_t capacity)
+    : slots((size_t)1 << ceilLog2(std::max<size_t>(capacity, 2))),
+      mask(slots.size() - 1)
+{
+}
+
+void
+InstWindow::grow()
+{
+    std::vector<DynInstPtr> grown(slots.size() * 2);
+    Pos grown_mask = grown.size() - 1;
+
+    for (Pos pos = head; pos < tail; pos++)
+        grown[pos & grown_mask] = std::move(slots[pos & mask]);
+
+    slots.swap(grown);
+    mask = grown_mask;
+}
+
+InstWindow::Pos
+InstWindow::push(const DynInstPtr &inst)
+{
+    if (tail - head == slots.size())
+        grow();
+
+    Pos pos = tail++;
+    slots[pos & mask] = inst;
+    occupied++;
+    return pos;
+}
+
+void
+InstWindow::cleanUp()
+{
+    for (Pos pos : removeList) {
+        // Instructions can be removed more than once before a clean up
+        if (pos < head || pos >= tail)
+            continue;
+
+        DynInstPtr &slot = slots[pos & mask];
+        if (!slot)
+            continue;
+
+        assert(slot->shouldRemove());
+        slot = nullptr;
+        occupied--;
+    }
+    removeList.clear();
+
+    while (head < tail && !slots[head & mask])
+        head++;
+    while (tail > head && !slots[(tail - 1) & mask])
+        tail--;
+}
+
+void
+InstWindow::clear()
+{
+    for (Pos pos = head; pos < tail; pos++)
+        slots[pos & mask] = nullptr;
+
+    head = tail;
+    occupied = 0;
+    removeList.clear();
+}
+
+} // namespace runahead
+} // namespace gem5
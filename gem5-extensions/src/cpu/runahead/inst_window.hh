@@ -0,0 +1,139 @@
+#ifndef __CPU_RUNAHEAD_INST_WINDOW_HH__
+#define __CPU_RUNAHEAD_INST_WINDOW_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cpu/runahead/dyn_inst_ptr.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+/**
+ * All instructions in flight in the CPU, oldest first, in a contiguous circular buffer.
+ *
+ * Every instruction gets a position when it is added: the position of the previous instruction
+ * plus one. The slot of a position is the position modulo the capacity, so an instruction is
+ * found from its position in constant time. Sequence numbers can not be used for this, as fetch
+ * skips the sequence numbers of squashed instructions.
+ *
+ * Removing an instruction only queues its position. The queued slots are emptied at the end of
+ * the cycle, after which empty slots at either end of the window are given back. Slots in the
+ * middle, left by another thread, are given back once the window drains up to them. Squashes
+ * give back the young end, so the positions of squashed instructions are handed out again, and
+ * a position only identifies an instruction while contains() says so.
+ * The buffer doubles when it runs out of slots.
+ */
+class InstWindow
+{
+  public:
+    typedef uint64_t Pos;
+
+    /** Walks the instructions in the window from oldest to youngest, skipping empty slots */
+    class const_iterator
+    {
+      private:
+        const InstWindow *window;
+        Pos pos;
+
+        void
+        skipEmpty()
+        {
+            while (pos < window->tail && !window->at(pos))
+                pos++;
+        }
+
+      public:
+        const_iterator(const InstWindow *_window, Pos _pos)
+            : window(_window), pos(_pos)
+        {
+            skipEmpty();
+        }
+
+        const DynInstPtr &operator*() const { return window->at(pos); }
+
+        const_iterator &
+        operator++()
+        {
+            pos++;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator!=(const const_iterator &other) const { return pos != other.pos; }
+    };
+
+  private:
+    /** Slots, the amount of them is always a power of 2 */
+    std::vector<DynInstPtr> slots;
+
+    /** Mask to turn a position into a slot index */
+    Pos mask;
+
+    /** Position of the oldest slot in use */
+    Pos head = 0;
+
+    /** Position the next instruction will get */
+    Pos tail = 0;
+
+    /** Amount of slots holding an instruction */
+    size_t occupied = 0;
+
+    /** Positions to empty at the next clean up */
+    std::vector<Pos> removeList;
+
+    /** Double the amount of slots, moving every position to its new slot */
+    void grow();
+
+  public:
+    /** Create a window of at least the given amount of slots */
+    explicit InstWindow(size_t capacity);
+
+    /** Add an instruction as the youngest, returns its position */
+    Pos push(const DynInstPtr &inst);
+
+    /** The instruction at a position, empty if it was removed */
+    const DynInstPtr &at(Pos pos) const { return slots[pos & mask]; }
+
+    /** Whether or not the instruction is in the window at the given position */
+    bool
+    contains(Pos pos, const DynInstPtr &inst) const
+    {
+        return pos >= head && pos < tail && at(pos) == inst;
+    }
+
+    /** Position of the oldest slot, only meaningful if the window is not empty */
+    Pos headPos() const { return head; }
+
+    /** Position after the youngest slot */
+    Pos tailPos() const { return tail; }
+
+    /** Whether or not no instruction is in the window, not even one queued for removal */
+    bool empty() const { return occupied == 0; }
+
+    /** Amount of instructions in the window */
+    size_t size() const { return occupied; }
+
+    /** Queue the instruction at a position to be removed at the next clean up */
+    void remove(Pos pos) { removeList.push_back(pos); }
+
+    /** Whether or not instructions are queued for removal */
+    bool hasRemovals() const { return !removeList.empty(); }
+
+    /** Empty the slots queued for removal, and give back the empty slots at both ends */
+    void cleanUp();
+
+    /** Remove all instructions at once */
+    void clear();
+
+    const_iterator begin() const { return const_iterator(this, head); }
+    const_iterator end() const { return const_iterator(this, tail); }
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_INST_WINDOW_HH__
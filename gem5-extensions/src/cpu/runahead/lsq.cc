@@ -74,6 +74,7 @@ LSQ::LSQ(CPU *cpu_ptr, IEW *iew_ptr, const BaseRunaheadCPUParams &params)
       _cacheBlocked(false),
       cacheStorePorts(params.cacheStorePorts), usedStorePorts(0),
       cacheLoadPorts(params.cacheLoadPorts), usedLoadPorts(0),
+      runaheadCachePorts(params.runaheadCachePorts), usedRunaheadCachePorts(0),
       waitingForStaleTranslation(false),
       staleTranslationWaitTxnId(0),
       lsqPolicy(params.smtLSQPolicy),
@@ -158,6 +159,12 @@ LSQ::isDrained() const
         drained = false;
     }
 
+    // A lane response after a switch would reach a CPU that does not know it
+    if (!cpu->vectorRunaheadUnit().isDrained()) {
+        DPRINTF(Drain, "Not drained, vector runahead lanes in flight.\n");
+        drained = false;
+    }
+
     return drained;
 }
 
@@ -176,11 +183,20 @@ void
 LSQ::tick()
 {
     // Re-issue loads which got blocked on the per-cycle load ports limit.
-    if (usedLoadPorts == cacheLoadPorts && !_cacheBlocked)
+    if ((usedLoadPorts == cacheLoadPorts ||
+         (runaheadCachePorts && usedRunaheadCachePorts == runaheadCachePorts)) &&
+        !_cacheBlocked)
         iewStage->cacheUnblocked();
 
     usedLoadPorts = 0;
     usedStorePorts = 0;
+    usedRunaheadCachePorts = 0;
+
+    // Find LLLs as soon as they miss, rather than when they reach the ROB head
+    if (cpu->usingEarlyLLLDetection()) {
+        for (ThreadID tid : *activeThreads)
+            thread[tid].detectLLLs();
+    }
 }
 
 bool
@@ -218,12 +234,23 @@ LSQ::cachePortBusy(bool is_load)
     }
 }
 
+bool
+LSQ::runaheadCachePortAvailable() const
+{
+    // 0 ports means runahead cache accesses are not limited
+    return !runaheadCachePorts || usedRunaheadCachePorts < runaheadCachePorts;
+}
+
 bool
 LSQ::sendToRunaheadCache(PacketPtr pkt)
 {
     LSQRequest *request = dynamic_cast<LSQRequest*>(pkt->senderState);
     assert(request->isRunahead() && request->instruction()->isRunahead());
 
+    // Both hits and misses occupy the port
+    assert(runaheadCachePortAvailable());
+    usedRunaheadCachePorts++;
+
     PacketPtr rCachePkt = runaheadCache->handlePacket(pkt);
     if (rCachePkt == nullptr)
         return false;
@@ -232,7 +259,7 @@ LSQ::sendToRunaheadCache(PacketPtr pkt)
                          "Scheduling response.\n",
                          rCachePkt->getAddr(), rCachePkt->isRead());
 
-    // Schedule a fake timing response immediately
+    // Schedule a fake timing response after the runahead cache latency
     // *technically* a cache port should receive it but dcache just forwards the response
     // to the LSQ anyways
     request->pushRCachePacket(rCachePkt);
@@ -242,8 +269,7 @@ LSQ::sendToRunaheadCache(PacketPtr pkt)
             recvTimingResp(rCachePkt);
         },
         csprintf("reCachePktResp.%#x", rCachePkt->getAddr()), true);
-    // RETODO: make rcache delay configurable
-    cpu->schedule(event, cpu->clockEdge(Cycles(1)));
+    cpu->schedule(event, cpu->clockEdge(runaheadCache->getLatency()));
 
     return true;
 }
@@ -259,9 +285,9 @@ LSQ::setRunaheadCache(RunaheadCache *cache)
 }
 
 void
-LSQ::forgeResponse(const DynInstPtr &inst)
+LSQ::forgeResponse(const DynInstPtr &inst, uint64_t value)
 {
-    thread[inst->threadNumber].forgeResponse(inst);
+    thread[inst->threadNumber].forgeResponse(inst, value);
 }
 
 void
@@ -444,6 +470,22 @@ LSQ::recvReqRetry()
     }
 }
 
+bool
+LSQ::sendVectorRunaheadPacket(PacketPtr pkt)
+{
+    if (cacheBlocked() || !cachePortAvailable(true))
+        return false;
+
+    if (!dcachePort.sendTimingReq(pkt)) {
+        DPRINTF(LSQ, "D-cache became blocked when sending vector runahead lane.\n");
+        cacheBlocked(true);
+        return false;
+    }
+
+    cachePortBusy(true);
+    return true;
+}
+
 void
 LSQ::completeDataAccess(PacketPtr pkt)
 {
@@ -459,6 +501,12 @@ LSQ::recvTimingResp(PacketPtr pkt)
         DPRINTF(LSQ, "Got error packet back for address: %#X\n",
                 pkt->getAddr());
 
+    // Vector runahead lanes do not belong to any instruction
+    if (VectorRunahead::isLanePacket(pkt)) {
+        cpu->vectorRunaheadUnit().recvTimingResp(pkt);
+        return true;
+    }
+
     LSQRequest *request = dynamic_cast<LSQRequest*>(pkt->senderState);
     panic_if(!request, "Got packet back with unknown sender state\n");
 
@@ -834,6 +882,16 @@ LSQ::willWB(ThreadID tid)
     return thread.at(tid).willWB();
 }
 
+bool
+LSQ::pendingLLLDetection()
+{
+    for (ThreadID tid : *activeThreads) {
+        if (thread[tid].pendingLLLDetection())
+            return true;
+    }
+    return false;
+}
+
 void
 LSQ::dumpInsts() const
 {
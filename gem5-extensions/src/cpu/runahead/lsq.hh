@@ -226,6 +226,10 @@ class LSQ
             Runahead            = 0x00008000,
             /** Set if the request contains poisoned data */
             Poisoned            = 0x00010000,
+            /** Set if a normal mode request was to a block prefetched by runahead */
+            RunaheadPrefetched  = 0x00020000,
+            /** Set if a normal mode request was to a block prefetched by the continuous engine */
+            EnginePrefetched    = 0x00040000,
         };
         FlagsType flags;
 
@@ -571,6 +575,10 @@ class LSQ
 
         void setRunahead() { flags.set(Flag::Runahead); };
         bool isRunahead() { return flags.isSet(Flag::Runahead); };
+        void setRunaheadPrefetched() { flags.set(Flag::RunaheadPrefetched); };
+        bool isRunaheadPrefetched() { return flags.isSet(Flag::RunaheadPrefetched); };
+        void setEnginePrefetched() { flags.set(Flag::EnginePrefetched); };
+        bool isEnginePrefetched() { return flags.isSet(Flag::EnginePrefetched); };
 
         void setPoisoned() { flags.set(Flag::Poisoned); };
         bool isPoisoned() { return flags.isSet(Flag::Poisoned); };
@@ -887,6 +895,9 @@ class LSQ
 
     /** Returns if the LSQ will write back to memory this cycle. */
     bool willWB();
+
+    /** Returns if early LLL detection still has in-flight loads to look at. */
+    bool pendingLLLDetection();
     /** Returns if the LSQ of a specific thread will write back to memory this
      * cycle.
      */
@@ -950,14 +961,20 @@ class LSQ
 
     RequestPort &getDataPort() { return dcachePort; }
 
-    /** Send a packet to runahead cache */
+    /** Is any runahead cache port available to use? */
+    bool runaheadCachePortAvailable() const;
+
+    /** Send a packet to runahead cache. Uses a runahead cache port. */
     bool sendToRunaheadCache(PacketPtr pkt);
 
     /** Set the runahead cache pointer */
     void setRunaheadCache(RunaheadCache *cache);
 
-    /** Forge a writeback for the given instruction */
-    void forgeResponse(const DynInstPtr &inst);
+    /** Send a vector runahead lane to the data cache. Uses a load port. */
+    bool sendVectorRunaheadPacket(PacketPtr pkt);
+
+    /** Forge a writeback for the given instruction, loading the given value */
+    void forgeResponse(const DynInstPtr &inst, uint64_t value = 0);
 
   protected:
     /** D-cache is blocked */
@@ -970,6 +987,10 @@ class LSQ
     int cacheLoadPorts;
     /** The number of used cache ports in this cycle by loads. */
     int usedLoadPorts;
+    /** The number of runahead cache ports available each cycle, 0 if unlimited. */
+    int runaheadCachePorts;
+    /** The number of used runahead cache ports in this cycle. */
+    int usedRunaheadCachePorts;
 
     /** If the LSQ is currently waiting for stale translations */
     bool waitingForStaleTranslation;
@@ -45,6 +45,7 @@
 #include "base/str.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
+#include "cpu/runahead/continuous_runahead.hh"
 #include "cpu/runahead/dyn_inst.hh"
 #include "cpu/runahead/limits.hh"
 #include "cpu/runahead/lsq.hh"
@@ -113,8 +114,21 @@ LSQUnit::recvTimingResp(PacketPtr pkt)
         ++stats.runaheadPacketsReceived[pkt->isRead() ? 0 : 1];
     }
 
+    // Account runahead prefetches and the normal mode misses they did not cover
+    if (pkt->isRead() && !request->isRCachePacket(pkt)) {
+        if (request->isRunahead())
+            cpu->runaheadPrefetchTracker().prefetchFilled(pkt->getAddr(), pkt->req->getAccessDepth());
+        else if (!request->isRunaheadPrefetched())
+            cpu->runaheadPrefetchTracker().demandFilled(pkt->req->getAccessDepth());
+
+        ContinuousRunaheadEngine *engine = cpu->continuousRunaheadEngine();
+        if (engine && !request->isRunahead() && !request->isEnginePrefetched())
+            engine->demandFilled(pkt->req->getAccessDepth());
+    }
+
     // Check if the instruction that initiated the request caused runahead
-    if (inst->isRunahead() && cpu->instCausedRunahead(inst)) {
+    // In precise runahead, the LLL itself is not a runahead inst
+    if (cpu->inRunahead(inst->threadNumber) && cpu->instCausedRunahead(inst)) {
         DPRINTF(RunaheadLSQ, "[tid:%i] Runahead-causing inst [sn:%llu] (PC %s) "
                              "received timing response.\n",
                              inst->threadNumber, inst->seqNum, inst->pcState());
@@ -125,6 +139,8 @@ LSQUnit::recvTimingResp(PacketPtr pkt)
     // If the load was poisoned (for being an LLL, for instance), discard the packet.
     // The instruction will already have completed writeback via a forged LLL response
     if (inst->hasForgedResponse()) {
+        if (inst->isPredicted() && pkt->isRead())
+            cpu->loadValuePredictor().verify(inst, pkt);
         DPRINTF(RunaheadLSQ, "[tid:%i] [sn:%llu] Load with forged response got D-cache reply. Discarding.\n",
                 inst->threadNumber, inst->seqNum);
         return ret;
@@ -142,18 +158,19 @@ LSQUnit::recvTimingResp(PacketPtr pkt)
 }
 
 void
-LSQUnit::forgeResponse(const DynInstPtr &inst)
+LSQUnit::forgeResponse(const DynInstPtr &inst, uint64_t value)
 {
     LSQRequest *req = inst->savedRequest;
 
-    // Issue a bogus 0 for the memory data
-    DPRINTF(RunaheadLSQ, "Forging load response for load with [sn:%llu] PC %s\n",
-            inst->seqNum, inst->pcState());
+    // Issue a bogus value for the memory data. 0 unless the value was predicted
+    DPRINTF(RunaheadLSQ, "Forging load response (%#x) for load with [sn:%llu] PC %s\n",
+            value, inst->seqNum, inst->pcState());
     ++stats.loadResponsesForged;
 
     PacketPtr pkt = new Packet(*req->packet());
-    // maybe not necessary?
-    memset(inst->memData, 0, req->mainReq()->getSize());
+    unsigned size = req->mainReq()->getSize();
+    memset(inst->memData, 0, size);
+    memcpy(inst->memData, &value, std::min<unsigned>(size, sizeof(value)));
 
     // Schedule a fake writeback for the next cycle, using the writebackevent
     // usually used when stores are forwarded to loads
@@ -979,6 +996,12 @@ LSQUnit::writebackStores()
             continue;
         }
 
+        // ...but they do need a runahead cache port. Stores write back in order, so stop here
+        if (inst->isRunahead() && !lsq->runaheadCachePortAvailable()) {
+            DPRINTF(RunaheadLSQ, "No runahead cache ports available for store writeback.\n");
+            break;
+        }
+
         if (isStoreBlocked) {
             assert(!inst->isRunahead());
             DPRINTF(LSQUnit, "Unable to write back any more stores, cache"
@@ -1474,13 +1497,33 @@ LSQUnit::trySendPacket(bool isLoad, PacketPtr data_pkt)
     if (!request->isRunahead() || isLoad) {
         assert(!request->isRunahead() || !data_pkt->isWrite());
 
+        // Runahead loads access the runahead cache in parallel, so it needs a free port too
         if (!lsq->cacheBlocked() &&
-            lsq->cachePortAvailable(isLoad)) {
+            lsq->cachePortAvailable(isLoad) &&
+            (!request->isRunahead() || lsq->runaheadCachePortAvailable())) {
             if (!dcachePort->sendTimingReq(data_pkt)) {
                 success = false;
                 cache_got_blocked = true;
             } else {
                 packetsSent++;
+
+                // Track runahead prefetches and whether normal mode demands them
+                if (isLoad && request->isRunahead()) {
+                    bool predicted = request->instruction()->isPredicted();
+                    cpu->runaheadPrefetchTracker().prefetchIssued(data_pkt->getAddr(),
+                        predicted ? RunaheadPrefetchTracker::ValuePredicted :
+                                    RunaheadPrefetchTracker::Scalar);
+                    if (predicted)
+                        cpu->loadValuePredictor().dependentLoadIssued();
+                } else if (isLoad && cpu->runaheadPrefetchTracker().demandAccess(data_pkt->getAddr())) {
+                    request->setRunaheadPrefetched();
+                }
+
+                ContinuousRunaheadEngine *engine = cpu->continuousRunaheadEngine();
+                if (isLoad && !request->isRunahead() && engine &&
+                    engine->demandAccess(data_pkt->getAddr())) {
+                    request->setEnginePrefetched();
+                }
             }
         } else {
             success = false;
@@ -1580,6 +1623,54 @@ LSQUnit::checkStaleTranslations() const
     return false;
 }
 
+void
+LSQUnit::detectLLLs()
+{
+    for (auto& entry : loadQueue) {
+        if (!entry.valid() || !entry.hasRequest())
+            continue;
+
+        const DynInstPtr &inst = entry.instruction();
+        LSQRequest *request = entry.request();
+        if (inst->isDetectedLLL() || inst->isRunahead() || inst->isSquashed() ||
+            !request->isSent() || request->isComplete())
+            continue;
+
+        // The caches bump the depth of the request as the miss goes down the hierarchy
+        bool allReqsMissed = true;
+        for (int idx = 0; idx < request->_reqs.size(); idx++) {
+            if (request->req(idx)->getAccessDepth() < cpu->lllDepthThreshold) {
+                allReqsMissed = false;
+                break;
+            }
+        }
+
+        if (allReqsMissed) {
+            DPRINTF(RunaheadLSQ, "[sn:%llu] In-flight load missed deep enough to be a LLL.\n",
+                    inst->seqNum);
+            inst->setDetectedLLL();
+            cpu->lllDetected(inst);
+        }
+    }
+}
+
+bool
+LSQUnit::pendingLLLDetection()
+{
+    // Same loads as detectLLLs(), their depth can change without waking the CPU
+    for (auto& entry : loadQueue) {
+        if (!entry.valid() || !entry.hasRequest())
+            continue;
+
+        const DynInstPtr &inst = entry.instruction();
+        LSQRequest *request = entry.request();
+        if (!inst->isDetectedLLL() && !inst->isRunahead() && !inst->isSquashed() &&
+            request->isSent() && !request->isComplete())
+            return true;
+    }
+    return false;
+}
+
 void
 LSQUnit::recvRetry()
 {
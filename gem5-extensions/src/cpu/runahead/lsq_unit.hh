@@ -331,6 +331,12 @@ class LSQUnit
     void startStaleTranslationFlush();
     bool checkStaleTranslations() const;
 
+    /** Mark in-flight normal mode loads that missed deep enough as LLLs */
+    void detectLLLs();
+
+    /** Whether or not detectLLLs() still has in-flight loads to look at */
+    bool pendingLLLDetection();
+
     /** Returns if either the LQ or SQ is full. */
     bool isFull() { return lqFull() || sqFull(); }
 
@@ -456,8 +462,8 @@ class LSQUnit
      */
     bool recvTimingResp(PacketPtr pkt);
 
-    /** Forge a writeback event for the given instruction */
-    void forgeResponse(const DynInstPtr &inst);
+    /** Forge a writeback event for the given instruction, loading the given value */
+    void forgeResponse(const DynInstPtr &inst, uint64_t value = 0);
 
   private:
     /** The LSQUnit thread id. */
@@ -0,0 +1,314 @@
+#ifndef __CPU_RUNAHEAD_POOLED_DEP_GRAPH_HH__
+#define __CPU_RUNAHEAD_POOLED_DEP_GRAPH_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "cpu/runahead/dep_graph.hh"
+
+namespace gem5
+{
+
+namespace runahead
+{
+
+/**
+ * Dependency graph with the same interface and wakeup order as DependencyGraph, but without a
+ * heap node per consumer. The consumers of all registers live in one arena, with a fixed amount
+ * of slots per register, so waking up the consumers of a register scans contiguous memory.
+ *
+ * A register with more consumers than slots spills the youngest ones to a per-register vector.
+ * The vectors keep their memory once grown, so spilling only goes to the heap while warming up.
+ * Consumers are kept oldest first, slots before spill, and popped youngest first like the
+ * linked lists of DependencyGraph, so both graphs wake up instructions in the same order.
+ */
+template <class DynInstPtr>
+class PooledDependencyGraph
+{
+  public:
+    /** Must call resize() prior to use. */
+    PooledDependencyGraph()
+        : numEntries(0), capacity(0)
+    { }
+
+    /** Resize the graph to num_entries registers with the given slots each. */
+    void resize(int num_entries, unsigned slots_per_reg);
+
+    /** Clears the consumers and producers of all registers. */
+    void reset();
+
+    /**
+     * Inserts an instruction to be dependent on the given index.
+     * Returns whether or not it had to be spilled.
+     */
+    bool insert(RegIndex idx, const DynInstPtr &new_inst);
+
+    /** Sets the producing instruction of a given register. */
+    void setInst(RegIndex idx, const DynInstPtr &new_inst)
+    { producers[idx] = new_inst; }
+
+    /** Clears the producing instruction. */
+    void clearInst(RegIndex idx)
+    { producers[idx] = NULL; }
+
+    /** Removes an instruction from the consumers of a register. */
+    void remove(RegIndex idx, const DynInstPtr &inst_to_remove);
+
+    /** Removes and returns the youngest consumer of a register. */
+    DynInstPtr pop(RegIndex idx);
+
+    /** Checks if no register has consumers. */
+    bool empty() const;
+
+    /** Checks if there are any consumers of a specific register. */
+    bool empty(RegIndex idx) const
+    { return counts[idx] == 0; }
+
+    /** Debugging function to dump out the dependency graph. */
+    void dump();
+    void dump(RegIndex idx);
+
+  private:
+    /** Number of registers. */
+    int numEntries;
+
+    /** Consumer slots per register. */
+    unsigned capacity;
+
+    /** Producer of each register. */
+    std::vector<DynInstPtr> producers;
+
+    /** Consumer slots, capacity of them per register, back to back. */
+    std::vector<DynInstPtr> slots;
+
+    /** Amount of slots in use per register. */
+    std::vector<unsigned> counts;
+
+    /** Consumers that did not fit in the slots of a register, oldest first. */
+    std::vector<std::vector<DynInstPtr>> spill;
+
+    DynInstPtr *regSlots(RegIndex idx) { return &slots[idx * capacity]; }
+};
+
+template <class DynInstPtr>
+void
+PooledDependencyGraph<DynInstPtr>::resize(int num_entries, unsigned slots_per_reg)
+{
+    numEntries = num_entries;
+    capacity = slots_per_reg;
+
+    producers.resize(numEntries);
+    slots.resize(numEntries * capacity);
+    counts.resize(numEntries, 0);
+    spill.resize(numEntries);
+}
+
+template <class DynInstPtr>
+void
+PooledDependencyGraph<DynInstPtr>::reset()
+{
+    for (int i = 0; i < numEntries; ++i) {
+        DynInstPtr *reg_slots = regSlots(i);
+        for (unsigned j = 0; j < counts[i]; ++j)
+            reg_slots[j] = NULL;
+
+        counts[i] = 0;
+        spill[i].clear();
+        producers[i] = NULL;
+    }
+}
+
+template <class DynInstPtr>
+bool
+PooledDependencyGraph<DynInstPtr>::insert(RegIndex idx, const DynInstPtr &new_inst)
+{
+    if (counts[idx] < capacity) {
+        regSlots(idx)[counts[idx]++] = new_inst;
+        return false;
+    }
+
+    spill[idx].push_back(new_inst);
+    return true;
+}
+
+template <class DynInstPtr>
+void
+PooledDependencyGraph<DynInstPtr>::remove(RegIndex idx,
+                                          const DynInstPtr &inst_to_remove)
+{
+    // Same as DependencyGraph, an empty register means the consumer was already woken up
+    if (counts[idx] == 0)
+        return;
+
+    std::vector<DynInstPtr> &reg_spill = spill[idx];
+    auto spill_it = std::find(reg_spill.begin(), reg_spill.end(), inst_to_remove);
+    if (spill_it != reg_spill.end()) {
+        reg_spill.erase(spill_it);
+        return;
+    }
+
+    DynInstPtr *reg_slots = regSlots(idx);
+    DynInstPtr *end = reg_slots + counts[idx];
+    DynInstPtr *it = std::find(reg_slots, end, inst_to_remove);
+    assert(it != end);
+
+    // Close the gap, and move the oldest spilled consumer into the freed slot
+    std::move(it + 1, end, it);
+    if (!reg_spill.empty()) {
+        *(end - 1) = reg_spill.front();
+        reg_spill.erase(reg_spill.begin());
+    } else {
+        *(end - 1) = NULL;
+        --counts[idx];
+    }
+}
+
+template <class DynInstPtr>
+DynInstPtr
+PooledDependencyGraph<DynInstPtr>::pop(RegIndex idx)
+{
+    DynInstPtr inst = NULL;
+
+    std::vector<DynInstPtr> &reg_spill = spill[idx];
+    if (!reg_spill.empty()) {
+        inst = reg_spill.back();
+        reg_spill.pop_back();
+    } else if (counts[idx] > 0) {
+        DynInstPtr &slot = regSlots(idx)[--counts[idx]];
+        inst = slot;
+        slot = NULL;
+    }
+
+    return inst;
+}
+
+template <class DynInstPtr>
+bool
+PooledDependencyGraph<DynInstPtr>::empty() const
+{
+    for (int i = 0; i < numEntries; ++i) {
+        if (!empty(i))
+            return false;
+    }
+    return true;
+}
+
+template <class DynInstPtr>
+void
+PooledDependencyGraph<DynInstPtr>::dump()
+{
+    for (int i = 0; i < numEntries; ++i)
+        dump(i);
+}
+
+template <class DynInstPtr>
+void
+PooledDependencyGraph<DynInstPtr>::dump(RegIndex idx)
+{
+    if (producers[idx]) {
+        cprintf("dependGraph[%i]: producer: %s [sn:%lli] consumer: ",
+                idx, producers[idx]->pcState(), producers[idx]->seqNum);
+    } else {
+        cprintf("dependGraph[%i]: No producer. consumer: ", idx);
+    }
+
+    // Youngest first, like the linked lists of DependencyGraph
+    for (auto it = spill[idx].rbegin(); it != spill[idx].rend(); ++it)
+        cprintf("%s [sn:%lli] ", (*it)->pcState(), (*it)->seqNum);
+
+    DynInstPtr *reg_slots = regSlots(idx);
+    for (unsigned j = counts[idx]; j > 0; --j)
+        cprintf("%s [sn:%lli] ", reg_slots[j - 1]->pcState(), reg_slots[j - 1]->seqNum);
+
+    cprintf("\n");
+}
+
+/**
+ * The dependency graph of the IQ, either the linked DependencyGraph or the
+ * PooledDependencyGraph, picked when the IQ is created.
+ */
+template <class DynInstPtr>
+class IQDependencyGraph
+{
+  private:
+    bool pooled;
+
+    DependencyGraph<DynInstPtr> linkedGraph;
+
+    PooledDependencyGraph<DynInstPtr> pooledGraph;
+
+  public:
+    IQDependencyGraph()
+        : pooled(false)
+    { }
+
+    /** Pick the implementation and resize it to num_entries registers. */
+    void
+    init(bool use_pooled, int num_entries, unsigned slots_per_reg)
+    {
+        pooled = use_pooled;
+        if (pooled)
+            pooledGraph.resize(num_entries, slots_per_reg);
+        else
+            linkedGraph.resize(num_entries);
+    }
+
+    void reset() { pooled ? pooledGraph.reset() : linkedGraph.reset(); }
+
+    /** Returns whether or not the consumer was spilled. */
+    bool
+    insert(RegIndex idx, const DynInstPtr &new_inst)
+    {
+        if (pooled)
+            return pooledGraph.insert(idx, new_inst);
+        linkedGraph.insert(idx, new_inst);
+        return false;
+    }
+
+    void
+    setInst(RegIndex idx, const DynInstPtr &new_inst)
+    {
+        pooled ? pooledGraph.setInst(idx, new_inst) : linkedGraph.setInst(idx, new_inst);
+    }
+
+    void
+    clearInst(RegIndex idx)
+    {
+        pooled ? pooledGraph.clearInst(idx) : linkedGraph.clearInst(idx);
+    }
+
+    void
+    remove(RegIndex idx, const DynInstPtr &inst_to_remove)
+    {
+        pooled ? pooledGraph.remove(idx, inst_to_remove) :
+                 linkedGraph.remove(idx, inst_to_remove);
+    }
+
+    DynInstPtr
+    pop(RegIndex idx)
+    {
+        return pooled ? pooledGraph.pop(idx) : linkedGraph.pop(idx);
+    }
+
+    bool empty() const { return pooled ? pooledGraph.empty() : linkedGraph.empty(); }
+
+    bool
+    empty(RegIndex idx) const
+    {
+        return pooled ? pooledGraph.empty(idx) : linkedGraph.empty(idx);
+    }
+
+    void dump() { pooled ? pooledGraph.dump() : linkedGraph.dump(); }
+    void dump(RegIndex idx) { pooled ? pooledGraph.dump(idx) : linkedGraph.dump(idx); }
+
+    /** Linked list nodes walked and removed, zero for the pooled graph. */
+    uint64_t nodesTraversed() const { return linkedGraph.nodesTraversed; }
+    uint64_t nodesRemoved() const { return linkedGraph.nodesRemoved; }
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_POOLED_DEP_GRAPH_HH__
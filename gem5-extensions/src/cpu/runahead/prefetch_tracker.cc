@@ -0,0 +1,283 @@
+#include <iterator>
+
+#include "cpu/runahead/prefetch_tracker.hh"
+
+#include "cpu/runahead/cpu.hh"
+#include "debug/RunaheadPrefetch.hh"
+#include "params/BaseRunaheadCPU.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+RunaheadPrefetchTracker::RunaheadPrefetchTracker(CPU *_cpu, const BaseRunaheadCPUParams &params)
+    : cpu(_cpu),
+      enabled(params.enableRunahead && params.runaheadPrefetchTrackerSize > 0),
+      capacity(params.runaheadPrefetchTrackerSize),
+      maxPeriods(params.runaheadPrefetchTrackerPeriods),
+      lllDepthThreshold(params.lllDepthThreshold),
+      blockSize(_cpu->cacheLineSize()),
+      curPeriod(0),
+      stats(_cpu)
+{
+    fatal_if(enabled && maxPeriods == 0,
+             "The runahead prefetch tracker must keep records for at least one period.\n");
+}
+
+std::string
+RunaheadPrefetchTracker::name() const
+{
+    return cpu->name() + ".prefetchtracker";
+}
+
+RunaheadPrefetchTracker::PeriodRecord *
+RunaheadPrefetchTracker::findPeriod(uint64_t id)
+{
+    // Periods are kept in order, so the record is at a fixed offset from the oldest one
+    if (periods.empty() || id < periods.front().id)
+        return nullptr;
+
+    size_t idx = id - periods.front().id;
+    if (idx >= periods.size())
+        return nullptr;
+    return &periods[idx];
+}
+
+void
+RunaheadPrefetchTracker::startPeriod()
+{
+    if (!enabled)
+        return;
+
+    curPeriod++;
+    PeriodRecord record;
+    record.id = curPeriod;
+    periods.push_back(record);
+
+    DPRINTF(RunaheadPrefetch, "Starting prefetch accounting for period %llu. "
+            "%i blocks tracked.\n", curPeriod, entries.size());
+
+    retirePeriods();
+}
+
+void
+RunaheadPrefetchTracker::prefetchIssued(Addr addr, Origin origin)
+{
+    // Runahead before the first period can not happen, but be safe
+    if (!enabled || periods.empty())
+        return;
+
+    Addr blkAddr = blockAlign(addr);
+    if (entryMap.find(blkAddr) != entryMap.end())
+        return;
+
+    // Make room by letting the oldest block fall out of the tracking window
+    if (entries.size() >= capacity) {
+        EntryList::iterator oldest = entries.begin();
+        DPRINTF(RunaheadPrefetch, "Block %#x of period %llu was never demanded.\n",
+                oldest->blkAddr, oldest->period);
+
+        stats.unusedInWindow++;
+        if (PeriodRecord *record = findPeriod(oldest->period))
+            record->unusedInWindow++;
+        removeEntry(oldest);
+    }
+
+    DPRINTF(RunaheadPrefetch, "Tracking runahead prefetch of block %#x (period %llu%s).\n",
+            blkAddr, curPeriod,
+            origin == ValuePredicted ? ", value predicted" :
+            origin == VectorLane ? ", vector lane" : "");
+
+    entries.push_back({blkAddr, curPeriod, false, curTick(), origin});
+    entryMap[blkAddr] = std::prev(entries.end());
+
+    PeriodRecord &record = periods.back();
+    record.issued++;
+    record.outstanding++;
+    stats.issued++;
+    if (origin == ValuePredicted)
+        stats.predicted++;
+    else if (origin == VectorLane)
+        stats.vectorLanes++;
+}
+
+void
+RunaheadPrefetchTracker::prefetchFilled(Addr addr, int depth)
+{
+    if (!enabled)
+        return;
+
+    auto it = entryMap.find(blockAlign(addr));
+    // Already demanded (late), or no longer tracked
+    if (it == entryMap.end() || it->second->filled)
+        return;
+
+    EntryList::iterator entry = it->second;
+    // The block was already close to the core, so this was not really a prefetch
+    if (depth < lllDepthThreshold) {
+        DPRINTF(RunaheadPrefetch, "Block %#x was serviced at depth %i, not a prefetch.\n",
+                entry->blkAddr, depth);
+
+        // Not counted as issued anywhere, so the global and per period counts agree
+        stats.redundant++;
+        stats.issued--;
+        if (entry->origin == ValuePredicted)
+            stats.predicted--;
+        else if (entry->origin == VectorLane)
+            stats.vectorLanes--;
+        if (PeriodRecord *record = findPeriod(entry->period))
+            record->issued--;
+        removeEntry(entry);
+        return;
+    }
+
+    entry->filled = true;
+}
+
+bool
+RunaheadPrefetchTracker::demandAccess(Addr addr)
+{
+    if (!enabled)
+        return false;
+
+    auto it = entryMap.find(blockAlign(addr));
+    if (it == entryMap.end())
+        return false;
+
+    EntryList::iterator entry = it->second;
+    PeriodRecord *record = findPeriod(entry->period);
+
+    DPRINTF(RunaheadPrefetch, "Block %#x of period %llu demanded by normal mode (%s).\n",
+            entry->blkAddr, entry->period, entry->filled ? "useful" : "late");
+
+    if (entry->filled) {
+        stats.useful++;
+        if (record)
+            record->useful++;
+    } else {
+        stats.late++;
+        if (record)
+            record->late++;
+    }
+    if (entry->origin == ValuePredicted)
+        stats.predictedUseful++;
+    else if (entry->origin == VectorLane)
+        stats.vectorLanesUseful++;
+    stats.demandDistance.sample(curTick() - entry->issueTick);
+
+    removeEntry(entry);
+    return true;
+}
+
+void
+RunaheadPrefetchTracker::demandFilled(int depth)
+{
+    if (!enabled || depth < lllDepthThreshold)
+        return;
+
+    stats.uncoveredMisses++;
+    if (!periods.empty())
+        periods.back().uncoveredMisses++;
+}
+
+void
+RunaheadPrefetchTracker::removeEntry(EntryList::iterator it)
+{
+    if (PeriodRecord *record = findPeriod(it->period)) {
+        assert(record->outstanding > 0);
+        record->outstanding--;
+    }
+
+    entryMap.erase(it->blkAddr);
+    entries.erase(it);
+
+    retirePeriods();
+}
+
+void
+RunaheadPrefetchTracker::retirePeriods()
+{
+    // Never retire the current period, more prefetches and misses may be attributed to it
+    while (periods.size() > 1 &&
+           (periods.front().outstanding == 0 || periods.size() > maxPeriods)) {
+        samplePeriod(periods.front());
+        periods.pop_front();
+    }
+}
+
+void
+RunaheadPrefetchTracker::samplePeriod(const PeriodRecord &record)
+{
+    unsigned covered = record.useful + record.late;
+    unsigned classified = covered + record.unusedInWindow;
+
+    DPRINTF(RunaheadPrefetch, "Period %llu: %i prefetches, %i useful, %i late, %i unused in window, "
+            "%i uncovered misses, %i unclassified.\n",
+            record.id, record.issued, record.useful, record.late, record.unusedInWindow,
+            record.uncoveredMisses, record.outstanding);
+
+    stats.periodPrefetches.sample(record.issued);
+    if (classified > 0)
+        stats.periodWindowAccuracy.sample(covered * 100 / classified);
+    if (covered + record.uncoveredMisses > 0)
+        stats.periodWindowCoverage.sample(covered * 100 / (covered + record.uncoveredMisses));
+}
+
+RunaheadPrefetchTracker::PrefetchTrackerStats::PrefetchTrackerStats(CPU *cpu)
+    : statistics::Group(cpu, "prefetchtracker"),
+      ADD_STAT(issued, statistics::units::Count::get(),
+           "Number of blocks prefetched by runahead loads, excluding redundant requests"),
+      ADD_STAT(redundant, statistics::units::Count::get(),
+           "Number of runahead requests serviced before the long latency depth"),
+      ADD_STAT(useful, statistics::units::Count::get(),
+           "Number of runahead prefetches demanded by normal mode after filling"),
+      ADD_STAT(late, statistics::units::Count::get(),
+           "Number of runahead prefetches demanded by normal mode while in flight"),
+      ADD_STAT(unusedInWindow, statistics::units::Count::get(),
+           "Number of runahead prefetches not demanded before leaving the tracking window"),
+      ADD_STAT(predicted, statistics::units::Count::get(),
+           "Number of runahead prefetches with addresses depending on value predicted loads"),
+      ADD_STAT(predictedUseful, statistics::units::Count::get(),
+           "Number of value predicted runahead prefetches demanded by normal mode"),
+      ADD_STAT(vectorLanes, statistics::units::Count::get(),
+           "Number of runahead prefetches issued by vector runahead lanes"),
+      ADD_STAT(vectorLanesUseful, statistics::units::Count::get(),
+           "Number of vector runahead lane prefetches demanded by normal mode"),
+      ADD_STAT(uncoveredMisses, statistics::units::Count::get(),
+           "Number of normal mode long latency loads not prefetched by runahead"),
+      ADD_STAT(demandDistance, statistics::units::Tick::get(),
+           "Ticks between a runahead prefetch and its demand by normal mode"),
+      ADD_STAT(windowAccuracy, statistics::units::Ratio::get(),
+           "Fraction of classified runahead prefetches demanded within the tracking window "
+           "(approximates accuracy, the caches do not tag runahead blocks)",
+           (useful + late) / (useful + late + unusedInWindow)),
+      ADD_STAT(windowCoverage, statistics::units::Ratio::get(),
+           "Fraction of normal mode long latency loads to runahead prefetched blocks in the "
+           "tracking window (approximates coverage)",
+           (useful + late) / (useful + late + uncoveredMisses)),
+      ADD_STAT(periodWindowAccuracy, statistics::units::Ratio::get(),
+           "Runahead prefetch window accuracy per runahead period, in percent"),
+      ADD_STAT(periodWindowCoverage, statistics::units::Ratio::get(),
+           "Long latency load window coverage per runahead period, in percent"),
+      ADD_STAT(periodPrefetches, statistics::units::Count::get(),
+           "Number of runahead prefetches per runahead period")
+{
+    demandDistance
+        .init(16)
+        .flags(statistics::total);
+    windowAccuracy.precision(6);
+    windowCoverage.precision(6);
+    periodWindowAccuracy
+        .init(0, 100, 10)
+        .flags(statistics::total);
+    periodWindowCoverage
+        .init(0, 100, 10)
+        .flags(statistics::total);
+    periodPrefetches
+        .init(0, 64, 4)
+        .flags(statistics::total);
+}
+
+} // namespace runahead
+} // namespace gem5
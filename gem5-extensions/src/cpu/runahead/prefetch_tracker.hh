@@ -0,0 +1,200 @@
+#ifndef __CPU_RUNAHEAD_PREFETCH_TRACKER_HH__
+#define __CPU_RUNAHEAD_PREFETCH_TRACKER_HH__
+
+#include <deque>
+#include <list>
+#include <unordered_map>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+struct BaseRunaheadCPUParams;
+
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * Tracks the blocks fetched from memory by runahead loads, i.e. runahead's prefetches,
+ * and classifies each of them by what happens to it afterwards:
+ *  - Useful: a normal mode load demanded the block after the prefetch filled
+ *  - Late: a normal mode load demanded the block while the prefetch was still in flight
+ *  - Unused in window: the block was not demanded before it fell out of the tracking window
+ *
+ * The tracker only sees what passes through the LSQ, the caches do not tag runahead blocks.
+ * The FIFO tracking window stands in for eviction from the cache hierarchy, so a block still
+ * cached can count as unused, and a demand for an evicted block can count as useful. The
+ * window accuracy and coverage are approximations of the cache based metrics, and the
+ * pollution of individual cache levels is not measured at all.
+ *
+ * Prefetches are attributed to the runahead period that issued them. Once all of a period's
+ * prefetches have been classified, the accuracy and coverage of that period is sampled.
+ */
+class RunaheadPrefetchTracker
+{
+  public:
+    /** What generated the prefetch address */
+    enum Origin
+    {
+        /** A runahead load executing normally */
+        Scalar,
+        /** A runahead load with an address depending on a value predicted load */
+        ValuePredicted,
+        /** A lane issued by vector runahead */
+        VectorLane,
+    };
+
+  private:
+    /** A block fetched by a runahead load */
+    struct Entry
+    {
+        /** Block address */
+        Addr blkAddr;
+        /** Period that issued the prefetch */
+        uint64_t period;
+        /** Whether or not the prefetch response has arrived */
+        bool filled;
+        /** Tick at which the prefetch was issued */
+        Tick issueTick;
+        /** What generated the prefetch address */
+        Origin origin;
+    };
+
+    /** Classification counts for a single runahead period */
+    struct PeriodRecord
+    {
+        uint64_t id;
+        unsigned issued = 0;
+        unsigned useful = 0;
+        unsigned late = 0;
+        unsigned unusedInWindow = 0;
+        /** Demand misses to blocks runahead did not prefetch, since this period started */
+        unsigned uncoveredMisses = 0;
+        /** Prefetches of this period that are yet to be classified */
+        unsigned outstanding = 0;
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    /** Pointer to the CPU */
+    CPU *cpu;
+
+    /** Whether or not the tracker is enabled */
+    bool enabled;
+
+    /** Maximum amount of blocks to track */
+    const unsigned capacity;
+
+    /** Maximum amount of runahead periods to keep records for */
+    const unsigned maxPeriods;
+
+    /** Requests serviced at or beyond this depth are long latency */
+    const int lllDepthThreshold;
+
+    /** Block size used to align addresses */
+    const unsigned blockSize;
+
+    /** Tracked blocks, oldest first */
+    EntryList entries;
+
+    /** Block address to tracked block */
+    std::unordered_map<Addr, EntryList::iterator> entryMap;
+
+    /** Records of the periods with prefetches yet to be classified, oldest first */
+    std::deque<PeriodRecord> periods;
+
+    /** Id of the current/most recent runahead period */
+    uint64_t curPeriod;
+
+    Addr blockAlign(Addr addr) const { return addr & ~((Addr)blockSize - 1); }
+
+    /** Find the record of a period. Returns nullptr if it has been retired */
+    PeriodRecord *findPeriod(uint64_t id);
+
+    /** Stop tracking a block */
+    void removeEntry(EntryList::iterator it);
+
+    /** Sample and drop the records of periods that are fully classified */
+    void retirePeriods();
+
+    /** Sample the accuracy and coverage of a period */
+    void samplePeriod(const PeriodRecord &record);
+
+  public:
+    RunaheadPrefetchTracker(CPU *_cpu, const BaseRunaheadCPUParams &params);
+
+    /** Returns the name of the prefetch tracker */
+    std::string name() const;
+
+    /** Whether or not the tracker is enabled */
+    bool isEnabled() const { return enabled; }
+
+    /** Attribute the following prefetches to a new runahead period */
+    void startPeriod();
+
+    /**
+     * A runahead load sent a request for the given address to the memory system.
+     * origin tells what generated the address.
+     */
+    void prefetchIssued(Addr addr, Origin origin = Scalar);
+
+    /** A runahead load request for the given address was serviced at the given depth */
+    void prefetchFilled(Addr addr, int depth);
+
+    /**
+     * A normal mode load sent a request for the given address to the memory system.
+     * Returns true if the block was prefetched by runahead.
+     */
+    bool demandAccess(Addr addr);
+
+    /** A normal mode load that was not prefetched by runahead was serviced at the given depth */
+    void demandFilled(int depth);
+
+  private:
+    struct PrefetchTrackerStats : public statistics::Group
+    {
+        PrefetchTrackerStats(CPU *cpu);
+
+        /** Runahead loads sent to the memory system, excluding redundant ones */
+        statistics::Scalar issued;
+        /** Runahead loads serviced close to the core, i.e. not a real prefetch */
+        statistics::Scalar redundant;
+        /** Prefetches demanded by normal mode after they filled */
+        statistics::Scalar useful;
+        /** Prefetches demanded by normal mode while still in flight */
+        statistics::Scalar late;
+        /** Prefetches that were not demanded before falling out of the tracking window */
+        statistics::Scalar unusedInWindow;
+        /** Prefetches with addresses depending on value predicted loads */
+        statistics::Scalar predicted;
+        /** Value predicted prefetches demanded by normal mode, i.e. correct extra addresses */
+        statistics::Scalar predictedUseful;
+        /** Prefetches issued by vector runahead lanes */
+        statistics::Scalar vectorLanes;
+        /** Vector runahead lane prefetches demanded by normal mode */
+        statistics::Scalar vectorLanesUseful;
+        /** Normal mode long latency loads that runahead did not prefetch */
+        statistics::Scalar uncoveredMisses;
+        /** Ticks between issuing a prefetch and normal mode demanding it */
+        statistics::Histogram demandDistance;
+        /** Fraction of classified prefetches demanded within the tracking window */
+        statistics::Formula windowAccuracy;
+        /** Fraction of normal mode long latency loads to blocks in the tracking window */
+        statistics::Formula windowCoverage;
+        /** Per period window accuracy, in percent */
+        statistics::Distribution periodWindowAccuracy;
+        /** Per period window coverage, in percent */
+        statistics::Distribution periodWindowCoverage;
+        /** Prefetches issued per period */
+        statistics::Distribution periodPrefetches;
+    } stats;
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_PREFETCH_TRACKER_HH__
@@ -41,6 +41,9 @@
 
 #include "cpu/runahead/regfile.hh"
 
+#include <algorithm>
+
+#include "base/bitfield.hh"
 #include "cpu/runahead/free_list.hh"
 
 namespace gem5
@@ -122,9 +125,39 @@ PhysRegFile::PhysRegFile(unsigned _numPhysicalIntRegs,
     }
 
     // No registers are poisoned to begin with
-    for (int regIdx = 0; regIdx < flat_reg_idx; regIdx++) {
-        poisonedRegs.push_back(false);
+    poisonBits.resize((flat_reg_idx + 63) / 64, 0);
+    predictedBits.resize((flat_reg_idx + 63) / 64, 0);
+
+    // Flat indices are handed out class by class, in the order above
+    size_t first = 0;
+    const unsigned classRegs[CCRegClass + 1] = {
+        numPhysicalIntRegs, numPhysicalFloatRegs, numPhysicalVecRegs,
+        numPhysicalVecElemRegs, numPhysicalVecPredRegs, numPhysicalCCRegs
+    };
+    for (int type = 0; type <= CCRegClass; type++) {
+        poisonRanges[type] = std::make_pair(first, first + classRegs[type]);
+        first += classRegs[type];
+    }
+    assert(first == flat_reg_idx);
+}
+
+size_t
+PhysRegFile::countPoisoned(size_t first, size_t last) const
+{
+    size_t count = 0;
+    while (first < last) {
+        const size_t wordIdx = first / 64;
+        const size_t lo = first % 64;
+        const size_t hi = std::min<size_t>(last - wordIdx * 64, 64);
+
+        uint64_t word = poisonBits[wordIdx] >> lo;
+        if (hi - lo < 64)
+            word &= (1ULL << (hi - lo)) - 1;
+        count += popCount(word);
+
+        first = wordIdx * 64 + hi;
     }
+    return count;
 }
 
 
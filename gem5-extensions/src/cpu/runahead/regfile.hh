@@ -43,6 +43,7 @@
 #define __CPU_RUNAHEAD_REGFILE_HH__
 
 #include <cstring>
+#include <utility>
 #include <vector>
 
 #include "arch/generic/isa.hh"
@@ -101,8 +102,23 @@ class PhysRegFile
     /** Misc Reg Ids */
     std::vector<PhysRegId> miscRegIds;
 
-    /** Flat list of poisoned registers */
-    std::vector<bool> poisonedRegs;
+    /**
+     * Word-packed poison bitmap, indexed by flat register index.
+     * Each register class occupies a contiguous range of bits (see poisonRanges).
+     */
+    std::vector<uint64_t> poisonBits;
+
+    /** Flat index range [first, last) of each register class in the poison bitmap */
+    std::pair<size_t, size_t> poisonRanges[CCRegClass + 1];
+
+    /**
+     * Word-packed bitmap of registers holding values derived from a value predicted load,
+     * indexed by flat register index like the poison bitmap.
+     */
+    std::vector<uint64_t> predictedBits;
+
+    /** Count the set bits in the flat index range [first, last) of the poison bitmap */
+    size_t countPoisoned(size_t first, size_t last) const;
 
     /**
      * Number of physical general purpose registers
@@ -171,7 +187,7 @@ class PhysRegFile
         const RegClassType type = phys_reg->classValue();
         const RegIndex idx = phys_reg->index();
 
-        const char *poisoned = poisonedRegs[phys_reg->flatIndex()] ? " poisoned" : "";
+        const char *poisoned = isPoisoned(phys_reg->flatIndex()) ? " poisoned" : "";
         RegVal val;
         switch (type) {
           case IntRegClass:
@@ -321,14 +337,20 @@ class PhysRegFile
         }
     }
 
+    /** Check if a flat register index is poisoned */
+    bool
+    isPoisoned(RegIndex flatIdx) const
+    {
+        return (poisonBits[flatIdx / 64] >> (flatIdx % 64)) & 1;
+    }
+
     /** Check if a register is poisoned/invalid */
     bool
-    regPoisoned(PhysRegIdPtr physReg)
+    regPoisoned(PhysRegIdPtr physReg) const
     {
         if (physReg->classValue() == InvalidRegClass)
             return false;
-        const RegIndex idx = physReg->flatIndex();
-        return poisonedRegs[idx];
+        return isPoisoned(physReg->flatIndex());
     }
 
     /** Mark/unmark a register as poisoned/invalid */
@@ -345,7 +367,11 @@ class PhysRegFile
         if (physReg->classValue() == InvalidRegClass)
             return;
         const RegIndex flatIdx = physReg->flatIndex();
-        poisonedRegs[flatIdx] = poisoned;
+        const uint64_t bit = 1ULL << (flatIdx % 64);
+        if (poisoned)
+            poisonBits[flatIdx / 64] |= bit;
+        else
+            poisonBits[flatIdx / 64] &= ~bit;
     }
 
     /** Clear poison from all registers in the register file */
@@ -353,10 +379,51 @@ class PhysRegFile
     clearPoison()
     {
         DPRINTF(RunaheadRegFile, "Curing all poisoned registers.\n");
-        // totalNumRegs does not count misc regs
-        for (int regIdx = 0; regIdx < poisonedRegs.size(); regIdx++) {
-            poisonedRegs[regIdx] = false;
-        }
+        std::memset(poisonBits.data(), 0, poisonBits.size() * sizeof(uint64_t));
+    }
+
+    /** Check if a register holds a value derived from a value predicted load */
+    bool
+    regPredicted(PhysRegIdPtr physReg) const
+    {
+        if (physReg->classValue() == InvalidRegClass || physReg->classValue() == MiscRegClass)
+            return false;
+        const RegIndex flatIdx = physReg->flatIndex();
+        return (predictedBits[flatIdx / 64] >> (flatIdx % 64)) & 1;
+    }
+
+    /** Mark/unmark a register as holding a value derived from a value predicted load */
+    void
+    regPredicted(PhysRegIdPtr physReg, bool predicted)
+    {
+        if (physReg->classValue() == InvalidRegClass || physReg->classValue() == MiscRegClass)
+            return;
+        const RegIndex flatIdx = physReg->flatIndex();
+        const uint64_t bit = 1ULL << (flatIdx % 64);
+        if (predicted)
+            predictedBits[flatIdx / 64] |= bit;
+        else
+            predictedBits[flatIdx / 64] &= ~bit;
+    }
+
+    /** Clear the value predicted mark from all registers in the register file */
+    void
+    clearPredicted()
+    {
+        std::memset(predictedBits.data(), 0, predictedBits.size() * sizeof(uint64_t));
+    }
+
+    /** Number of poisoned registers in the register file */
+    size_t numPoisoned() const { return countPoisoned(0, totalNumRegs); }
+
+    /** Number of poisoned registers of a specific class */
+    size_t
+    numPoisoned(RegClassType type) const
+    {
+        // Misc regs can not be poisoned
+        if (type > CCRegClass)
+            return 0;
+        return countPoisoned(poisonRanges[type].first, poisonRanges[type].second);
     }
 
     /**
@@ -322,6 +322,20 @@ Rename::isDrained() const
     return true;
 }
 
+bool
+Rename::isStalled() const
+{
+    assert(numThreads == 1);
+    ThreadID tid = activeThreads->front();
+    return renameStatus[tid] == Blocked && insts[tid].empty();
+}
+
+void
+Rename::countStalledCycles(Cycles cycles)
+{
+    stats.blockCycles += cycles;
+}
+
 void
 Rename::takeOverFrom()
 {
@@ -1143,6 +1157,10 @@ Rename::renameDestRegs(const DynInstPtr &inst, ThreadID tid)
 int
 Rename::calcFreeROBEntries(ThreadID tid)
 {
+    // Precise runahead insts do not take up ROB entries
+    if (cpu->inPreciseRunahead(tid))
+        return renameWidth;
+
     int num_free = freeEntries[tid].robEntries -
                   (instsInProgress[tid] - fromIEW->iewInfo[tid].dispatched);
 
@@ -190,6 +190,12 @@ class Rename
     /** Has the stage drained? */
     bool isDrained() const;
 
+    /** Whether or not rename is blocked, only counting blocked cycles */
+    bool isStalled() const;
+
+    /** Count the stats of cycles the CPU skipped while rename was blocked */
+    void countStalledCycles(Cycles cycles);
+
     /** Takes over from another CPU's thread. */
     void takeOverFrom();
 
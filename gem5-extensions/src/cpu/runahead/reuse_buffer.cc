@@ -0,0 +1,248 @@
+#include "cpu/runahead/reuse_buffer.hh"
+
+#include "base/intmath.hh"
+#include "cpu/runahead/cpu.hh"
+#include "cpu/runahead/dyn_inst.hh"
+#include "debug/RunaheadReuse.hh"
+#include "params/BaseRunaheadCPU.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+RunaheadReuseBuffer::RunaheadReuseBuffer(CPU *_cpu, const BaseRunaheadCPUParams &params)
+    : cpu(_cpu),
+      enabled(params.enableRunahead && params.runaheadReuseBufferSize > 0),
+      indexMask(params.runaheadReuseBufferSize - 1),
+      stats(_cpu)
+{
+    fatal_if(enabled && !isPowerOf2(params.runaheadReuseBufferSize),
+             "Runahead reuse buffer size must be a power of 2.\n");
+    fatal_if(enabled && params.preciseRunahead,
+             "The runahead reuse buffer can not be used with precise runahead, "
+             "which does not re-execute pseudoretired instructions.\n");
+    fatal_if(enabled && params.runaheadBuffer,
+             "The runahead reuse buffer can not be used with the runahead buffer, "
+             "which replays chains out of program order.\n");
+
+    if (enabled)
+        table.resize(params.runaheadReuseBufferSize);
+
+    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
+        fillPosition[tid] = 0;
+        baseSeqNum[tid] = 0;
+        basePending[tid] = false;
+        active[tid] = false;
+    }
+}
+
+std::string
+RunaheadReuseBuffer::name() const
+{
+    return cpu->name() + ".reusebuffer";
+}
+
+bool
+RunaheadReuseBuffer::reusable(const DynInstPtr &inst)
+{
+    if (inst->isMemRef() || inst->isControl() || inst->isVector() || inst->isSerializing() ||
+        inst->isNonSpeculative() || inst->numDestRegs() == 0)
+        return false;
+
+    auto comparable = [](RegClassType type) {
+        return type == IntRegClass || type == FloatRegClass || type == CCRegClass;
+    };
+
+    for (int i = 0; i < inst->numSrcRegs(); i++) {
+        if (!comparable(inst->renamedSrcIdx(i)->classValue()))
+            return false;
+    }
+    for (int i = 0; i < inst->numDestRegs(); i++) {
+        if (!comparable(inst->renamedDestIdx(i)->classValue()))
+            return false;
+    }
+
+    return true;
+}
+
+void
+RunaheadReuseBuffer::startPeriod(ThreadID tid)
+{
+    if (!enabled)
+        return;
+
+    fillPosition[tid] = 0;
+    filteredSeqNums[tid].clear();
+    active[tid] = false;
+    basePending[tid] = false;
+
+    for (Entry &entry : table) {
+        if (entry.tid == tid)
+            entry.valid = false;
+    }
+}
+
+void
+RunaheadReuseBuffer::endPeriod(ThreadID tid)
+{
+    if (!enabled)
+        return;
+
+    DPRINTF(RunaheadReuse, "[tid:%i] Runahead period recorded %llu ops for reuse.\n",
+            tid, fillPosition[tid]);
+    filteredSeqNums[tid].clear();
+    basePending[tid] = true;
+}
+
+void
+RunaheadReuseBuffer::filtered(ThreadID tid, InstSeqNum seq_num)
+{
+    if (!enabled)
+        return;
+
+    assert(filteredSeqNums[tid].empty() || filteredSeqNums[tid].back() < seq_num);
+    filteredSeqNums[tid].push_back(seq_num);
+}
+
+void
+RunaheadReuseBuffer::pseudoretired(const DynInstPtr &inst)
+{
+    if (!enabled)
+        return;
+
+    ThreadID tid = inst->threadNumber;
+    // Normal mode refetches the ops filtered out before this one
+    std::deque<InstSeqNum> &holes = filteredSeqNums[tid];
+    while (!holes.empty() && holes.front() < inst->seqNum) {
+        holes.pop_front();
+        fillPosition[tid]++;
+    }
+    uint64_t position = fillPosition[tid]++;
+
+    // Results depending on the LLL or on a prediction are not the results normal mode will get
+    if (inst->isPoisoned() || inst->isPredicted() || !inst->readPredicate() ||
+        inst->getFault() != NoFault || !reusable(inst))
+        return;
+
+    Addr pc = inst->pcState().instAddr();
+    Entry &entry = table[index(pc, position)];
+    entry.valid = true;
+    entry.tid = tid;
+    entry.pc = pc;
+    entry.upc = inst->pcState().microPC();
+    entry.position = position;
+
+    entry.srcValues.resize(inst->numSrcRegs());
+    for (int i = 0; i < inst->numSrcRegs(); i++)
+        entry.srcValues[i] = cpu->getReg(inst->renamedSrcIdx(i));
+    entry.destValues.resize(inst->numDestRegs());
+    for (int i = 0; i < inst->numDestRegs(); i++)
+        entry.destValues[i] = cpu->getReg(inst->renamedDestIdx(i));
+
+    stats.inserted++;
+}
+
+void
+RunaheadReuseBuffer::squash(ThreadID tid, InstSeqNum seq_num, bool from_commit)
+{
+    if (!enabled)
+        return;
+
+    // Filtered ops on the squashed path are not refetched after exit either
+    if (cpu->inRunahead(tid)) {
+        std::deque<InstSeqNum> &holes = filteredSeqNums[tid];
+        while (!holes.empty() && holes.back() > seq_num)
+            holes.pop_back();
+        return;
+    }
+
+    // The first op fetched after the exit squash is the first op of the period.
+    // Decode squashes of runahead insts still in flight don't count, the exit squash drops them.
+    if (basePending[tid]) {
+        if (!from_commit)
+            return;
+
+        baseSeqNum[tid] = cpu->globalSeqNum;
+        basePending[tid] = false;
+        active[tid] = true;
+        DPRINTF(RunaheadReuse, "[tid:%i] Reusing runahead results from sn:%llu.\n",
+                tid, baseSeqNum[tid]);
+        return;
+    }
+
+    if (!active[tid])
+        return;
+
+    // The op after the squashing one will be refetched with the next sequence number
+    baseSeqNum[tid] += (int64_t)cpu->globalSeqNum - (int64_t)(seq_num + 1);
+}
+
+bool
+RunaheadReuseBuffer::reuse(const DynInstPtr &inst)
+{
+    ThreadID tid = inst->threadNumber;
+    if (!enabled || !active[tid] || inst->isRunahead())
+        return false;
+
+    int64_t position = (int64_t)inst->seqNum - baseSeqNum[tid];
+    if (position < 0 || (uint64_t)position >= fillPosition[tid] || !reusable(inst))
+        return false;
+
+    stats.lookups++;
+
+    Addr pc = inst->pcState().instAddr();
+    Entry &entry = table[index(pc, position)];
+    if (!entry.valid || entry.tid != tid || entry.pc != pc || entry.upc != inst->pcState().microPC() ||
+        entry.position != position || entry.srcValues.size() != inst->numSrcRegs() ||
+        entry.destValues.size() != inst->numDestRegs())
+        return false;
+
+    for (int i = 0; i < inst->numSrcRegs(); i++) {
+        if (cpu->getReg(inst->renamedSrcIdx(i)) != entry.srcValues[i]) {
+            DPRINTF(RunaheadReuse, "[tid:%i] [sn:%llu] Source %i of PC %s changed since runahead.\n",
+                    tid, inst->seqNum, i, inst->pcState());
+            stats.valueMismatches++;
+            entry.valid = false;
+            return false;
+        }
+    }
+
+    // Nothing reads the destinations until the op writes back, so they can be written now
+    for (int i = 0; i < inst->numDestRegs(); i++)
+        cpu->setReg(inst->renamedDestIdx(i), entry.destValues[i]);
+
+    DPRINTF(RunaheadReuse, "[tid:%i] [sn:%llu] Reusing runahead result of PC %s.\n",
+            tid, inst->seqNum, inst->pcState());
+    stats.hits++;
+    entry.valid = false;
+    return true;
+}
+
+void
+RunaheadReuseBuffer::savedCycles(Cycles latency)
+{
+    stats.cyclesSaved += latency - 1;
+}
+
+RunaheadReuseBuffer::ReuseBufferStats::ReuseBufferStats(CPU *cpu)
+    : statistics::Group(cpu, "reusebuffer"),
+      ADD_STAT(inserted, statistics::units::Count::get(),
+           "Number of pseudoretired results recorded for reuse"),
+      ADD_STAT(lookups, statistics::units::Count::get(),
+           "Number of normal mode ops looked up in the reuse buffer"),
+      ADD_STAT(hits, statistics::units::Count::get(),
+           "Number of normal mode ops that reused a runahead result"),
+      ADD_STAT(valueMismatches, statistics::units::Count::get(),
+           "Number of lookups whose source values changed since runahead"),
+      ADD_STAT(cyclesSaved, statistics::units::Cycle::get(),
+           "Number of execution cycles saved by reusing runahead results"),
+      ADD_STAT(hitRate, statistics::units::Ratio::get(),
+           "Fraction of reuse buffer lookups that reused a result",
+           hits / lookups)
+{
+    hitRate.precision(6);
+}
+
+} // namespace runahead
+} // namespace gem5
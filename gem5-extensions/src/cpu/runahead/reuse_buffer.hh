@@ -0,0 +1,148 @@
+#ifndef __CPU_RUNAHEAD_REUSE_BUFFER_HH__
+#define __CPU_RUNAHEAD_REUSE_BUFFER_HH__
+
+#include <deque>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/runahead/dyn_inst_ptr.hh"
+#include "cpu/runahead/limits.hh"
+
+namespace gem5
+{
+
+struct BaseRunaheadCPUParams;
+
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * Holds the results of valid instructions pseudoretired in runahead, so they need not be
+ * executed again once the instructions are refetched after runahead exits.
+ *
+ * Every op pseudoretired in a period gets a sequence position, starting at 0 with the first
+ * op of the period. Ops filtered out by fetch in runahead leave a hole, so positions follow
+ * the program order normal mode refetches. After exit, the position of a normal mode op is
+ * its distance in sequence numbers from the first op fetched after exit, kept aligned across
+ * squashes.
+ * Entries are indexed by PC and position.
+ *
+ * A normal mode op reuses the result of its entry if the values of its source operands are
+ * the same as they were in runahead. Only register to register ops are reused, so the
+ * results are a function of the source operands alone.
+ */
+class RunaheadReuseBuffer
+{
+  private:
+    struct Entry
+    {
+        bool valid = false;
+        ThreadID tid = 0;
+        Addr pc = 0;
+        MicroPC upc = 0;
+        /** Sequence position of the op in its runahead period */
+        uint64_t position = 0;
+        std::vector<RegVal> srcValues;
+        std::vector<RegVal> destValues;
+    };
+
+    /** Pointer to the CPU */
+    CPU *cpu;
+
+    /** Whether or not the reuse buffer is enabled */
+    bool enabled;
+
+    /** Result table, direct mapped */
+    std::vector<Entry> table;
+
+    /** Mask to turn a PC and position hash into a table index */
+    const uint64_t indexMask;
+
+    /** Sequence position of the next op pseudoretired in the current period */
+    uint64_t fillPosition[MaxThreads];
+
+    /** Sequence numbers of the ops filtered out by fetch that are not accounted for yet */
+    std::deque<InstSeqNum> filteredSeqNums[MaxThreads];
+
+    /** Sequence number of the op at position 0 after exit */
+    int64_t baseSeqNum[MaxThreads];
+
+    /** Whether or not the base is set by the next squash from commit, which is the exit squash */
+    bool basePending[MaxThreads];
+
+    /** Whether or not normal mode can reuse results */
+    bool active[MaxThreads];
+
+    uint64_t
+    index(Addr pc, uint64_t position) const
+    {
+        return (pc ^ (pc >> 12) ^ (position * 0x9e3779b1)) & indexMask;
+    }
+
+    /** Whether or not the op only reads and writes registers that can be compared */
+    static bool reusable(const DynInstPtr &inst);
+
+  public:
+    RunaheadReuseBuffer(CPU *_cpu, const BaseRunaheadCPUParams &params);
+
+    /** Returns the name of the reuse buffer */
+    std::string name() const;
+
+    /** Whether or not the reuse buffer is enabled */
+    bool isEnabled() const { return enabled; }
+
+    /** A thread entered runahead. Drop the results of its previous period */
+    void startPeriod(ThreadID tid);
+
+    /** A thread exited runahead. Results can be reused once the exit squash realigns */
+    void endPeriod(ThreadID tid);
+
+    /** Fetch filtered out a runahead op, which still takes a sequence position */
+    void filtered(ThreadID tid, InstSeqNum seq_num);
+
+    /** An op was pseudoretired. Record its results if they are valid */
+    void pseudoretired(const DynInstPtr &inst);
+
+    /**
+     * Fetch squashed everything younger than seq_num and refetches from the next
+     * sequence number. Realign sequence positions, or drop squashed holes in runahead.
+     */
+    void squash(ThreadID tid, InstSeqNum seq_num, bool from_commit);
+
+    /**
+     * A normal mode op is about to issue. If a matching entry has the same source values,
+     * write its results to the op's destination registers and return true.
+     */
+    bool reuse(const DynInstPtr &inst);
+
+    /** Account for the cycles saved by reusing an op with the given latency */
+    void savedCycles(Cycles latency);
+
+  private:
+    struct ReuseBufferStats : public statistics::Group
+    {
+        ReuseBufferStats(CPU *cpu);
+
+        /** Results recorded at pseudoretire */
+        statistics::Scalar inserted;
+        /** Normal mode ops looked up */
+        statistics::Scalar lookups;
+        /** Lookups with a matching entry and source values */
+        statistics::Scalar hits;
+        /** Lookups with a matching entry but different source values */
+        statistics::Scalar valueMismatches;
+        /** Execution cycles not spent because of reuse */
+        statistics::Scalar cyclesSaved;
+        /** Fraction of lookups that reused a result */
+        statistics::Formula hitRate;
+    } stats;
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_REUSE_BUFFER_HH__
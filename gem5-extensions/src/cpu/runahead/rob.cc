@@ -210,7 +210,8 @@ ROB::countInsts(ThreadID tid)
 }
 
 void
-ROB::generateChainBuffer(const DynInstPtr &inst, std::vector<PCPair> &buffer)
+ROB::generateChainBuffer(const DynInstPtr &inst, std::vector<PCPair> &buffer,
+                         std::vector<DynInstPtr> *chainInsts)
 {
     DPRINTF(RunaheadROB, "Attempting to generate dependence chain for sn:%llu\n",
             inst->seqNum);
@@ -253,6 +254,8 @@ ROB::generateChainBuffer(const DynInstPtr &inst, std::vector<PCPair> &buffer)
 
     // Add the younger inst to the chain
     buffer.emplace_back((*youngerPos)->pcState());
+    if (chainInsts)
+        chainInsts->push_back(*youngerPos);
     _instChain.push_back((*youngerPos)->staticInst->disassemble((*youngerPos)->pcState().instAddr()));
     DPRINTF(RunaheadROB, "Adding sn:%llu to dependence chain (size: %i): %s\n",
             (*youngerPos)->seqNum, buffer.size(),
@@ -306,6 +309,8 @@ ROB::generateChainBuffer(const DynInstPtr &inst, std::vector<PCPair> &buffer)
                 bool inChain = std::find(buffer.begin(), buffer.end(), inst->pcState()) == buffer.end();
                if (inChain) {
                     buffer.emplace_back(inst->pcState());
+                    if (chainInsts)
+                        chainInsts->push_back(inst);
                     _instChain.push_back(inst->staticInst->disassemble(inst->pcState().instAddr()));
                     DPRINTF(RunaheadROB, "Adding sn:%llu to dependence chain (size: %i): %s\n",
                             inst->seqNum, buffer.size(),
@@ -354,6 +359,8 @@ ROB::generateChainBuffer(const DynInstPtr &inst, std::vector<PCPair> &buffer)
                 inChain = std::find(buffer.begin(), buffer.end(), prodStore->pcState()) == buffer.end();
                 if (inChain) {
                     buffer.emplace_back(prodStore->pcState());
+                    if (chainInsts)
+                        chainInsts->push_back(prodStore);
                     _instChain.push_back(prodStore->staticInst->disassemble(prodStore->pcState().instAddr()));
                     DPRINTF(RunaheadROB, "Adding sn:%llu to dependence chain (size: %i): %s\n",
                             prodStore->seqNum, buffer.size(),
@@ -411,7 +418,7 @@ InstSeqNum
 ROB::findChainTail(ThreadID tid, int n)
 {
     for (InstIt it = instList[tid].begin(); it != instList[tid].end(); it++) {
-        if (cpu->runaheadChain.back() == (*it)->pcState()) {
+        if (cpu->runaheadChain[tid].back() == (*it)->pcState()) {
             n--;
             if (n <= 0)
                 return (*it)->seqNum;
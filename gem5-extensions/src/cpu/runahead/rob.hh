@@ -285,8 +285,12 @@ class ROB
      */
     size_t countInsts(ThreadID tid);
 
-    /** Try to generate the dependency chain for a given instruction */
-    void generateChainBuffer(const DynInstPtr &inst, std::vector<PCPair> &buffer);
+    /**
+     * Try to generate the dependency chain for a given instruction.
+     * If chainInsts is given, the ROB instructions making up the chain are also placed in it.
+     */
+    void generateChainBuffer(const DynInstPtr &inst, std::vector<PCPair> &buffer,
+                             std::vector<DynInstPtr> *chainInsts = nullptr);
 
     /** Try to find the youngest valid, unsent load in the ROB. Returns 0 if there are none. */
     InstSeqNum findUnsentValidLoad(ThreadID tid, int limit = -1);
@@ -1,126 +1,209 @@
+#include <algorithm>
 #include <vector>
 
 #include "cpu/runahead/runahead_buffer.hh"
+#include "cpu/runahead/cpu.hh"
+#include "cpu/runahead/decode.hh"
 #include "cpu/runahead/dyn_inst.hh"
-#include "cpu/runahead/lsq_unit.hh"
+#include "debug/RunaheadBuffer.hh"
+#include "params/BaseRunaheadCPU.hh"
 
 namespace gem5
 {
 namespace runahead
 {
 
-Cycles
-RunaheadBuffer::generateDependenceChain(DynInstPtr inst)
+RunaheadBuffer::DepChainEntry::DepChainEntry(const DynInstPtr &inst)
+    : staticInst(inst->staticInst), macroOp(inst->macroop),
+      pc(inst->pcState().clone()), nextPC(inst->pcState().clone())
 {
-    ThreadID tid = inst->threadNumber;
-    Addr instPC = inst->pcState().instAddr();
-
-    assert(rob->readHeadInst(tid) == inst);
+    staticInst->advancePC(*nextPC);
+}
 
-    // First pass, try to find an inst with the same PC (i.e. if the chain can be generated at all)
-    auto effectiveEnd = rob->end(tid);
-    bool canGenerateChain = false;
-    for (auto i = ++rob->begin(tid); i != rob->end(tid); i++) {
-        DynInstPtr robInst = *i;
+RunaheadBuffer::RunaheadBuffer(CPU *_cpu, const BaseRunaheadCPUParams &params)
+    : cpu(_cpu),
+      decode(nullptr),
+      decodeQueue(nullptr),
+      enabled(params.enableRunahead && params.filteredRunahead && params.runaheadBuffer),
+      maxChainLength(params.runaheadBufferSize),
+      width(params.decodeWidth),
+      numThreads(params.numThreads),
+      stats(_cpu, maxChainLength)
+{
+    fatal_if(params.runaheadBuffer && !params.filteredRunahead,
+             "The runahead buffer requires filtered runahead to be enabled.\n");
 
-        if (robInst->pcState().instAddr() == instPC) {
-            effectiveEnd = i;
-            canGenerateChain = true;
-        }
+    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
+        active[tid] = false;
+        chainIdx[tid] = 0;
     }
+}
+
+std::string
+RunaheadBuffer::name() const
+{
+    return cpu->name() + ".runaheadbuffer";
+}
+
+void
+RunaheadBuffer::setDecodeQueue(TimeBuffer<DecodeStruct> *dq_ptr)
+{
+    decodeQueue = dq_ptr;
 
-    if (!canGenerateChain)
-        return Cycles(0);
+    // The buffer takes the place of decode, so it writes to the same slot as decode does
+    toRename = decodeQueue->getWire(0);
+}
+
+bool
+RunaheadBuffer::activate(ThreadID tid, std::vector<DynInstPtr> &chainInsts)
+{
+    assert(enabled && !active[tid]);
 
-    // Setup the source register search list (SRSL) and dependence chain
-    SRSL srsl;
-    DepChain chain;
+    if (chainInsts.empty())
+        return false;
 
-    // Add inst to dependence chain and enqueue all source regs
-    std::unique_ptr<PCStateBase> pc(inst->pcState().clone());
-    chain.emplace_back(tid, inst->staticInst, inst->macroop, pc);
-    for (int i = 0; i < inst->numSrcRegs(); i++) {
-        PhysRegIdPtr physReg = inst->renamedSrcIdx(i);
-        srsl.push(physReg);
+    if (chainInsts.size() > maxChainLength) {
+        DPRINTF(RunaheadBuffer, "[tid:%i] Chain of %i insts does not fit in the buffer (%i).\n",
+                tid, chainInsts.size(), maxChainLength);
+        stats.chainsTooLong++;
+        return false;
     }
 
-    // Generate dep chain by iteratively searching the ROB for register producers
-    // Use effectiveEnd to search between the head and the oldest re-occurence of the inst in the ROB
-    iterativeDCGen(tid, effectiveEnd, chain, srsl);
-    stats.chainLength.sample(chain.size());
+    // The chain is generated back to front by following register producers,
+    // so put it back into program order before replaying it
+    std::sort(chainInsts.begin(), chainInsts.end(),
+        [](const DynInstPtr &a, const DynInstPtr &b) { return a->seqNum < b->seqNum; });
+
+    chain[tid].clear();
+    for (const DynInstPtr &inst : chainInsts) {
+        DPRINTF(RunaheadBuffer, "[tid:%i] Adding PC %s to the buffer: %s\n",
+                tid, inst->pcState(),
+                inst->staticInst->disassemble(inst->pcState().instAddr()));
+        chain[tid].emplace_back(inst);
+    }
+
+    chainIdx[tid] = 0;
+    active[tid] = true;
+
+    stats.chainLength.sample(chain[tid].size());
+    stats.activations++;
+
+    DPRINTF(RunaheadBuffer, "[tid:%i] Runahead buffer activated with %i insts. "
+            "Gating fetch and decode.\n", tid, chain[tid].size());
 
-    // Should have taken as many cycles as there are insts in the DC,
-    // excluding the first "initialization" cycle
-    int cycles = (chain.size() - 1);
-    return Cycles(cycles);
+    return true;
 }
 
 void
-RunaheadBuffer::iterativeDCGen(ThreadID tid, ROBIt effectiveEnd, DepChain &chain, SRSL &srsl)
+RunaheadBuffer::deactivate(ThreadID tid)
 {
-    while (!srsl.empty() && chain.size() < maxDCLength) {
-        PhysRegIdPtr curSrcReg = srsl.front();
-
-        // ++ to skip the inst we're doing the DC generation for
-        bool producerFound = false;
-        for (auto i = ++rob->begin(tid); i != effectiveEnd; i++) {
-            DynInstPtr robInst = *i;
-            if (robInst->isControl())
-                continue;
-
-            // Check if the inst produces the source reg from the SRSL
-            for (int j = 0; j < robInst->numDestRegs(); j++) {
-                if (robInst->renamedDestIdx(j) == curSrcReg) {
-                    std::unique_ptr<PCStateBase> pc(robInst->pcState().clone());
-                    chain.emplace_back(
-                        robInst->threadNumber,
-                        robInst->staticInst,
-                        robInst->macroop,
-                        pc
-                    );
-
-                    // Add all of its source registers to the SRSL
-                    for (int k = 0; k < robInst->numSrcRegs(); k++) {
-                        PhysRegIdPtr physReg = robInst->renamedSrcIdx(k);
-                        srsl.push(physReg);
-                    }
-
-                    // If it was a load, search the SQ by load address for any stores
-                    // producing the address, so we can add those stores to the chain as well
-                    if (robInst->isLoad() && robInst->effAddrValid())
-                        searchForMemProducers(tid, robInst->effAddr, chain, srsl);
-
-                    producerFound = true;
-                    break;
-                }
-            }
+    if (!active[tid])
+        return;
+
+    DPRINTF(RunaheadBuffer, "[tid:%i] Runahead buffer deactivated.\n", tid);
+
+    active[tid] = false;
+    chain[tid].clear();
+    chainIdx[tid] = 0;
+}
+
+void
+RunaheadBuffer::tick()
+{
+    if (!enabled)
+        return;
+
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        if (!active[tid])
+            continue;
+
+        ++stats.activeCycles;
 
-            if (producerFound)
-                break;
+        // Obey the same stall and squash signals decode would
+        if (!decode->canSendToRename(tid)) {
+            DPRINTF(RunaheadBuffer, "[tid:%i] Rename is stalled or squashing, not supplying insts.\n",
+                    tid);
+            ++stats.stallCycles;
+            continue;
         }
 
-        srsl.pop();
+        // Other threads may have used some of the bandwidth through decode
+        while (toRename->size < (int)width) {
+            supplyInst(tid, chain[tid][chainIdx[tid]]);
+
+            if (++chainIdx[tid] == chain[tid].size()) {
+                chainIdx[tid] = 0;
+                ++stats.chainLoops;
+            }
+        }
     }
 }
 
 void
-RunaheadBuffer::searchForMemProducers(ThreadID tid, Addr addr, DepChain &chain, SRSL &srsl)
+RunaheadBuffer::supplyInst(ThreadID tid, const DepChainEntry &entry)
 {
-    const LSQUnit &lsqUnit = lsq->getUnit(tid);
-    LSQUnit::StoreQueue sq = lsqUnit.storeQueue;
+    InstSeqNum seq = cpu->getAndIncrementInstSeq();
+
+    DynInst::Arrays arrays;
+    arrays.numSrcs = entry.staticInst->numSrcRegs();
+    arrays.numDests = entry.staticInst->numDestRegs();
+    arrays.allocator = &cpu->dynInstAllocator;
+
+    DynInstPtr inst = new (arrays) DynInst(
+            arrays, entry.staticInst, entry.macroOp, *entry.pc, *entry.nextPC, seq, cpu);
+    inst->setTid(tid);
+    inst->setThreadState(cpu->thread[tid]);
+    inst->setRunahead();
+    inst->traceData = NULL;
+
+    // Same as decode, insts without sources can issue at any time
+    if (inst->numSrcRegs() == 0)
+        inst->setCanIssue();
+
+    inst->setWindowPos(cpu->addInst(inst));
+
+    DPRINTF(RunaheadBuffer, "[tid:%i] Supplying [sn:%llu] PC %s to rename.\n",
+            tid, inst->seqNum, inst->pcState());
 
+    toRename->insts[toRename->size++] = inst;
+    ++stats.instsSupplied;
 
+    cpu->activityThisCycle();
 }
 
-RunaheadBuffer::RunaheadBufferStats::RunaheadBufferStats(statistics::Group *parent)
-    : statistics::Group(parent, "runaheadbuffer"),
+RunaheadBuffer::RunaheadBufferStats::RunaheadBufferStats(CPU *cpu,
+                                                         unsigned maxChainLength)
+    : statistics::Group(cpu, "runaheadbuffer"),
       ADD_STAT(chainLength, statistics::units::Count::get(),
-           "Lengths of dependence chains")
+           "Lengths of dependence chains placed in the runahead buffer"),
+      ADD_STAT(chainsTooLong, statistics::units::Count::get(),
+           "Number of dependence chains that did not fit in the runahead buffer"),
+      ADD_STAT(activations, statistics::units::Count::get(),
+           "Number of runahead periods in which the runahead buffer supplied rename"),
+      ADD_STAT(activeCycles, statistics::units::Cycle::get(),
+           "Number of cycles the runahead buffer was active (fetch/decode gated)"),
+      ADD_STAT(stallCycles, statistics::units::Cycle::get(),
+           "Number of active cycles the runahead buffer was stalled by rename"),
+      ADD_STAT(instsSupplied, statistics::units::Count::get(),
+           "Number of instructions supplied to rename by the runahead buffer"),
+      ADD_STAT(chainLoops, statistics::units::Count::get(),
+           "Number of times the runahead buffer reset to the head of the chain"),
+      ADD_STAT(supplyRate, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Cycle>::get(),
+           "Chain instructions supplied to rename per active cycle",
+           instsSupplied / activeCycles)
 {
     chainLength
-        .init(0, maxDCLength, 8)
+        .init(0, maxChainLength, 8)
         .flags(statistics::total);
+    chainsTooLong.prereq(chainsTooLong);
+    activations.prereq(activations);
+    activeCycles.prereq(activeCycles);
+    stallCycles.prereq(stallCycles);
+    instsSupplied.prereq(instsSupplied);
+    chainLoops.prereq(chainLoops);
+    supplyRate.precision(6);
 }
 
 } // namespace runahead
-} // namespace gem5
\ No newline at end of file
+} // namespace gem5
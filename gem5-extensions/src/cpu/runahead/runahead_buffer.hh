@@ -1,90 +1,152 @@
-#ifndef _CPU_RUNAHEAD_RUNAHEAD_BUFFER_HH__
-#define _CPU_RUNAHEAD_RUNAHEAD_BUFFER_HH__
+#ifndef __CPU_RUNAHEAD_RUNAHEAD_BUFFER_HH__
+#define __CPU_RUNAHEAD_RUNAHEAD_BUFFER_HH__
 
+#include <memory>
 #include <vector>
-#include <queue>
 
+#include "arch/generic/pcstate.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/runahead/comm.hh"
-#include "cpu/timebuf.hh"
-#include "cpu/reg_class.hh"
-#include "cpu/runahead/rob.hh"
 #include "cpu/runahead/dyn_inst_ptr.hh"
+#include "cpu/runahead/limits.hh"
+#include "cpu/static_inst.hh"
+#include "cpu/timebuf.hh"
 
 namespace gem5
 {
+
+struct BaseRunaheadCPUParams;
+
 namespace runahead
 {
 
+class CPU;
+class Decode;
+
 /**
  * The runahead buffer replaces fetch/decode, i.e. the processor frontend, while the processor
  * is in runahead mode. This is the same structure as in Hashemi and Patt's
  * "Filtered Runahead Execution with a Runahead Buffer" (2015).
- * 
+ *
  * It contains slices of code that generate addresses for long latency loads. When the processor
  * is in runahead mode, fetch and decode are de-activated. Instead, the runahead buffer is
  * activated to supply instructions to rename.
- * 
+ *
  * Instructions are supplied from the dependence chain corresponding to the load that caused
  * entry into runahead. Once the chain has finished executing (i.e. the final load is sent to rename),
  * we start over at the first instruction of the dependence chain, thereby executing in a loop.
+ *
+ * The chain itself is generated by the ROB (see ROB::generateChainBuffer), so the buffer and
+ * filtered fetch always operate on identical chains.
 */
 class RunaheadBuffer
 {
-private:
+  private:
     /** Contains all info necessary to generate a dynamic inst */
     struct DepChainEntry
     {
-        ThreadID tid;
         StaticInstPtr staticInst;
         StaticInstPtr macroOp;
         std::unique_ptr<PCStateBase> pc;
+        std::unique_ptr<PCStateBase> nextPC;
+
+        DepChainEntry(const DynInstPtr &inst);
     };
     typedef std::vector<DepChainEntry> DepChain;
-    typedef std::queue<PhysRegIdPtr> SRSL;
-    typedef std::list<DynInstPtr>::iterator ROBIt;
-
-    /**
-     * Maximum dependence chain length, in amount of instructions.
-     * TODO: parametrize
-    */
-    static const size_t maxDCLength = 32;
 
     /** Pointer to the CPU */
     CPU *cpu;
 
-    /** Pointer to the ROB */
-    ROB *rob;
+    /** Pointer to the decode stage, used to obey the stall signals from rename */
+    Decode *decode;
 
-    /** Pointer to the LSQ */
-    LSQ *lsq;
+    /** Decode queue, which the buffer writes into in place of decode. */
+    TimeBuffer<DecodeStruct> *decodeQueue;
 
     /** Wire used to write instructions to rename. */
     TimeBuffer<DecodeStruct>::wire toRename;
 
-public:
+    /** Whether or not the runahead buffer is enabled at all */
+    bool enabled;
+
+    /** Maximum dependence chain length, in amount of instructions. */
+    const unsigned maxChainLength;
+
+    /** Width of the buffer, in instructions per cycle. Matches decode width. */
+    const unsigned width;
+
+    /** Number of threads */
+    ThreadID numThreads;
+
+    /** Whether or not the buffer is supplying instructions to rename for a thread */
+    bool active[MaxThreads];
+
+    /** The dependence chain being replayed for each thread */
+    DepChain chain[MaxThreads];
+
+    /** Position of the next chain instruction to supply */
+    size_t chainIdx[MaxThreads];
+
+  public:
+    RunaheadBuffer(CPU *_cpu, const BaseRunaheadCPUParams &params);
+
+    /** Returns the name of the runahead buffer. */
+    std::string name() const;
+
+    /** Sets the decode queue the buffer writes to. */
+    void setDecodeQueue(TimeBuffer<DecodeStruct> *dq_ptr);
+
+    /** Sets the pointer to the decode stage. */
+    void setDecodeStage(Decode *decode_stage) { decode = decode_stage; }
+
+    /** Whether or not the runahead buffer is enabled */
+    bool isEnabled() const { return enabled; }
+
+    /** Whether or not the buffer is currently supplying instructions for a thread */
+    bool isActive(ThreadID tid) const { return active[tid]; }
+
     /**
-     * Generate the dependence chain of the given instruction using the instructions in the ROB.
-     * 
-     * The return value is the amount of instructions in the dependence chain, corresponding to
-     * how long it would take to generate the chain by iteratively searching the ROB (1 inst/cycle).
-    */
-    Cycles generateDependenceChain(DynInstPtr inst);
+     * Fill the buffer with the given dependence chain and start supplying it to rename.
+     * The instructions may be given in any order, they are replayed in program order.
+     * Returns false if the chain could not be placed in the buffer.
+     */
+    bool activate(ThreadID tid, std::vector<DynInstPtr> &chainInsts);
 
-private:
-    void iterativeDCGen(ThreadID tid, ROBIt effectiveEnd, DepChain &chain, SRSL &srsl);
+    /** Stop supplying instructions and clear the buffer. */
+    void deactivate(ThreadID tid);
 
-    void searchForMemProducers(ThreadID tid, Addr addr, DepChain &chain, SRSL &srsl);
+    /** Supply instructions from the active dependence chains to rename. */
+    void tick();
+
+  private:
+    /** Build a dynamic instruction from a chain entry and place it in the decode queue */
+    void supplyInst(ThreadID tid, const DepChainEntry &entry);
 
     struct RunaheadBufferStats : public statistics::Group
     {
-        RunaheadBufferStats(statistics::Group *parent);
+        RunaheadBufferStats(CPU *cpu, unsigned maxChainLength);
 
-        /** Dependence chain lengths */
+        /** Dependence chain lengths placed in the buffer */
         statistics::Distribution chainLength;
+        /** Number of chains that did not fit in the buffer */
+        statistics::Scalar chainsTooLong;
+        /** Number of runahead periods in which the buffer was used */
+        statistics::Scalar activations;
+        /** Cycles the buffer was supplying instructions */
+        statistics::Scalar activeCycles;
+        /** Cycles the buffer could not supply instructions because rename was stalled */
+        statistics::Scalar stallCycles;
+        /** Instructions supplied to rename */
+        statistics::Scalar instsSupplied;
+        /** Number of times the buffer started over at the head of the chain */
+        statistics::Scalar chainLoops;
+        /** Instructions supplied to rename per active cycle */
+        statistics::Formula supplyRate;
     } stats;
-}
+};
 
 } // namespace runahead
-} // namespace gem5
\ No newline at end of file
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_RUNAHEAD_BUFFER_HH__
@@ -2,6 +2,7 @@
 #include "cpu/runahead/dyn_inst.hh"
 #include "cpu/runahead/lsq.hh"
 #include "base/intmath.hh"
+#include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/RCache.hh"
 
@@ -12,18 +13,32 @@ namespace runahead
 
 using LSQRequest = LSQ::LSQRequest;
 
-RunaheadCache::RunaheadCache(const std::string &name, statistics::Group *statsParent, uint64_t size, uint8_t blockSize)
+RunaheadCache::RunaheadCache(const std::string &name, statistics::Group *statsParent, uint64_t size,
+                             uint8_t blockSize, unsigned assoc, const std::string &replPolicy,
+                             Cycles latency)
     : _name(name),
     size(size), blockSize(blockSize),
     numBlocks(size / blockSize),
+    assoc(assoc),
+    numSets(numBlocks / assoc),
+    replPolicy(replPolicy == "Random" ? Random : LRU),
+    latency(latency),
+    accessCounter(0),
     indexShift(ceilLog2(blockSize)),
     // instead of pow2
-    indexMask((1 << ceilLog2(numBlocks)) - 1),
-    tagShift(indexShift + ceilLog2(numBlocks)),
-    rCacheStats(statsParent)
+    indexMask((1 << ceilLog2(numSets)) - 1),
+    tagShift(indexShift + ceilLog2(numSets)),
+    rCacheStats(statsParent, assoc)
 {
+    fatal_if(replPolicy != "LRU" && replPolicy != "Random",
+             "Invalid runahead cache replacement policy '%s'! Must be one of: LRU, Random.\n",
+             replPolicy);
+    fatal_if(assoc == 0 || numBlocks % assoc != 0,
+             "Runahead cache associativity (%u) must evenly divide the amount of blocks (%llu)!\n",
+             assoc, numBlocks);
+
     // not a disaster since we use ceiling log2, but it does lead to some wasted bit real estate
-    warn_if(!isPowerOf2(numBlocks), "Amount of runahead cache blocks should be a power of 2! Check cache size.\n");
+    warn_if(!isPowerOf2(numSets), "Amount of runahead cache sets should be a power of 2! Check cache size.\n");
 
     for (int idx = 0; idx < numBlocks; idx++) {
         cacheEntries.emplace_back(new uint8_t[blockSize], (uint64_t)0, false, false);
@@ -40,26 +55,50 @@ RunaheadCache::~RunaheadCache()
 RunaheadCache::CacheBlock*
 RunaheadCache::getBlock(Addr addr)
 {
-    uint64_t idx = getIndex(addr);
-    CacheBlock block = cacheEntries[idx];
-    if (block.tag == getTag(addr)) {
-        return &cacheEntries[idx];
+    uint64_t setBase = getIndex(addr) * assoc;
+    uint64_t tag = getTag(addr);
+    for (unsigned way = 0; way < assoc; way++) {
+        CacheBlock &block = cacheEntries[setBase + way];
+        if (block.valid && block.tag == tag)
+            return &block;
     }
 
     return nullptr;
 }
 
+RunaheadCache::CacheBlock*
+RunaheadCache::findVictim(Addr addr)
+{
+    uint64_t setBase = getIndex(addr) * assoc;
+
+    // Prefer invalid blocks, there's no need to evict anything
+    for (unsigned way = 0; way < assoc; way++) {
+        if (!cacheEntries[setBase + way].valid)
+            return &cacheEntries[setBase + way];
+    }
+
+    if (replPolicy == Random)
+        return &cacheEntries[setBase + random_mt.random<unsigned>(0, assoc - 1)];
+
+    CacheBlock *victim = &cacheEntries[setBase];
+    for (unsigned way = 1; way < assoc; way++) {
+        if (cacheEntries[setBase + way].lastTouch < victim->lastTouch)
+            victim = &cacheEntries[setBase + way];
+    }
+    return victim;
+}
+
 bool
 RunaheadCache::lookup(Addr addr)
 {
-    uint64_t idx = getIndex(addr);
-    CacheBlock block = cacheEntries[idx];
+    CacheBlock *block = getBlock(addr);
 
-    DPRINTF(RCache, "R-cache lookup on block %llu (addr %#x). Tag: %i, valid: %i, poisoned: %i\n",
-            idx, align(addr), (block.tag == getTag(addr)), block.valid, block.poisoned);
+    DPRINTF(RCache, "R-cache lookup on set %llu (addr %#x). Hit: %i, way: %i, poisoned: %i\n",
+            getIndex(addr), align(addr), block != nullptr,
+            block ? (int)getWay(block) : -1, block ? block->poisoned : false);
 
     ++rCacheStats.lookups;
-    return ((block.tag == getTag(addr)) && block.valid);
+    return block != nullptr;
 }
 
 void
@@ -68,18 +107,25 @@ RunaheadCache::write(PacketPtr pkt)
     assert(pkt->isWrite());
 
     Addr addr = pkt->getAddr();
-    DPRINTF(RCache, "Performing R-cache write to block %llu (addr %#x, unaligned %#x).\n",
+    DPRINTF(RCache, "Performing R-cache write to set %llu (addr %#x, unaligned %#x).\n",
             getIndex(addr), align(addr), addr);
 
-    CacheBlock &block = cacheEntries[getIndex(addr)];
-    if ((block.tag != getTag(addr)) && block.valid) {
-        DPRINTF(RCache, "Write conflicted. Evicting old entry by overwrite. "
-                        "old tag: %#x poisoned: %i\n", block.tag, block.poisoned);
-
-        ++rCacheStats.writeConflicts;
-        if (block.poisoned)
-            ++rCacheStats.writeCleanses;
+    CacheBlock *blockPtr = getBlock(addr);
+    if (!blockPtr) {
+        blockPtr = findVictim(addr);
+        if (blockPtr->valid) {
+            DPRINTF(RCache, "Write conflicted. Evicting way %i. "
+                            "old tag: %#x poisoned: %i\n",
+                            getWay(blockPtr), blockPtr->tag, blockPtr->poisoned);
+
+            ++rCacheStats.writeConflicts;
+            if (blockPtr->poisoned)
+                ++rCacheStats.writeCleanses;
+        }
+        ++rCacheStats.wayFills[getWay(blockPtr)];
     }
+    CacheBlock &block = *blockPtr;
+    touch(blockPtr);
 
     block.tag = getTag(addr);
     block.valid = true;
@@ -105,7 +151,7 @@ RunaheadCache::read(PacketPtr pkt)
     assert(pkt->isRead());
 
     Addr addr = pkt->getAddr();
-    DPRINTF(RCache, "Performing R-cache read of block %llu (addr %#x, unaligned %#x)\n",
+    DPRINTF(RCache, "Performing R-cache read of set %llu (addr %#x, unaligned %#x)\n",
             getIndex(addr), align(addr), addr);
 
     if (!lookup(addr)) {
@@ -115,25 +161,27 @@ RunaheadCache::read(PacketPtr pkt)
     }
 
     ++rCacheStats.readHits;
-    CacheBlock block = cacheEntries[getIndex(addr)];
-    pkt->setDataFromBlock(block.data, blockSize);
+    CacheBlock *block = getBlock(addr);
+    ++rCacheStats.wayHits[getWay(block)];
+    touch(block);
+    pkt->setDataFromBlock(block->data, blockSize);
 
-    if (block.poisoned) {
+    if (block->poisoned) {
         LSQRequest *req = dynamic_cast<LSQRequest*>(pkt->senderState);
         DPRINTF(RCache, "Cache block was poisoned, marking request as poisoned.\n");
         req->setPoisoned();
     }
 
-    return block.data;
+    return block->data;
 }
 
 void
 RunaheadCache::poisonBlock(Addr addr)
 {
     DPRINTF(RCache, "R-cache poisoning block %#x\n", align(addr));
-    CacheBlock block = cacheEntries[getIndex(addr)];
-    if (block.tag == getTag(addr))
-        block.poisoned = true;
+    CacheBlock *block = getBlock(addr);
+    if (block)
+        block->poisoned = true;
 
     ++rCacheStats.poisons;
 }
@@ -142,7 +190,10 @@ void
 RunaheadCache::invalidateCache()
 {
     DPRINTF(RCache, "Invalidating (entire) r-cache.\n");
-    for (CacheBlock &block : cacheEntries) {
+    for (size_t idx = 0; idx < cacheEntries.size(); idx++) {
+        CacheBlock &block = cacheEntries[idx];
+        if (block.valid)
+            ++rCacheStats.wayOccupancy[idx % assoc];
         block.valid = false;
         block.poisoned = false;
     }
@@ -184,7 +235,7 @@ RunaheadCache::handlePacket(PacketPtr pkt)
     return respPkt;
 }
 
-RunaheadCache::RCacheStats::RCacheStats(statistics::Group *parent)
+RunaheadCache::RCacheStats::RCacheStats(statistics::Group *parent, unsigned assoc)
     : statistics::Group(parent, "rcache"),
       ADD_STAT(lookups, statistics::units::Count::get(),
            "Total amount of cache block lookups"),
@@ -205,7 +256,17 @@ RunaheadCache::RCacheStats::RCacheStats(statistics::Group *parent)
       ADD_STAT(invalidations, statistics::units::Count::get(),
            "Total amount of times the R-cache was invalidated"),
       ADD_STAT(packetsHandled, statistics::units::Count::get(),
-           "Total amount of packets served by runahead cache")
+           "Total amount of packets served by runahead cache"),
+      ADD_STAT(wayFills, statistics::units::Count::get(),
+           "Total amount of blocks allocated in each way"),
+      ADD_STAT(wayHits, statistics::units::Count::get(),
+           "Total amount of read hits in each way"),
+      ADD_STAT(wayOccupancy, statistics::units::Count::get(),
+           "Valid blocks in each way at invalidation, summed over all invalidations"),
+      ADD_STAT(avgWayOccupancy, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+           "Average amount of valid blocks in each way at invalidation",
+           wayOccupancy / invalidations)
 {
     lookups.prereq(lookups);
     writes.prereq(writes);
@@ -217,6 +278,14 @@ RunaheadCache::RCacheStats::RCacheStats(statistics::Group *parent)
     poisons.prereq(poisons);
     invalidations.prereq(invalidations);
     packetsHandled.prereq(packetsHandled);
+    wayFills.init(assoc);
+    wayHits.init(assoc);
+    wayOccupancy.init(assoc);
+    for (unsigned way = 0; way < assoc; way++) {
+        wayFills.subname(way, csprintf("way%u", way));
+        wayHits.subname(way, csprintf("way%u", way));
+        wayOccupancy.subname(way, csprintf("way%u", way));
+    }
 }
 
 } // namespace runahead
@@ -13,7 +13,7 @@ namespace runahead
 {
 
 /**
- * The runahead cache is a very simplified direct-mapped cache model residing in the CPU.
+ * The runahead cache is a very simplified set-associative cache model residing in the CPU.
  * It's purpose is simply to cache runahead stores, as they are speculative even
  * at (pseudo)retirement, so we never allow them to actually writeback data to the cache.
  * The runahead cache does not model much of anything. It's essentially a glorified list.
@@ -24,9 +24,20 @@ namespace runahead
  * cache block that contains poisoned data, the load is poisoned. If the load tries to get
  * an invalid cache block, that just means the load didn't depend on a runahead store, so
  * the request goes to normal cache.
+ *
+ * Blocks are replaced within a set by either LRU or random replacement. The hit latency is
+ * modelled by the LSQ when scheduling the response, which also limits accesses per cycle.
 */
 class RunaheadCache
 {
+public:
+    /** Replacement policies for choosing a victim within a set */
+    enum ReplPolicy
+    {
+        LRU,
+        Random
+    };
+
 private:
     const std::string _name;
 
@@ -36,9 +47,11 @@ private:
         uint64_t tag;
         bool valid;
         bool poisoned;
+        /** Last time the block was accessed, for LRU replacement */
+        uint64_t lastTouch;
 
         CacheBlock(uint8_t *data, uint64_t tag, bool valid, bool poisoned) :
-            data(data), tag(tag), valid(valid), poisoned(poisoned) {};
+            data(data), tag(tag), valid(valid), poisoned(poisoned), lastTouch(0) {};
     };
 
     /** Size in bytes of the entire cache */
@@ -47,15 +60,27 @@ private:
     const uint8_t blockSize;
     /** The total amount of cache blocks */
     const uint64_t numBlocks;
-
+    /** Amount of blocks in each set */
+    const unsigned assoc;
+    /** The total amount of sets */
+    const uint64_t numSets;
+    /** Replacement policy used to pick a victim block in a set */
+    const ReplPolicy replPolicy;
+    /** Latency of a runahead cache access */
+    const Cycles latency;
+
+    /** All blocks, set by set. The ways of a set are contiguous. */
     std::vector<CacheBlock> cacheEntries;
 
+    /** Counter advancing on every access, used to order blocks for LRU */
+    uint64_t accessCounter;
+
     /** Various bitshifts/masks of the address */
     const uint indexShift;
     const uint indexMask;
     const uint tagShift;
 
-    /** Extract the block index from an address */
+    /** Extract the set index from an address */
     uint64_t getIndex(Addr addr) { return (addr >> indexShift) & indexMask; };
 
     /** Extract the tag from an address */
@@ -64,9 +89,18 @@ private:
     /** Align an address to its cache block boundary. */
     Addr align(Addr addr) { return (addr - addr % blockSize); };
 
-    /** Get a block from the runahead cache, given that it is in the cache */
+    /** Get a valid block from the runahead cache. Returns nullptr if the block is not in the cache */
     CacheBlock *getBlock(Addr addr);
 
+    /** Find a block to allocate for an address, evicting a block in its set if needed */
+    CacheBlock *findVictim(Addr addr);
+
+    /** Get the way a block resides in */
+    unsigned getWay(const CacheBlock *block) const { return (block - cacheEntries.data()) % assoc; }
+
+    /** Mark a block as most recently used */
+    void touch(CacheBlock *block) { block->lastTouch = ++accessCounter; }
+
     /**
      * Check if data is in cache.
      * That is, the cache block's tag matches the address and the block is valid.
@@ -78,7 +112,7 @@ private:
 
     /**
      * Write some data to the runahead cache.
-     * Conflicts are ignored, the "eviction policy" is to simply overwrite the block.
+     * On a miss, a block in the set is allocated according to the replacement policy.
      */
     void write(PacketPtr pkt);
 
@@ -87,10 +121,15 @@ private:
 
 public:
     /** Sizes should be in bytes */
-    RunaheadCache(const std::string &name, statistics::Group *statsParent, uint64_t size, uint8_t blockSize);
+    RunaheadCache(const std::string &name, statistics::Group *statsParent, uint64_t size,
+                  uint8_t blockSize, unsigned assoc, const std::string &replPolicy,
+                  Cycles latency);
 
     std::string name() const { return _name; }
 
+    /** Latency of an access to the runahead cache */
+    Cycles getLatency() const { return latency; }
+
     ~RunaheadCache();
 
     /** Invalidates all cache blocks. */
@@ -102,7 +141,7 @@ public:
 private:
     struct RCacheStats : public statistics::Group
     {
-        RCacheStats(statistics::Group *parent);
+        RCacheStats(statistics::Group *parent, unsigned assoc);
 
         // number of block lookups
         statistics::Scalar lookups;
@@ -124,6 +163,14 @@ private:
         statistics::Scalar invalidations;
         // number of packets served by rcache
         statistics::Scalar packetsHandled;
+        // number of blocks allocated in each way
+        statistics::Vector wayFills;
+        // number of read hits in each way
+        statistics::Vector wayHits;
+        // valid blocks in each way when the cache is invalidated, summed over invalidations
+        statistics::Vector wayOccupancy;
+        // average valid blocks in each way at the end of a runahead period
+        statistics::Formula avgWayOccupancy;
     } rCacheStats;
 };
 
@@ -0,0 +1,110 @@
+#include "cpu/runahead/runahead_trace.hh"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/output.hh"
+#include "cpu/runahead/cpu.hh"
+#include "params/BaseRunaheadCPU.hh"
+#include "sim/byteswap.hh"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+RunaheadTrace::RunaheadTrace(CPU *_cpu, const BaseRunaheadCPUParams &params)
+    : cpu(_cpu),
+      enabled(params.enableRunahead && !params.runaheadTraceFile.empty()),
+      fileName(params.runaheadTraceFile),
+      bufferSize(params.runaheadTraceBufferSize)
+{
+    fatal_if(enabled && bufferSize == 0, "The runahead trace buffer can not be empty.\n");
+
+    for (ThreadID tid = 0; tid < MaxThreads; tid++)
+        entryTick[tid] = 0;
+
+    if (!enabled)
+        return;
+
+    buffer.reserve(bufferSize);
+
+    // Records still in the buffer would be lost when the simulation ends
+    registerExitCallback([this]() { flush(); });
+}
+
+std::string
+RunaheadTrace::name() const
+{
+    return cpu->name() + ".runaheadtrace";
+}
+
+template <class T>
+void
+RunaheadTrace::put(T value)
+{
+    value = htole(value);
+    const char *bytes = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void
+RunaheadTrace::startPeriod(ThreadID tid)
+{
+    if (!enabled)
+        return;
+
+    entryTick[tid] = curTick();
+}
+
+void
+RunaheadTrace::endPeriod(ThreadID tid, Addr causePC, const std::vector<PCPair> &chain)
+{
+    if (!enabled)
+        return;
+
+    size_t chainLength = std::min<size_t>(chain.size(), std::numeric_limits<uint16_t>::max());
+
+    put<uint64_t>(numPeriods++);
+    put<uint64_t>(causePC);
+    put<uint64_t>(entryTick[tid]);
+    put<uint64_t>(curTick());
+    put<uint64_t>(cpu->commit.instsPseudoretired[tid]);
+    put<uint64_t>(cpu->commit.loadsPseudoretired[tid]);
+    put<uint32_t>(cpu->commit.numLLLsThisPeriod[tid]);
+    put<uint16_t>(chainLength);
+    put<uint8_t>(tid);
+    put<uint8_t>(cpu->commit.lastExitCause[tid]);
+    for (size_t i = 0; i < chainLength; i++) {
+        put<uint64_t>(chain[i].pc);
+        put<uint16_t>(chain[i].upc);
+    }
+
+    if (buffer.size() >= bufferSize)
+        flush();
+}
+
+void
+RunaheadTrace::flush()
+{
+    if (!enabled || buffer.empty())
+        return;
+
+    if (!stream) {
+        stream = simout.create(fileName, true);
+        fatal_if(!stream, "Could not create runahead trace file %s.\n", fileName);
+
+        const char magic[8] = { 'R', 'A', 'T', 'R', 'A', 'C', 'E', '\0' };
+        uint32_t version = htole(Version);
+        stream->stream()->write(magic, sizeof(magic));
+        stream->stream()->write(reinterpret_cast<const char *>(&version), sizeof(version));
+    }
+
+    stream->stream()->write(buffer.data(), buffer.size());
+    stream->stream()->flush();
+    buffer.clear();
+}
+
+} // namespace runahead
+} // namespace gem5
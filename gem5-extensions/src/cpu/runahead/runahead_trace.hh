@@ -0,0 +1,94 @@
+#ifndef __CPU_RUNAHEAD_RUNAHEAD_TRACE_HH__
+#define __CPU_RUNAHEAD_RUNAHEAD_TRACE_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/runahead/limits.hh"
+#include "cpu/runahead/pc_pair.hh"
+
+namespace gem5
+{
+
+struct BaseRunaheadCPUParams;
+class OutputStream;
+
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * Binary trace with one record per runahead period, written to the output directory.
+ * Meant to replace scraping RunaheadChains debug output, at a fraction of the cost.
+ *
+ * The file starts with the 8 byte magic "RATRACE\0" and a 32 bit format version. Each record
+ * then is, all little endian:
+ *  - u64 period, u64 cause PC, u64 entry tick, u64 exit tick
+ *  - u64 insts pseudoretired, u64 loads pseudoretired
+ *  - u32 new LLLs generated, u16 chain length, u8 thread, u8 exit cause
+ *  - chain length times (u64 PC, u16 micro PC)
+ *
+ * The exit cause is the runaheadExitCause bucket of commit. scripts/runahead_trace.py reads
+ * the trace back.
+ */
+class RunaheadTrace
+{
+  private:
+    static constexpr uint32_t Version = 1;
+
+    /** Pointer to the CPU */
+    CPU *cpu;
+
+    /** Whether or not the trace is enabled */
+    bool enabled;
+
+    /** Name of the trace file in the output directory */
+    const std::string fileName;
+
+    /** Amount of bytes buffered before writing them to the file */
+    const size_t bufferSize;
+
+    /** Trace file, opened on the first write */
+    OutputStream *stream = nullptr;
+
+    /** Records not yet written to the file */
+    std::vector<char> buffer;
+
+    /** Amount of periods recorded */
+    uint64_t numPeriods = 0;
+
+    /** Tick each thread entered its current period */
+    Tick entryTick[MaxThreads];
+
+    /** Append a little endian value to the buffer */
+    template <class T>
+    void put(T value);
+
+  public:
+    RunaheadTrace(CPU *_cpu, const BaseRunaheadCPUParams &params);
+
+    /** Returns the name of the trace */
+    std::string name() const;
+
+    /** Whether or not the trace is enabled */
+    bool isEnabled() const { return enabled; }
+
+    /** A thread entered runahead */
+    void startPeriod(ThreadID tid);
+
+    /**
+     * A thread exited runahead. Record the period, given the LLL that caused it and the
+     * chain that was used for it.
+     */
+    void endPeriod(ThreadID tid, Addr causePC, const std::vector<PCPair> &chain);
+
+    /** Write all buffered records to the trace file */
+    void flush();
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_RUNAHEAD_TRACE_HH__
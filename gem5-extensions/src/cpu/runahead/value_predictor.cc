@@ -0,0 +1,177 @@
+#include "cpu/runahead/value_predictor.hh"
+
+#include <cstring>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "cpu/runahead/cpu.hh"
+#include "cpu/runahead/dyn_inst.hh"
+#include "debug/RunaheadValuePredictor.hh"
+#include "params/BaseRunaheadCPU.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+LoadValuePredictor::LoadValuePredictor(CPU *_cpu, const BaseRunaheadCPUParams &params)
+    : cpu(_cpu),
+      enabled(params.enableRunahead && params.runaheadValuePredictor),
+      indexMask(params.runaheadValuePredictorEntries - 1),
+      threshold(params.runaheadValuePredictorThreshold),
+      curPeriod(0),
+      stats(_cpu)
+{
+    unsigned counterBits = params.runaheadValuePredictorCounterBits;
+    fatal_if(!isPowerOf2(params.runaheadValuePredictorEntries),
+             "Runahead value predictor size must be a power of 2.\n");
+    fatal_if(counterBits == 0 || counterBits > 8,
+             "Runahead value predictor counters must be 1 to 8 bits wide.\n");
+    fatal_if(threshold > (1U << counterBits) - 1,
+             "Runahead value predictor threshold must fit in the counters.\n");
+
+    if (enabled)
+        table.resize(params.runaheadValuePredictorEntries, Entry(counterBits));
+}
+
+std::string
+LoadValuePredictor::name() const
+{
+    return cpu->name() + ".valuepredictor";
+}
+
+bool
+LoadValuePredictor::predictable(const DynInstPtr &inst)
+{
+    return inst->isLoad() && !inst->isVector() && inst->memData != nullptr &&
+           inst->effSize > 0 && inst->effSize <= sizeof(uint64_t);
+}
+
+void
+LoadValuePredictor::startPeriod()
+{
+    if (!enabled)
+        return;
+
+    curPeriod++;
+    // Responses of the previous period's predictions are not worth waiting for anymore
+    outstanding.clear();
+}
+
+void
+LoadValuePredictor::train(const DynInstPtr &inst)
+{
+    if (!enabled || !predictable(inst))
+        return;
+
+    Addr pc = inst->pcState().instAddr();
+    uint64_t value = 0;
+    std::memcpy(&value, inst->memData, inst->effSize);
+
+    Entry &entry = table[index(pc)];
+    stats.trained++;
+
+    if (!entry.valid || entry.tag != pc) {
+        entry.valid = true;
+        entry.tag = pc;
+        entry.lastValue = value;
+        entry.stride = 0;
+        entry.confidence.reset();
+        return;
+    }
+
+    int64_t stride = value - entry.lastValue;
+    if (stride == entry.stride) {
+        entry.confidence++;
+    } else {
+        entry.confidence--;
+        // Only replace the stride once it has proven unreliable
+        if (entry.confidence == 0)
+            entry.stride = stride;
+    }
+    entry.lastValue = value;
+}
+
+bool
+LoadValuePredictor::predict(const DynInstPtr &inst, uint64_t &value)
+{
+    if (!enabled || !predictable(inst))
+        return false;
+
+    Addr pc = inst->pcState().instAddr();
+    Entry &entry = table[index(pc)];
+    stats.lookups++;
+
+    if (!entry.valid || entry.tag != pc || entry.confidence < threshold) {
+        DPRINTF(RunaheadValuePredictor, "[sn:%llu] No confident prediction for PC %s.\n",
+                inst->seqNum, inst->pcState());
+        return false;
+    }
+
+    // Advance from the last committed value on the first prediction of the period
+    if (entry.specPeriod != curPeriod) {
+        entry.specPeriod = curPeriod;
+        entry.specValue = entry.lastValue;
+    }
+    entry.specValue += entry.stride;
+    value = entry.specValue;
+
+    DPRINTF(RunaheadValuePredictor, "[sn:%llu] Predicted value %#x for PC %s (stride %lli).\n",
+            inst->seqNum, value, inst->pcState(), entry.stride);
+
+    outstanding[inst->seqNum] = value;
+    stats.predictions++;
+    return true;
+}
+
+void
+LoadValuePredictor::verify(const DynInstPtr &inst, PacketPtr pkt)
+{
+    auto it = outstanding.find(inst->seqNum);
+    if (it == outstanding.end())
+        return;
+
+    uint64_t predicted = it->second;
+    outstanding.erase(it);
+
+    // Split loads respond with several packets, only check complete ones
+    if (pkt->getSize() != inst->effSize)
+        return;
+
+    uint64_t actual = 0;
+    std::memcpy(&actual, pkt->getConstPtr<uint8_t>(), inst->effSize);
+    if (inst->effSize < sizeof(uint64_t))
+        predicted &= mask(inst->effSize * 8);
+
+    DPRINTF(RunaheadValuePredictor, "[sn:%llu] PC %s predicted %#x, actual value %#x.\n",
+            inst->seqNum, inst->pcState(), predicted, actual);
+
+    if (predicted == actual)
+        stats.correct++;
+    else
+        stats.incorrect++;
+}
+
+LoadValuePredictor::ValuePredictorStats::ValuePredictorStats(CPU *cpu)
+    : statistics::Group(cpu, "valuepredictor"),
+      ADD_STAT(trained, statistics::units::Count::get(),
+           "Number of committed loads the value predictor was trained on"),
+      ADD_STAT(lookups, statistics::units::Count::get(),
+           "Number of runahead LLLs looked up in the value predictor"),
+      ADD_STAT(predictions, statistics::units::Count::get(),
+           "Number of runahead LLLs given a predicted value instead of poison"),
+      ADD_STAT(correct, statistics::units::Count::get(),
+           "Number of predicted values matching the real LLL response"),
+      ADD_STAT(incorrect, statistics::units::Count::get(),
+           "Number of predicted values not matching the real LLL response"),
+      ADD_STAT(accuracy, statistics::units::Ratio::get(),
+           "Fraction of verified value predictions that were correct",
+           correct / (correct + incorrect)),
+      ADD_STAT(dependentLoads, statistics::units::Count::get(),
+           "Number of runahead loads sent to memory with addresses depending on predicted values")
+{
+    accuracy.precision(6);
+}
+
+} // namespace runahead
+} // namespace gem5
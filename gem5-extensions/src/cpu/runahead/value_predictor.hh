@@ -0,0 +1,139 @@
+#ifndef __CPU_RUNAHEAD_VALUE_PREDICTOR_HH__
+#define __CPU_RUNAHEAD_VALUE_PREDICTOR_HH__
+
+#include <unordered_map>
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/runahead/dyn_inst_ptr.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+struct BaseRunaheadCPUParams;
+
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * PC-indexed last-value/stride predictor for the values of long latency loads in runahead.
+ *
+ * The predictor is trained on the values of loads committed in normal mode. Each entry
+ * keeps the last committed value of a load and the stride between its last two values.
+ * A last-value load is simply a load with a stride of 0.
+ *
+ * In runahead, LLLs whose entry is confident get a predicted response instead of being
+ * poisoned, so loads depending on them can still compute their addresses and prefetch.
+ * Several instances of the same load may be predicted in one period, so the predictor
+ * keeps a speculative value per entry that advances by the stride on every prediction.
+ *
+ * Predictions are verified when the real response of the LLL arrives.
+ */
+class LoadValuePredictor
+{
+  private:
+    struct Entry
+    {
+        /** PC of the load */
+        Addr tag = 0;
+        /** Whether or not the entry is in use */
+        bool valid = false;
+        /** Last value loaded in normal mode */
+        uint64_t lastValue = 0;
+        /** Difference between the last two values loaded in normal mode */
+        int64_t stride = 0;
+        /** Confidence in the stride */
+        SatCounter8 confidence;
+        /** Value most recently predicted in the current runahead period */
+        uint64_t specValue = 0;
+        /** Runahead period specValue belongs to */
+        uint64_t specPeriod = 0;
+
+        Entry(unsigned counterBits) : confidence(counterBits, 0) {}
+    };
+
+    /** Pointer to the CPU */
+    CPU *cpu;
+
+    /** Whether or not the predictor is enabled */
+    bool enabled;
+
+    /** Prediction table, direct mapped */
+    std::vector<Entry> table;
+
+    /** Mask to turn a PC into a table index */
+    const Addr indexMask;
+
+    /** Values are only predicted when confidence is at least this */
+    const unsigned threshold;
+
+    /** Id of the current/most recent runahead period */
+    uint64_t curPeriod;
+
+    /** Predicted values of LLLs still waiting on their real response */
+    std::unordered_map<InstSeqNum, uint64_t> outstanding;
+
+    Addr index(Addr pc) const { return (pc ^ (pc >> 12)) & indexMask; }
+
+    /** Whether or not the value of the load can be predicted at all */
+    static bool predictable(const DynInstPtr &inst);
+
+  public:
+    LoadValuePredictor(CPU *_cpu, const BaseRunaheadCPUParams &params);
+
+    /** Returns the name of the value predictor */
+    std::string name() const;
+
+    /** Whether or not the predictor is enabled */
+    bool isEnabled() const { return enabled; }
+
+    /** Start predicting for a new runahead period */
+    void startPeriod();
+
+    /** Train the predictor on the value loaded by a load committed in normal mode */
+    void train(const DynInstPtr &inst);
+
+    /**
+     * Predict the value of a runahead LLL.
+     * Returns true and sets value if the predictor is confident.
+     */
+    bool predict(const DynInstPtr &inst, uint64_t &value);
+
+    /** Check a predicted value against the real response of the LLL */
+    void verify(const DynInstPtr &inst, PacketPtr pkt);
+
+    /** A runahead load whose address depended on a predicted value was sent to memory */
+    void dependentLoadIssued() { stats.dependentLoads++; }
+
+  private:
+    struct ValuePredictorStats : public statistics::Group
+    {
+        ValuePredictorStats(CPU *cpu);
+
+        /** Number of loads trained on */
+        statistics::Scalar trained;
+        /** Number of runahead LLLs looked up */
+        statistics::Scalar lookups;
+        /** Number of runahead LLLs given a predicted value */
+        statistics::Scalar predictions;
+        /** Number of predictions verified correct by the real response */
+        statistics::Scalar correct;
+        /** Number of predictions verified wrong by the real response */
+        statistics::Scalar incorrect;
+        /** Fraction of verified predictions that were correct */
+        statistics::Formula accuracy;
+        /** Runahead loads sent to memory with an address depending on a predicted value */
+        statistics::Scalar dependentLoads;
+    } stats;
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_VALUE_PREDICTOR_HH__
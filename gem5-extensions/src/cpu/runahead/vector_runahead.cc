@@ -0,0 +1,230 @@
+#include "cpu/runahead/vector_runahead.hh"
+
+#include <cstring>
+
+#include "arch/generic/mmu.hh"
+#include "cpu/runahead/cpu.hh"
+#include "cpu/runahead/dyn_inst.hh"
+#include "debug/RunaheadVector.hh"
+#include "params/BaseRunaheadCPU.hh"
+
+namespace gem5
+{
+namespace runahead
+{
+
+VectorRunahead::VectorRunahead(CPU *_cpu, const BaseRunaheadCPUParams &params)
+    : cpu(_cpu),
+      enabled(params.enableRunahead && params.vectorRunahead),
+      numLanes(params.vectorRunaheadLanes),
+      issueWidth(params.vectorRunaheadIssueWidth),
+      blockSize(_cpu->cacheLineSize()),
+      stats(_cpu)
+{
+    fatal_if(enabled && (numLanes == 0 || issueWidth == 0),
+             "Vector runahead needs at least one lane and an issue width of at least one.\n");
+
+    for (ThreadID tid = 0; tid < MaxThreads; tid++)
+        period[tid] = 0;
+}
+
+std::string
+VectorRunahead::name() const
+{
+    return cpu->name() + ".vectorrunahead";
+}
+
+bool
+VectorRunahead::hasPendingLanes() const
+{
+    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
+        if (!pendingLanes[tid].empty())
+            return true;
+    }
+    return false;
+}
+
+bool
+VectorRunahead::isLanePacket(PacketPtr pkt)
+{
+    return dynamic_cast<LaneState *>(pkt->senderState) != nullptr;
+}
+
+void
+VectorRunahead::start(ThreadID tid, const DynInstPtr &lll)
+{
+    if (!enabled)
+        return;
+
+    period[tid]++;
+    pendingLanes[tid].clear();
+    stats.periods++;
+
+    if (!findChainPattern(cpu, tid, lll, pattern[tid])) {
+        DPRINTF(RunaheadVector, "[tid:%i] No pattern to vectorize for LLL sn:%llu.\n",
+                tid, lll->seqNum);
+        stats.noPattern++;
+        return;
+    }
+
+    const ChainPattern &pat = pattern[tid];
+    if (pat.indirect)
+        stats.indirectPatterns++;
+    else
+        stats.directPatterns++;
+
+    // Each lane is a future iteration beyond the youngest instance in the window
+    for (unsigned lane = 1; lane <= numLanes; lane++)
+        queueLane(tid, pat.lastAddr + lane * pat.stride, pat.size, pat.indirect);
+
+    cpu->activityThisCycle();
+}
+
+void
+VectorRunahead::stop(ThreadID tid)
+{
+    if (!enabled)
+        return;
+
+    if (!pendingLanes[tid].empty()) {
+        DPRINTF(RunaheadVector, "[tid:%i] Dropping %i unissued lanes on runahead exit.\n",
+                tid, pendingLanes[tid].size());
+        stats.droppedLanes += pendingLanes[tid].size();
+    }
+
+    pendingLanes[tid].clear();
+    pattern[tid].valid = false;
+}
+
+void
+VectorRunahead::queueLane(ThreadID tid, Addr vaddr, unsigned size, bool gather)
+{
+    if ((vaddr % blockSize) + size > blockSize) {
+        stats.droppedLanes++;
+        return;
+    }
+
+    pendingLanes[tid].push_back({vaddr, size, gather});
+}
+
+void
+VectorRunahead::tick()
+{
+    if (!enabled)
+        return;
+
+    unsigned issued = 0;
+    for (ThreadID tid = 0; tid < cpu->numThreads && issued < issueWidth; tid++) {
+        while (!pendingLanes[tid].empty() && issued < issueWidth) {
+            if (!issueLane(tid, pendingLanes[tid].front()))
+                break;
+            pendingLanes[tid].pop_front();
+            issued++;
+        }
+    }
+
+    // Keep ticking until all lanes are out
+    if (hasPendingLanes())
+        cpu->activityThisCycle();
+}
+
+bool
+VectorRunahead::issueLane(ThreadID tid, const Lane &lane)
+{
+    LSQ &lsq = cpu->iew.ldstQueue;
+    if (lsq.cacheBlocked() || !lsq.cachePortAvailable(true))
+        return false;
+
+    RequestPtr req = std::make_shared<Request>(lane.vaddr, lane.size, Request::Flags(0),
+                                               cpu->dataRequestorId(), pattern[tid].pc,
+                                               cpu->tcBase(tid)->contextId());
+
+    // Lanes are not instructions, so there is nothing to replay a fault on. Drop them instead.
+    Fault fault = cpu->mmu->translateFunctional(req, cpu->tcBase(tid), BaseMMU::Read);
+    if (fault != NoFault || req->isUncacheable()) {
+        DPRINTF(RunaheadVector, "[tid:%i] Dropping lane to %#x, translation failed.\n",
+                tid, lane.vaddr);
+        stats.translationFaults++;
+        return true;
+    }
+
+    PacketPtr pkt = Packet::createRead(req);
+    pkt->allocate();
+    pkt->senderState = new LaneState(tid, period[tid], lane.gather, lane.size);
+
+    if (!lsq.sendVectorRunaheadPacket(pkt)) {
+        delete pkt->senderState;
+        delete pkt;
+        return false;
+    }
+
+    DPRINTF(RunaheadVector, "[tid:%i] Issued %s lane to %#x (paddr %#x).\n",
+            tid, lane.gather ? "gather" : "prefetch", lane.vaddr, req->getPaddr());
+
+    outstandingLanes++;
+    stats.lanesIssued++;
+    if (lane.gather)
+        stats.gatherLanesIssued++;
+    cpu->runaheadPrefetchTracker().prefetchIssued(pkt->getAddr(),
+                                                  RunaheadPrefetchTracker::VectorLane);
+    return true;
+}
+
+void
+VectorRunahead::recvTimingResp(PacketPtr pkt)
+{
+    LaneState *state = dynamic_cast<LaneState *>(pkt->senderState);
+    assert(state && outstandingLanes > 0);
+    ThreadID tid = state->tid;
+    outstandingLanes--;
+
+    cpu->runaheadPrefetchTracker().prefetchFilled(pkt->getAddr(), pkt->req->getAccessDepth());
+
+    // A gathered index turns into a prefetch of the LLL address it leads to
+    const ChainPattern &pat = pattern[tid];
+    if (state->gather && state->period == period[tid] && pat.valid && pat.indirect &&
+        cpu->inRunahead(tid) && !pkt->isError()) {
+        uint64_t value = 0;
+        std::memcpy(&value, pkt->getConstPtr<uint8_t>(), state->size);
+        Addr vaddr = pat.base + pat.scale * value;
+
+        DPRINTF(RunaheadVector, "[tid:%i] Gathered value %#x, queueing lane to %#x.\n",
+                tid, value, vaddr);
+        stats.gathersCompleted++;
+        queueLane(tid, vaddr, pat.lllSize, false);
+        cpu->wakeCPU();
+    }
+
+    delete state;
+    delete pkt;
+
+    // Draining waits for the last lane
+    if (cpu->isDraining() && isDrained())
+        cpu->wakeCPU();
+}
+
+VectorRunahead::VectorRunaheadStats::VectorRunaheadStats(CPU *cpu)
+    : statistics::Group(cpu, "vectorrunahead"),
+      ADD_STAT(periods, statistics::units::Count::get(),
+           "Number of runahead periods vector runahead tried to vectorize"),
+      ADD_STAT(noPattern, statistics::units::Count::get(),
+           "Number of runahead periods without a pattern to vectorize"),
+      ADD_STAT(directPatterns, statistics::units::Count::get(),
+           "Number of runahead periods vectorizing a strided LLL"),
+      ADD_STAT(indirectPatterns, statistics::units::Count::get(),
+           "Number of runahead periods vectorizing an indirect LLL"),
+      ADD_STAT(lanesIssued, statistics::units::Count::get(),
+           "Number of vector runahead lanes sent to the data cache"),
+      ADD_STAT(gatherLanesIssued, statistics::units::Count::get(),
+           "Number of vector runahead lanes gathering an index"),
+      ADD_STAT(gathersCompleted, statistics::units::Count::get(),
+           "Number of gathered indices used to issue an indirect lane"),
+      ADD_STAT(translationFaults, statistics::units::Count::get(),
+           "Number of vector runahead lanes dropped due to failed translation"),
+      ADD_STAT(droppedLanes, statistics::units::Count::get(),
+           "Number of vector runahead lanes dropped before issuing")
+{
+}
+
+} // namespace runahead
+} // namespace gem5
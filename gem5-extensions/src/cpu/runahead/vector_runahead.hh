@@ -0,0 +1,157 @@
+#ifndef __CPU_RUNAHEAD_VECTOR_RUNAHEAD_HH__
+#define __CPU_RUNAHEAD_VECTOR_RUNAHEAD_HH__
+
+#include <deque>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/runahead/chain_pattern.hh"
+#include "cpu/runahead/dyn_inst_ptr.hh"
+#include "cpu/runahead/limits.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+struct BaseRunaheadCPUParams;
+
+namespace runahead
+{
+
+class CPU;
+
+/**
+ * Vector runahead. Replicates the address pattern of the LLL that caused runahead across
+ * a number of lanes, each lane standing in for a future iteration of the loop the LLL is in.
+ *
+ * On entry, the instances of the LLL and of the loads in its dependence chain that are in the
+ * instruction window are inspected for one of two patterns:
+ *  - Direct: the LLL address advances by a constant stride, i.e. the LLL is itself the
+ *    strided induction load. Each lane prefetches the LLL address of a future iteration.
+ *  - Indirect: a chain load advances by a constant stride, and the LLL address is a linear
+ *    function of the value it loaded, i.e. b[a[i]]. Each lane gathers the value of a future
+ *    instance of the strided load, and prefetches the LLL address computed from it.
+ *
+ * Lanes are issued as a batch of reads straight to the data cache, using free load ports.
+ * They are not instructions, so they never occupy the instruction window.
+ */
+class VectorRunahead
+{
+  private:
+    /** Sender state of lane packets, to tell them apart from LSQ requests */
+    struct LaneState : public Packet::SenderState
+    {
+        ThreadID tid;
+        /** Period the lane was issued in. Responses of older periods are ignored */
+        uint64_t period;
+        /** Whether the lane gathers an index rather than prefetching the LLL address */
+        bool gather;
+        /** Size of the gathered value */
+        unsigned size;
+
+        LaneState(ThreadID _tid, uint64_t _period, bool _gather, unsigned _size)
+            : tid(_tid), period(_period), gather(_gather), size(_size)
+        {}
+    };
+
+    /** A lane waiting for a free load port */
+    struct Lane
+    {
+        Addr vaddr;
+        unsigned size;
+        bool gather;
+    };
+
+    /** Pointer to the CPU */
+    CPU *cpu;
+
+    /** Whether or not vector runahead is enabled */
+    bool enabled;
+
+    /** Amount of future iterations to issue lanes for */
+    const unsigned numLanes;
+
+    /** Max lanes sent to the data cache per cycle */
+    const unsigned issueWidth;
+
+    /** Cache line size, lanes may not cross lines */
+    const unsigned blockSize;
+
+    /** Pattern being vectorized by each thread */
+    ChainPattern pattern[MaxThreads];
+
+    /** Lanes of each thread waiting to be issued */
+    std::deque<Lane> pendingLanes[MaxThreads];
+
+    /** Period of each thread, increased on every start */
+    uint64_t period[MaxThreads];
+
+    /** Lanes sent to the data cache that did not respond yet */
+    unsigned outstandingLanes = 0;
+
+    /** Queue a lane, dropping it if it can not be issued as a single access */
+    void queueLane(ThreadID tid, Addr vaddr, unsigned size, bool gather);
+
+    /** Translate and send a lane. Returns false if the cache could not accept it */
+    bool issueLane(ThreadID tid, const Lane &lane);
+
+  public:
+    VectorRunahead(CPU *_cpu, const BaseRunaheadCPUParams &params);
+
+    /** Returns the name of vector runahead */
+    std::string name() const;
+
+    /** Whether or not vector runahead is enabled */
+    bool isEnabled() const { return enabled; }
+
+    /** Whether or not any thread has lanes waiting to be issued */
+    bool hasPendingLanes() const;
+
+    /** Whether or not lanes are waiting to be issued or for their response */
+    bool isDrained() const { return outstandingLanes == 0 && !hasPendingLanes(); }
+
+    /** A thread entered runahead because of the given LLL. Vectorize it if possible */
+    void start(ThreadID tid, const DynInstPtr &lll);
+
+    /** A thread exited runahead. Drop the lanes that have not been issued */
+    void stop(ThreadID tid);
+
+    /** Issue pending lanes */
+    void tick();
+
+    /** Whether or not the packet belongs to a vector runahead lane */
+    static bool isLanePacket(PacketPtr pkt);
+
+    /** Handle the response of a lane */
+    void recvTimingResp(PacketPtr pkt);
+
+  private:
+    struct VectorRunaheadStats : public statistics::Group
+    {
+        VectorRunaheadStats(CPU *cpu);
+
+        /** Periods vector runahead tried to vectorize */
+        statistics::Scalar periods;
+        /** Periods without a pattern to vectorize */
+        statistics::Scalar noPattern;
+        /** Periods vectorizing a strided LLL */
+        statistics::Scalar directPatterns;
+        /** Periods vectorizing an indirect LLL */
+        statistics::Scalar indirectPatterns;
+        /** Lanes sent to the data cache */
+        statistics::Scalar lanesIssued;
+        /** Lanes sent to gather an index */
+        statistics::Scalar gatherLanesIssued;
+        /** Gather responses used to issue an indirect lane */
+        statistics::Scalar gathersCompleted;
+        /** Lanes that could not be translated */
+        statistics::Scalar translationFaults;
+        /** Lanes dropped because they crossed a cache line or runahead exited */
+        statistics::Scalar droppedLanes;
+    } stats;
+};
+
+} // namespace runahead
+} // namespace gem5
+
+#endif // __CPU_RUNAHEAD_VECTOR_RUNAHEAD_HH__
@@ -0,0 +1,128 @@
+'''
+Compare the host time of variants of the same simulation, e.g. the host-side data structures
+of the runahead CPU, which leave the simulated results alone.
+
+Each variant is a name and the extra arguments it adds. Runs of the variants are alternated so
+host noise hits them alike, and the median host time of each is reported along with its
+speedup over the first variant. Pick a runahead-heavy checkpoint, as every runahead period
+refetches and squashes a full window of instructions. Everything after -- is passed on to
+spec2017.py, e.g.
+
+    python scripts/bench_host_time.py --outdir logs/mcf_s_0/bench-host --runs 3 \\
+        --variant heap=--no-dyninst-free-list --variant freelist= \\
+        --variant pooled-iq='--iq-dep-graph=Pooled' \\
+        --variant chain-scan=--no-chain-filter \\
+        -- --kernel=plinux --image=x86-3.img --script=runscripts/mcf_s_0.rcS \\
+           --restore-checkpoint=logs/mcf_s_0/m5out-spec2017-sp-chkpt-all/cpt_... \\
+           --max-insts=10000000
+'''
+
+import os
+import sys
+import shlex
+import shutil
+import argparse
+import statistics
+import subprocess
+
+REPO_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, os.path.join(REPO_DIR, 'scripts', 'stats'))
+
+from statdump import iter_dumps
+
+
+def parse_variant(arg: str) -> tuple:
+    '''
+    Split a NAME=ARGS variant into its name and argument list
+    '''
+    name, sep, args = arg.partition('=')
+    if not sep or not name:
+        raise argparse.ArgumentTypeError(f'Variant "{arg}" is not of the form NAME=ARGS')
+    return name, shlex.split(args)
+
+
+def read_last_dump(stats_file: str) -> dict:
+    '''
+    Read the values of the last stats dump of a run
+    '''
+    dump = {}
+    with open(stats_file, 'rb') as f:
+        for dump, _ in iter_dumps(f):
+            pass
+    return {name: data['values'][0] for name, data in dump.items()}
+
+
+def run(opts: argparse.Namespace, name: str, args: list, index: int) -> dict:
+    '''
+    Simulate once with the given variant, returns the stats of the run
+    '''
+    outdir = os.path.join(opts.outdir, f'{name}-{index}')
+    if os.path.exists(outdir):
+        shutil.rmtree(outdir)
+    os.makedirs(outdir)
+
+    cmd = [opts.gem5, '--outdir', outdir, opts.config, *opts.sim_args, *args]
+    print(f'[{name}-{index}] Running')
+    with open(os.path.join(outdir, 'simout.log'), 'w') as log:
+        ret = subprocess.run(cmd, stdout=log, stderr=subprocess.STDOUT).returncode
+
+    stats_file = os.path.join(outdir, 'stats.txt')
+    if ret != 0 or not os.path.exists(stats_file):
+        sys.exit(f'[{name}-{index}] Failed with exit code {ret}, see {outdir}/simout.log')
+    return read_last_dump(stats_file)
+
+
+def main(opts: argparse.Namespace) -> int:
+    variants = dict(opts.variant)
+    if len(variants) < 2:
+        sys.exit('Need at least two variants to compare')
+    os.makedirs(opts.outdir, exist_ok=True)
+
+    results = {name: [] for name in variants}
+    for index in range(opts.runs):
+        for name, args in variants.items():
+            results[name].append(run(opts, name, args, index))
+
+    # The variants should simulate the same instructions, check that before comparing host time
+    sim_insts = {name: runs[-1]['simInsts'] for name, runs in results.items()}
+    if len(set(sim_insts.values())) > 1:
+        print(f'Warning: the variants simulated different amounts of instructions: {sim_insts}')
+
+    baseline = next(iter(variants))
+    host_seconds = {name: statistics.median(stats['hostSeconds'] for stats in runs)
+                    for name, runs in results.items()}
+    for name, seconds in host_seconds.items():
+        print(f'{name}: median {seconds:.2f} host seconds over {opts.runs} runs, '
+              f'{host_seconds[baseline] / seconds:.3f}x over {baseline}')
+
+    # Counters of the host-side structures, if the variant has them enabled
+    for name, runs in results.items():
+        last = runs[-1]
+        for stat in opts.report:
+            key = f'{opts.core}.{stat}'
+            if key in last:
+                print(f'{name}: {stat} = {last[key]}')
+    return 0
+
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--outdir', required=True, help='Directory to put one m5out per run in')
+parser.add_argument('--variant', action='append', type=parse_variant, default=[],
+                    help='NAME=ARGS, a variant and its extra config arguments. The first is the baseline')
+parser.add_argument('--runs', default=3, type=int, help='Amount of runs of each variant')
+parser.add_argument('--report', nargs='*',
+                    default=['dyninstalloc.reuseRate', 'dyninstalloc.peakLive', 'spilledDependents'],
+                    help='Stats of the core to print for each variant')
+parser.add_argument('--gem5', default=os.path.join(REPO_DIR, 'gem5', 'build', 'X86', 'gem5.fast'),
+                    help='gem5 binary')
+parser.add_argument('--config', default=os.path.join(REPO_DIR, 'spec2017', 'configs', 'spec2017.py'),
+                    help='gem5 config script')
+parser.add_argument('--core', default='system.processor.cores1.core',
+                    help='Stat path of the detailed core')
+parser.add_argument('sim_args', nargs=argparse.REMAINDER, help='Arguments for the config script, after --')
+
+if __name__ == '__main__':
+    opts = parser.parse_args()
+    if opts.sim_args and opts.sim_args[0] == '--':
+        opts.sim_args = opts.sim_args[1:]
+    sys.exit(main(opts))
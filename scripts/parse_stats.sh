@@ -5,6 +5,7 @@ module restore gem5
 LOG_DIR=${HOME}/gem5-runahead/spec2017/logs
 STATPARSE=${HOME}/gem5-runahead/scripts/stats/statdump.py
 
+STATS_FILES=()
 for BENCH_DIR in $LOG_DIR/*; do
     BENCHMARK=$(basename $BENCH_DIR)
     M5OUT="$BENCH_DIR/m5out-spec2017-o3-baseline"
@@ -16,18 +17,16 @@ for BENCH_DIR in $LOG_DIR/*; do
         continue
     fi
 
-    echo "Parsing stats for: $BENCHMARK"
-    echo "======================================="
+    echo "Queueing stats for: $BENCHMARK"
     echo "    Stats file: $STATS"
-    echo "    Parsing and dumping stats as JSON in m5out..."
-
-    STATOUT="$M5OUT/gem5stats.json"
-    python $STATPARSE \
-        --format json --out $STATOUT \
-        $STATS \
-        > /dev/null 2>&1
-
-    echo "    Wrote stats to $STATOUT.json"
-
-    echo
+    STATS_FILES+=("$STATS")
 done
+
+# Ingest all benchmarks in parallel. Only dumps added since the last run are parsed,
+# and written to gem5stats.npz next to each stats file
+echo
+echo "Parsing stats for ${#STATS_FILES[@]} benchmarks..."
+python $STATPARSE \
+    --format npz --out gem5stats.npz \
+    --jobs $(nproc) \
+    "${STATS_FILES[@]}"
@@ -0,0 +1,200 @@
+'''
+Run every simpoint checkpoint of a benchmark as parallel local gem5 processes,
+then combine the per-simpoint stats into weighted whole-program metrics.
+
+Simpoints that already finished are skipped, so rerunning after a partial failure
+only simulates what is missing. Everything after -- is passed on to spec2017.py, e.g.
+
+    python scripts/run_simpoints.py --benchmark mcf_s_0 --cores 16 \\
+        --checkpoints logs/mcf_s_0/m5out-spec2017-sp-chkpt-all \\
+        --simpoints logs/mcf_s_0/m5out-spec2017-simpoint/simpoint \\
+        --outdir logs/mcf_s_0/m5out-spec2017-re-simpoints \\
+        -- --kernel=plinux --image=x86-3.img --script=runscripts/mcf_s_0.rcS --max-insts=101000000
+'''
+
+import os
+import re
+import sys
+import json
+import shutil
+import argparse
+import subprocess
+from concurrent.futures import ThreadPoolExecutor
+
+REPO_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, os.path.join(REPO_DIR, 'spec2017', 'configs'))
+sys.path.insert(0, os.path.join(REPO_DIR, 'scripts', 'stats'))
+
+from simpoints import read_weights, check_simpoint_ids
+from statdump import iter_dumps
+
+# Checkpoint directories as named by simulate.sim_fs_simpoint_checkpoints
+CHECKPOINT_PAT = re.compile(
+    r'^cpt_(?P<tick>\d+)_sp-(?P<id>\d+)_interval-(?P<interval>\d+)_insts-(?P<insts>\d+)_warmup-(?P<warmup>\d+)$'
+)
+# Marks a simpoint run as finished, written only after gem5 exited cleanly with stats
+DONE_FILE = 'done'
+
+
+def find_checkpoints(checkpoint_dir: str) -> dict:
+    '''
+    Find all simpoint checkpoints in a directory, keyed by simpoint ID
+    '''
+    checkpoints = {}
+    for entry in os.scandir(checkpoint_dir):
+        match = CHECKPOINT_PAT.match(entry.name)
+        if entry.is_dir() and match:
+            checkpoints[int(match.group('id'))] = entry.path
+    return checkpoints
+
+
+def run_simpoint(opts: argparse.Namespace, sp_id: int, checkpoint: str) -> bool:
+    '''
+    Simulate a single simpoint. Returns whether or not it finished successfully
+    '''
+    outdir = os.path.join(opts.outdir, f'sp-{sp_id}')
+    if os.path.exists(os.path.join(outdir, DONE_FILE)):
+        print(f'[sp-{sp_id}] Already done, skipping')
+        return True
+
+    # Leftovers of a failed run must not be mistaken for results
+    if os.path.exists(outdir):
+        shutil.rmtree(outdir)
+    os.makedirs(outdir)
+
+    cmd = [
+        opts.gem5, '--outdir', outdir, opts.config,
+        f'--restore-checkpoint={checkpoint}',
+        *opts.sim_args,
+    ]
+    print(f'[sp-{sp_id}] Starting from {os.path.basename(checkpoint)}')
+    with open(os.path.join(outdir, 'simout.log'), 'w') as log:
+        ret = subprocess.run(cmd, stdout=log, stderr=subprocess.STDOUT).returncode
+
+    if ret != 0 or not os.path.exists(os.path.join(outdir, 'stats.txt')):
+        print(f'[sp-{sp_id}] Failed with exit code {ret}, see {outdir}/simout.log')
+        return False
+
+    open(os.path.join(outdir, DONE_FILE), 'w').close()
+    print(f'[sp-{sp_id}] Done')
+    return True
+
+
+def read_last_dump(stats_file: str) -> dict:
+    '''
+    Read the values of the last stats dump of a simpoint, which covers the detailed simulation after warmup
+    '''
+    dump = {}
+    with open(stats_file, 'rb') as f:
+        for dump, _ in iter_dumps(f):
+            pass
+    return {name: data['values'][0] for name, data in dump.items()}
+
+
+def simpoint_metrics(stats: dict, core: str) -> dict:
+    '''
+    Metrics of a single simpoint, all of them ratios so they can be weighted
+    '''
+    insts = stats['simInsts']
+    cycles = stats[f'{core}.numCycles']
+    kilo_insts = insts / 1000
+
+    metrics = {
+        'insts': insts,
+        'cycles': cycles,
+        'cpi': cycles / insts,
+    }
+    # The stock O3CPU has none of the runahead stats
+    if f'{core}.runaheadCycles' in stats:
+        metrics['runaheadCycleFraction'] = stats[f'{core}.runaheadCycles'] / cycles
+        metrics['runaheadPeriodsPKI'] = stats[f'{core}.runaheadPeriods'] / kilo_insts
+        metrics['pseudoRetiredPKI'] = stats[f'{core}.pseudoRetiredInsts'] / kilo_insts
+    return metrics
+
+
+def aggregate(opts: argparse.Namespace, weights: list, finished: list) -> dict:
+    '''
+    Weigh the metrics of every finished simpoint into whole-program metrics.
+    Weights are renormalized over the finished simpoints, the covered weight is reported.
+    '''
+    per_simpoint = {}
+    for sp_id in finished:
+        stats = read_last_dump(os.path.join(opts.outdir, f'sp-{sp_id}', 'stats.txt'))
+        per_simpoint[sp_id] = simpoint_metrics(stats, opts.core)
+        per_simpoint[sp_id]['weight'] = weights[sp_id]
+
+    total_weight = sum(weights[sp_id] for sp_id in finished)
+    weighted = {}
+    if total_weight > 0:
+        names = set.intersection(*(set(m.keys()) for m in per_simpoint.values()))
+        for name in sorted(names - {'insts', 'cycles', 'weight'}):
+            weighted[name] = sum(m[name] * m['weight'] for m in per_simpoint.values()) / total_weight
+        # CPI is what adds up across simpoints, IPC follows from it
+        weighted['ipc'] = 1 / weighted['cpi']
+
+    return {
+        'benchmark': opts.benchmark,
+        'coveredWeight': total_weight,
+        'missingSimpoints': sorted(set(range(len(weights))) - set(finished)),
+        'weighted': weighted,
+        'simpoints': {str(sp_id): m for sp_id, m in sorted(per_simpoint.items())},
+    }
+
+
+def main(opts: argparse.Namespace) -> int:
+    checkpoints = find_checkpoints(opts.checkpoints)
+    try:
+        weights = read_weights(opts.simpoints)
+        check_simpoint_ids(weights, checkpoints.keys(), opts.checkpoints)
+    except ValueError as e:
+        print(e)
+        return 1
+    missing = sorted(set(range(len(weights))) - set(checkpoints.keys()))
+    if missing:
+        print(f'No checkpoints for simpoints {missing}, they will be left out')
+
+    os.makedirs(opts.outdir, exist_ok=True)
+    workers = max(1, opts.cores // opts.cores_per_sim)
+    print(f'Running {len(checkpoints)} simpoints of {opts.benchmark}, {workers} at a time')
+
+    sp_ids = sorted(checkpoints.keys())
+    with ThreadPoolExecutor(max_workers=workers) as pool:
+        results = list(pool.map(lambda sp_id: run_simpoint(opts, sp_id, checkpoints[sp_id]), sp_ids))
+    finished = [sp_id for sp_id, ok in zip(sp_ids, results) if ok]
+
+    summary = aggregate(opts, weights, finished)
+    out_file = os.path.join(opts.outdir, 'simpoints.json')
+    with open(out_file, 'w+') as f:
+        json.dump(summary, f, indent=4)
+
+    print(f'Covered weight: {summary["coveredWeight"]*100:.2f}%')
+    for name, value in summary['weighted'].items():
+        print(f'\t{name}: {value:.4f}')
+    print(f'Wrote weighted stats to {out_file}')
+
+    failed = len(sp_ids) - len(finished)
+    if failed:
+        print(f'{failed} simpoints failed, rerun to retry only those')
+    return 1 if failed else 0
+
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--benchmark', required=True, help='Name of the benchmark, for the summary')
+parser.add_argument('--checkpoints', required=True, help='Directory with the cpt_* simpoint checkpoints')
+parser.add_argument('--simpoints', required=True, help='Directory with simpoint.txt and weights.txt')
+parser.add_argument('--outdir', required=True, help='Directory to put one m5out per simpoint in')
+parser.add_argument('--gem5', default=os.path.join(REPO_DIR, 'gem5', 'build', 'X86', 'gem5.fast'),
+                    help='gem5 binary')
+parser.add_argument('--config', default=os.path.join(REPO_DIR, 'spec2017', 'configs', 'spec2017.py'),
+                    help='gem5 config script')
+parser.add_argument('--cores', default=os.cpu_count(), type=int, help='Core budget for all simulations')
+parser.add_argument('--cores-per-sim', default=1, type=int, help='Cores to budget per gem5 process')
+parser.add_argument('--core', default='system.processor.cores1.core',
+                    help='Stat path of the detailed core')
+parser.add_argument('sim_args', nargs=argparse.REMAINDER, help='Arguments for the config script, after --')
+
+if __name__ == '__main__':
+    opts = parser.parse_args()
+    if opts.sim_args and opts.sim_args[0] == '--':
+        opts.sim_args = opts.sim_args[1:]
+    sys.exit(main(opts))
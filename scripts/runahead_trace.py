@@ -0,0 +1,120 @@
+'''
+reader for the binary runahead period trace written by the runahead CPU (--runahead-trace).
+lists the unique runahead chains like chains.py, along with a summary of the periods
+'''
+
+import sys
+import struct
+from collections import Counter, defaultdict
+from dataclasses import dataclass
+from typing import Iterator, List, Tuple
+
+MAGIC = b'RATRACE\0'
+VERSION = 1
+
+# Same order as the runaheadExitCause buckets of commit
+EXIT_CAUSES = ['EagerExit', 'MinWorkDone', 'Dynamic', 'Deadline', 'FetchPageFault']
+
+_file_header = struct.Struct('<8sI')
+_record_header = struct.Struct('<QQQQQQIHBB')
+_chain_entry = struct.Struct('<QH')
+
+@dataclass
+class Period:
+    period: int
+    cause_pc: int
+    entry_tick: int
+    exit_tick: int
+    insts_pseudoretired: int
+    loads_pseudoretired: int
+    new_llls: int
+    tid: int
+    exit_cause: int
+    # (pc, micro pc) of every chain entry
+    chain: List[Tuple[int, int]]
+
+    @property
+    def ticks(self) -> int:
+        return self.exit_tick - self.entry_tick
+
+    @property
+    def exit_cause_name(self) -> str:
+        if self.exit_cause < len(EXIT_CAUSES):
+            return EXIT_CAUSES[self.exit_cause]
+        return f'Unknown({self.exit_cause})'
+
+def read_trace(path: str) -> Iterator[Period]:
+    '''
+    Read the periods of a runahead trace one by one, so traces of full runs need not fit in memory
+    '''
+    with open(path, 'rb') as f:
+        magic, version = _file_header.unpack(f.read(_file_header.size))
+        if magic != MAGIC:
+            raise ValueError(f'{path} is not a runahead trace')
+        if version != VERSION:
+            raise ValueError(f'{path} has trace version {version}, expected {VERSION}')
+
+        while True:
+            data = f.read(_record_header.size)
+            if len(data) < _record_header.size:
+                # A truncated record means the simulation was killed mid-write
+                return
+            fields = _record_header.unpack(data)
+            chain_len = fields[7]
+
+            data = f.read(chain_len * _chain_entry.size)
+            if len(data) < chain_len * _chain_entry.size:
+                return
+            chain = [_chain_entry.unpack_from(data, i * _chain_entry.size) for i in range(chain_len)]
+
+            yield Period(
+                period=fields[0],
+                cause_pc=fields[1],
+                entry_tick=fields[2],
+                exit_tick=fields[3],
+                insts_pseudoretired=fields[4],
+                loads_pseudoretired=fields[5],
+                new_llls=fields[6],
+                tid=fields[8],
+                exit_cause=fields[9],
+                chain=chain,
+            )
+
+def summarize(path: str):
+    num_periods = 0
+    total_ticks = 0
+    total_insts = 0
+    total_new_llls = 0
+    exit_causes = Counter()
+    chains = defaultdict(int)
+    for period in read_trace(path):
+        num_periods += 1
+        total_ticks += period.ticks
+        total_insts += period.insts_pseudoretired
+        total_new_llls += period.new_llls
+        exit_causes[period.exit_cause_name] += 1
+        chains[(period.cause_pc, tuple(period.chain))] += 1
+
+    print(f'{num_periods} runahead periods')
+    if num_periods == 0:
+        return
+    print(f'Mean period length: {total_ticks / num_periods:.1f} ticks')
+    print(f'Mean insts pseudoretired: {total_insts / num_periods:.1f}')
+    print(f'Mean new LLLs generated: {total_new_llls / num_periods:.2f}')
+    print('Exit causes:')
+    for cause, count in exit_causes.most_common():
+        print(f'\t{cause}: {count} ({count / num_periods * 100:.2f}%)')
+    print()
+
+    ordered = sorted(chains.items(), key=lambda c: c[1], reverse=True)
+    for n, ((cause_pc, chain), count) in enumerate(ordered):
+        print(f'Unique chain #{n+1} (LLL PC {cause_pc:#x}, {len(chain)} insts, {count} periods):')
+        for pc, upc in chain:
+            print(f'\t{pc:#x}.{upc}')
+        print()
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print(f'usage: {sys.argv[0]} <trace file>')
+        sys.exit(1)
+    summarize(sys.argv[1])
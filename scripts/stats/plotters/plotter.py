@@ -5,6 +5,7 @@ Base class for plot producers
 import os
 import json
 from typing import Any
+from statdump import load_columnar, columnar_section
 
 class Plotter:
     name = 'base plotter class'
@@ -18,6 +19,7 @@ class Plotter:
 
     log_dir = '/cluster/home/markuswh/gem5-runahead/spec2017/logs'
     stat_file = 'gem5stats.json'
+    columnar_stat_file = 'gem5stats.npz'
 
     valid_benchmarks = (
         "perlbench_s_0",
@@ -39,6 +41,11 @@ class Plotter:
     )
 
     def read_stats(self, bench: str, run_name: str) -> dict:
+        # Prefer the columnar stats written by statdump.py --format npz, they load much faster
+        columnar_path = os.path.join(self.log_dir, bench, run_name, self.columnar_stat_file)
+        if os.path.exists(columnar_path):
+            return columnar_section(load_columnar(columnar_path), 0)
+
         stats_path = os.path.join(self.log_dir, bench, run_name, self.stat_file)
         with open(stats_path, 'r') as f:
             data = json.load(f)
@@ -1,5 +1,6 @@
 '''
-Convert series of gem5 simulation statistics into pickled format
+Convert series of gem5 simulation statistics into pickled format,
+or stream them into a columnar file (compressed NumPy arrays, one per statistic)
 '''
 
 import re
@@ -8,6 +9,9 @@ import os
 import pickle
 import json
 import math
+import hashlib
+from multiprocessing import Pool
+from typing import Iterator, Tuple
 
 # Statistic section header/footer
 STATS_HEADER = '---------- Begin Simulation Statistics ----------'
@@ -43,9 +47,9 @@ def load_stats_dump(file: str) -> dict:
     return data
 
 
-def parse_line(line: str, fractionalize: bool, line_n: int) -> dict:
+def parse_fields(line: str, fractionalize: bool, line_n: int) -> dict:
     '''
-    Parse one line of statistic, returning a (nested) dict containing
+    Parse one line of statistic, returning a flat dict containing
     its name, value(s), description, bucket (if a dist/histogram), and unit.
 
     The values are always in the order: count, percentage, cumulative.
@@ -124,6 +128,16 @@ def parse_line(line: str, fractionalize: bool, line_n: int) -> dict:
 
     data['description'] = description_match.group(1).strip()
 
+    return data
+
+
+def parse_line(line: str, fractionalize: bool, line_n: int) -> dict:
+    '''
+    Parse one line of statistic, returning a nested dict keyed by the
+    parts of the statistic name, with the fields of parse_fields at the leaf.
+    '''
+    data = parse_fields(line, fractionalize, line_n)
+
     # unroll into a nested dict
     path = data['statistic'].split('.')
     if data['bucket'] != 'N/A':
@@ -141,7 +155,228 @@ def parse_line(line: str, fractionalize: bool, line_n: int) -> dict:
     return nested_data
 
 
+# Amount of bytes before the ingested offset used to tell if the stats file was rewritten
+TAIL_BYTES = 256
+
+
+def stat_key(data: dict) -> str:
+    '''
+    Column name of a statistic, including the bucket of dists/histograms
+    '''
+    if data['bucket'] != 'N/A':
+        return f'{data["statistic"]}::{data["bucket"]}'
+    return data['statistic']
+
+
+def iter_dumps(file, offset: int = 0) -> Iterator[Tuple[dict, int]]:
+    '''
+    Stream the statistic dumps of an open binary stats file, starting at the given offset.
+
+    Yields the statistics of each complete dump, keyed by column name, along with
+    the file offset right after the dump. Only one dump is held in memory at a time.
+    A dump that is still being written (no footer yet) is not yielded.
+    '''
+    file.seek(offset)
+    line_n = 0
+    dump = None
+    for raw_line in file:
+        offset += len(raw_line)
+        line_n += 1
+        line = raw_line.decode().strip()
+        if not line:
+            continue
+
+        if line == STATS_HEADER:
+            dump = {}
+        elif line == STATS_FOOTER:
+            if dump is not None:
+                yield dump, offset
+            dump = None
+        elif dump is not None:
+            data = parse_fields(line, True, line_n)
+            dump[stat_key(data)] = data
+
+
+def _file_tail(file, offset: int) -> str:
+    start = max(0, offset - TAIL_BYTES)
+    file.seek(start)
+    return hashlib.sha1(file.read(offset - start)).hexdigest()
+
+
+def load_columnar(file: str) -> dict:
+    '''
+    Load a columnar statistics file.
+
+    Returns:
+        A dict of statistic name (with '::bucket' for dist/histogram buckets) to a
+        float array of shape (dumps, values). Rows are zero padded to the widest dump,
+        '__counts__' (stats, dumps) holds the real amount of values of each row, 0 if
+        the statistic is missing from that dump.
+        The metadata arrays (names, units, descriptions, ...) are included under dunder keys.
+    '''
+    import numpy as np
+
+    with np.load(file, allow_pickle=False) as npz:
+        return {key: npz[key] for key in npz.files}
+
+
+def columnar_section(columns: dict, dump: int = 0) -> dict:
+    '''
+    Turn one dump of a columnar statistics file into the nested dict format of the JSON dumps,
+    so existing consumers can read columnar files. Statistics missing from the dump are left out.
+    '''
+    stats = {}
+    names = columns['__names__']
+    units = columns['__units__']
+    descriptions = columns['__descriptions__']
+    counts = columns['__counts__']
+    for i, (name, unit, description) in enumerate(zip(names, units, descriptions)):
+        name = str(name)
+        count = int(counts[i, dump])
+        if count == 0:
+            continue
+        values = columns[name][dump, :count]
+
+        statistic, _, bucket = name.partition('::')
+        path = statistic.split('.')
+        if bucket:
+            path += [bucket]
+
+        nest = stats
+        for key in path[:-1]:
+            nest = nest.setdefault(key, {})
+        nest[path[-1]] = {
+            'statistic': statistic,
+            'description': str(description),
+            'values': [float(v) for v in values],
+            'bucket': bucket if bucket else 'N/A',
+            'unit': str(unit),
+        }
+
+    return stats
+
+
+def ingest_columnar(statfile: str, out: str, rebuild: bool = False) -> int:
+    '''
+    Stream the dumps of a stats file into a columnar file.
+
+    If the columnar file exists and the stats file was only appended to since,
+    only the new dumps are parsed and appended. Otherwise the file is rebuilt.
+
+    Returns:
+        The amount of dumps that were ingested
+    '''
+    import numpy as np
+
+    columns = {}
+    units = {}
+    descriptions = {}
+    num_dumps = 0
+    offset = 0
+
+    with open(statfile, 'rb') as file:
+        size = os.fstat(file.fileno()).st_size
+
+        # Pick up where the last ingest stopped, unless the stats file was rewritten
+        if not rebuild and os.path.exists(out):
+            old = load_columnar(out)
+            old_offset = int(old['__offset__'])
+            # Files without value counts are from an older format and get rebuilt
+            if ('__counts__' in old and old_offset <= size and
+                    _file_tail(file, old_offset) == str(old['__tail__'])):
+                offset = old_offset
+                num_dumps = int(old['__dumps__'])
+                for i, (name, unit, description) in enumerate(zip(old['__names__'], old['__units__'],
+                                                                  old['__descriptions__'])):
+                    name = str(name)
+                    columns[name] = [row[:count] for row, count in zip(old[name], old['__counts__'][i])]
+                    units[name] = str(unit)
+                    descriptions[name] = str(description)
+
+        new_dumps = 0
+        for dump, offset in iter_dumps(file, offset):
+            for name, data in dump.items():
+                if name not in columns:
+                    units[name] = data['unit']
+                    descriptions[name] = data['description']
+                    columns[name] = [np.zeros(0)] * num_dumps
+                columns[name].append(np.asarray(data['values'], dtype=np.float64))
+            num_dumps += 1
+            new_dumps += 1
+
+            # Statistics absent from this dump
+            for values in columns.values():
+                if len(values) < num_dumps:
+                    values.append(np.zeros(0))
+
+        tail = _file_tail(file, offset)
+
+    if new_dumps == 0 and os.path.exists(out) and offset > 0:
+        return 0
+
+    names = sorted(columns.keys())
+    arrays = {}
+    counts = np.zeros((len(names), num_dumps), dtype=np.int64)
+    for i, name in enumerate(names):
+        rows = columns[name]
+        width = max([len(row) for row in rows] + [1])
+        # Zero padded, the counts tell which values are real
+        array = np.zeros((num_dumps, width))
+        for dump, row in enumerate(rows):
+            array[dump, :len(row)] = row
+            counts[i, dump] = len(row)
+        arrays[name] = array
+
+    arrays['__counts__'] = counts
+    arrays['__names__'] = np.array(names, dtype=str)
+    arrays['__units__'] = np.array([units[n] for n in names], dtype=str)
+    arrays['__descriptions__'] = np.array([descriptions[n] for n in names], dtype=str)
+    arrays['__dumps__'] = np.array(num_dumps)
+    arrays['__offset__'] = np.array(offset)
+    arrays['__tail__'] = np.array(tail)
+
+    # Write to a temporary file first so an interrupted ingest never leaves a broken file
+    tmp = out + '.tmp.npz'
+    np.savez_compressed(tmp, **arrays)
+    os.replace(tmp, out)
+    return new_dumps
+
+
+def _ingest_job(job: Tuple[str, str, bool]) -> Tuple[str, int]:
+    statfile, out, rebuild = job
+    return statfile, ingest_columnar(statfile, out, rebuild)
+
+
+def columnar_main(opts: argparse.Namespace) -> None:
+    jobs = []
+    for statfile in opts.statfile:
+        if not os.path.exists(statfile):
+            print(f'Stats file path {statfile} is invalid!')
+            exit(1)
+
+        # With several stats files, the output is named the same next to each of them
+        out = opts.out
+        if len(opts.statfile) > 1:
+            out = os.path.join(os.path.dirname(statfile), os.path.basename(opts.out))
+        if not out.endswith('.npz'):
+            out += '.npz'
+        jobs.append((statfile, out, opts.rebuild))
+
+    with Pool(opts.jobs) as pool:
+        for statfile, new_dumps in pool.imap_unordered(_ingest_job, jobs):
+            print(f'{statfile}: ingested {new_dumps} new dumps')
+
+
 def main(opts: argparse.Namespace) -> None:
+    if opts.format == 'npz':
+        columnar_main(opts)
+        return
+
+    if len(opts.statfile) != 1:
+        print('Only the npz format can ingest several stats files at once!')
+        exit(1)
+    opts.statfile = opts.statfile[0]
+
     if not os.path.exists(opts.statfile):
         print('Stats file path is invalid!')
         exit(1)
@@ -199,7 +434,8 @@ parser = argparse.ArgumentParser()
 parser.add_argument(
     'statfile', metavar='file',
     type=str,
-    help='path to stats.txt',
+    nargs='+',
+    help='path to stats.txt. several may be given with the npz format',
 )
 parser.add_argument(
     '--out', metavar='path',
@@ -213,9 +449,21 @@ parser.add_argument(
     type=str,
     default='json',
     help='statistics dump format. '
-         'valid types: pickle, json. '
+         'valid types: pickle, json, npz (columnar, streamed and incremental). '
          'default: json',
 )
+parser.add_argument(
+    '--jobs', metavar='n',
+    type=int,
+    default=os.cpu_count(),
+    help='amount of stats files to ingest in parallel with the npz format. '
+         'default: amount of cores',
+)
+parser.add_argument(
+    '--rebuild',
+    action='store_true',
+    help='re-ingest all dumps instead of only the new ones with the npz format',
+)
 parser.add_argument(
     '--sections', metavar='names',
     type=str,
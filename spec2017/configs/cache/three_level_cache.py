@@ -54,6 +54,7 @@ class ThreeLevelCacheHierarchy(
         l3_size: str,
         l3_assoc: int,
         remove_prefetchers: bool = False,
+        llc_bus: bool = False,
     ):
         super().__init__()
 
@@ -72,7 +73,10 @@ class ThreeLevelCacheHierarchy(
 
         # L2 gets a bus to interface with the L1 D- and I-caches
         self.l2_bus = L2XBar()
-        # No L3 Xbar, L2 can directly interface with L3 since there is only 1 L2 cache
+        # No L3 Xbar by default, L2 can directly interface with L3 since there is only 1 L2 cache.
+        # Other requestors on the LLC (i.e. the continuous runahead engine) need one though
+        if llc_bus:
+            self.l3_bus = L2XBar()
 
         self._remove_prefetchers = remove_prefetchers
 
@@ -82,6 +86,13 @@ class ThreeLevelCacheHierarchy(
     def get_cpu_side_port(self) -> Port:
         return self.membus.cpu_side_ports
 
+    def get_llc_cpu_side_port(self) -> Port:
+        """
+        Port for requestors other than the L2 to access the LLC through
+        """
+        assert hasattr(self, 'l3_bus'), 'The cache hierarchy was built without an LLC bus'
+        return self.l3_bus.cpu_side_ports
+
     @overrides(AbstractCacheHierarchy)
     def incorporate_cache(self, board: AbstractBoard):
         self.l1d_cache = L1DCache(self._l1d_size, self._l1d_assoc, tag_latency=4, data_latency=4, response_latency=4)
@@ -113,7 +124,11 @@ class ThreeLevelCacheHierarchy(
 
         # Connect L2 caches
         self.l2_cache.cpu_side = self.l2_bus.mem_side_ports
-        self.l2_cache.mem_side = self.l3_cache.cpu_side
+        if hasattr(self, 'l3_bus'):
+            self.l2_cache.mem_side = self.l3_bus.cpu_side_ports
+            self.l3_cache.cpu_side = self.l3_bus.mem_side_ports
+        else:
+            self.l2_cache.mem_side = self.l3_cache.cpu_side
 
         # Connect L3 caches
         #self.l3_cache.cpu_side = self.l2_cache.mem_side <- done by L2 cache connection
@@ -6,9 +6,26 @@ from gem5.components.processors.simple_processor import SimpleProcessor
 from m5.objects.BranchPredictor import TAGE_SC_L_8KB
 from gem5.components.processors.simple_core import SimpleCore
 from m5.objects import SimObject
+from m5.objects.RunaheadExitPolicy import (EagerExitPolicy, MinimumWorkExitPolicy,
+                                            NLLBExitPolicy, DynamicDelayedExitPolicy)
 from m5.objects.SimPoint import SimPoint
+from m5.objects.ContinuousRunaheadEngine import ContinuousRunaheadEngine
 from simpoints import parse_simpoints
 
+def make_exit_policy(name: str, min_work: int) -> SimObject:
+    """
+    Instantiate the runahead exit policy with the given name
+    """
+    if name == 'Eager':
+        return EagerExitPolicy()
+    elif name == 'MinimumWork':
+        return MinimumWorkExitPolicy(minWork=min_work)
+    elif name == 'NLLB':
+        return NLLBExitPolicy()
+    elif name == 'DynamicDelayed':
+        return DynamicDelayedExitPolicy()
+    raise ValueError(f'Unknown runahead exit policy: {name}')
+
 def add_core_args(parser):
     cpu_group = parser.add_argument_group(title='CPU Parameters')
 
@@ -16,13 +33,38 @@ def add_core_args(parser):
     cpu_group.add_argument('--no-filtered-runahead', action='store_false', dest='filtered_runahead')
     cpu_group.add_argument('--lll-threshold', default=3, help='Memory depth at which a load is considered a LLL')
     cpu_group.add_argument('--rcache-size', default='2kB', help='Size of the runahead cache')
-    cpu_group.add_argument('--runahead-exit-policy', default='Eager', help='Runahead exit policy')
+    cpu_group.add_argument('--rcache-assoc', default=1, type=int, help='Associativity of the runahead cache')
+    cpu_group.add_argument('--rcache-repl', default='LRU', choices=['LRU', 'Random'], help='Runahead cache replacement policy')
+    cpu_group.add_argument('--rcache-latency', default=1, type=int, help='Runahead cache access latency in cycles')
+    cpu_group.add_argument('--rcache-ports', default=0, type=int, help='Runahead cache accesses per cycle (0 for unlimited)')
+    cpu_group.add_argument('--runahead-exit-policy', default='Eager',
+                           choices=['Eager', 'MinimumWork', 'NLLB', 'DynamicDelayed'], help='Runahead exit policy')
     cpu_group.add_argument('--runahead-exit-deadline', default=200, help='Runahead exit deadline from LLL return')
     cpu_group.add_argument('--runahead-min-work', default=100, help='MinimumWork exit policy - how many insts to pseudoretire before allowing exit')
     cpu_group.add_argument('--lll-latency-threshold', default=100, help='Max load latency before runahead can no longer be entered')
     cpu_group.add_argument('--overlapping-runahead', action='store_true', dest='overlapping_runahead', help='Allow overlapping runahead periods')
     cpu_group.add_argument('--eager-entry', action='store_true', dest='eager_entry', help='Eagerly enter runahead as soon as a LLL makes it to the ROB head')
-    cpu_group.set_defaults(enable_runahead=True, filtered_runahead=True, overlapping_runahead=False, eager_entry=False)
+    cpu_group.add_argument('--runahead-buffer', action='store_true', dest='runahead_buffer', help='Replay load chains from a runahead buffer instead of filtering fetch')
+    cpu_group.add_argument('--runahead-buffer-size', default=32, type=int, help='Runahead buffer capacity in instructions')
+    cpu_group.add_argument('--prefetch-tracker-size', default=4096, type=int, help='Amount of runahead prefetched blocks to classify by usefulness (0 to disable)')
+    cpu_group.add_argument('--entry-predictor', action='store_true', dest='entry_predictor', help='Veto runahead entry for LLLs that historically cause useless periods')
+    cpu_group.add_argument('--entry-predictor-size', default=256, type=int, help='Runahead entry predictor table size')
+    cpu_group.add_argument('--value-predictor', action='store_true', dest='value_predictor', help='Predict the values of runahead LLLs instead of poisoning them')
+    cpu_group.add_argument('--precise-runahead', action='store_true', dest='precise_runahead', help='Run ahead outside of the ROB and avoid the exit flush (requires the Eager exit policy)')
+    cpu_group.add_argument('--vector-runahead', action='store_true', dest='vector_runahead', help='Issue lanes of prefetches for future iterations of strided and indirect LLLs')
+    cpu_group.add_argument('--vector-lanes', default=16, type=int, help='Amount of vector runahead lanes per runahead period')
+    cpu_group.add_argument('--reuse-buffer-size', default=0, type=int, help='Amount of runahead results kept for reuse after exit (0 disables)')
+    cpu_group.add_argument('--early-lll-detection', action='store_true', dest='early_lll_detection', help='Detect LLLs as soon as they miss instead of at the ROB head')
+    cpu_group.add_argument('--no-chain-filter', action='store_false', dest='chain_filter', help='Scan the runahead chain for every fetched instruction instead of hashing it (for host time comparisons)')
+    cpu_group.add_argument('--no-dyninst-free-list', action='store_false', dest='dyninst_free_list', help='Return instruction buffers to the heap instead of recycling them (for host time comparisons)')
+    cpu_group.add_argument('--skip-stalled-cycles', default='Off', choices=['Off', 'Skip', 'Check'], help='Stop ticking the runahead CPU while its pipeline is fully stalled (for host time comparisons), Check ticks every other skipped cycle and panics if the stats differ')
+    cpu_group.add_argument('--commit-watchdog', default=16000000, type=int, help='Exit if the runahead CPU commits nothing for this many cycles (0 disables)')
+    cpu_group.add_argument('--runahead-trace', default='', help='File in the output directory to write a binary trace of runahead periods to (read with scripts/runahead_trace.py)')
+    cpu_group.add_argument('--continuous-runahead', action='store_true', dest='continuous_runahead', help='Keep running the hottest dependence chains on an engine next to the LLC')
+    cpu_group.add_argument('--cre-chain-cache-size', default=8, type=int, help='Amount of dependence chains kept by the continuous runahead engine')
+    cpu_group.set_defaults(enable_runahead=True, filtered_runahead=True, overlapping_runahead=False, eager_entry=False,
+                           runahead_buffer=False, entry_predictor=False, value_predictor=False, precise_runahead=False,
+                           vector_runahead=False, early_lll_detection=False, continuous_runahead=False)
 
     cpu_group.add_argument('--rob-size', default=224, type=int, help='The amount of ROB entries')
 
@@ -35,6 +77,9 @@ def add_core_args(parser):
     cpu_group.add_argument('--squash-width', default=8, type=int, help='ROB squash width')
 
     cpu_group.add_argument('--iq-size', default=97, type=int, help='Issue queue entries')
+    cpu_group.add_argument('--iq-dep-graph', default='Linked', choices=['Linked', 'Pooled'], help='Issue queue dependency graph')
+    cpu_group.add_argument('--iq-dep-graph-slots', default=4, type=int, help='Dependents per register in the pooled dependency graph before spilling')
+    cpu_group.add_argument('--iq-scheduler', default='List', choices=['List', 'AgeMatrix', 'Check'], help='Issue queue select logic, Check runs both and panics if they differ')
     cpu_group.add_argument('--lq-size', default=64, type=int, help='Load queue entries')
     cpu_group.add_argument('--sq-size', default=60, type=int, help='Store queue entries')
 
@@ -86,7 +131,7 @@ def setup_runahead_processor(args) -> SimpleSwitchableProcessor:
 
         # If we're taking simpoint checkpoints, setup the start counts for the highest weight simpoint
         if args.simpoint_checkpoints:
-            simpoints = parse_simpoints(args, highest_weight_only=True)
+            simpoints = parse_simpoints(args, highest_weight_only=not args.all_simpoints)
             start_insts = []
             for sp in simpoints:
                 start_inst = (sp['insts'] - sp['warmup'])
@@ -113,14 +158,37 @@ def setup_runahead_processor(args) -> SimpleSwitchableProcessor:
         # Setup runahead parameters
         sim_core.enableRunahead = args.enable_runahead
         sim_core.filteredRunahead = args.filtered_runahead
+        sim_core.preciseRunahead = args.precise_runahead
+        sim_core.runaheadBuffer = args.runahead_buffer
+        sim_core.runaheadBufferSize = args.runahead_buffer_size
+        sim_core.runaheadPrefetchTrackerSize = args.prefetch_tracker_size
+        sim_core.runaheadEntryPredictor = args.entry_predictor
+        sim_core.runaheadEntryPredictorEntries = args.entry_predictor_size
+        sim_core.runaheadValuePredictor = args.value_predictor
+        sim_core.vectorRunahead = args.vector_runahead
+        sim_core.vectorRunaheadLanes = args.vector_lanes
+        sim_core.runaheadReuseBufferSize = args.reuse_buffer_size
+        sim_core.earlyLLLDetection = args.early_lll_detection
+        sim_core.runaheadChainFilter = args.chain_filter
+        sim_core.dynInstFreeList = args.dyninst_free_list
+        sim_core.skipStalledCycles = args.skip_stalled_cycles
+        sim_core.commitWatchdogCycles = args.commit_watchdog
+        sim_core.runaheadTraceFile = args.runahead_trace
+        if args.continuous_runahead:
+            sim_core.continuousRunaheadEngine = ContinuousRunaheadEngine(
+                chainCacheEntries=args.cre_chain_cache_size
+            )
         sim_core.lllDepthThreshold = args.lll_threshold
         sim_core.runaheadCacheSize = args.rcache_size
+        sim_core.runaheadCacheAssoc = args.rcache_assoc
+        sim_core.runaheadCacheReplPolicy = args.rcache_repl
+        sim_core.runaheadCacheLatency = args.rcache_latency
+        sim_core.runaheadCachePorts = args.rcache_ports
         sim_core.runaheadInFlightThreshold = args.lll_latency_threshold
         sim_core.allowOverlappingRunahead = args.overlapping_runahead
         sim_core.runaheadEagerEntry = args.eager_entry
-        sim_core.runaheadExitPolicy = args.runahead_exit_policy
+        sim_core.runaheadExitPolicy = make_exit_policy(args.runahead_exit_policy, int(args.runahead_min_work))
         sim_core.runaheadExitDeadline = args.runahead_exit_deadline
-        sim_core.minRunaheadWork = args.runahead_min_work
 
         # setup O3 core parameters
         sim_core.fetchWidth = args.fetch_width
@@ -134,6 +202,9 @@ def setup_runahead_processor(args) -> SimpleSwitchableProcessor:
         sim_core.numROBEntries = args.rob_size
 
         sim_core.numIQEntries = args.iq_size
+        sim_core.iqDependencyGraph = args.iq_dep_graph
+        sim_core.iqDependencyGraphSlots = args.iq_dep_graph_slots
+        sim_core.iqScheduler = args.iq_scheduler
         sim_core.LQEntries = args.lq_size
         sim_core.SQEntries = args.sq_size
 
@@ -153,6 +224,24 @@ def setup_runahead_processor(args) -> SimpleSwitchableProcessor:
     return switch_processor
 
 
+def continuous_runahead_engines(processor) -> list:
+    """
+    Get the continuous runahead engines of the processor's runahead cores
+    """
+    if not isinstance(processor, SimpleSwitchableProcessor):
+        return []
+
+    engines = []
+    for cores in processor._switchable_cores.values():
+        for core in cores:
+            if core.get_type() != CPUTypes.RUNAHEAD:
+                continue
+            engine = core.core.continuousRunaheadEngine
+            if isinstance(engine, ContinuousRunaheadEngine):
+                engines.append(engine)
+    return engines
+
+
 def setup_cores(args) -> Union[SimpleProcessor, SimpleSwitchableProcessor]:
     print('Configuring processor...')
     # If taking checkpoints we MUST use the detailed system configuration
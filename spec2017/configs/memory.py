@@ -35,6 +35,7 @@ def setup_cache(args):
         l2_assoc=args.l2_assoc,
         l3_size=args.l3_size,
         l3_assoc=args.l3_assoc,
+        llc_bus=args.continuous_runahead,
     )
 
     return caches
@@ -28,6 +28,12 @@ def add_parser_args(parser):
         type=int,
     )
 
+    sim_group.add_argument(
+        '--all-simpoints',
+        help='Take checkpoints at every simpoint instead of only the highest weight one',
+        action='store_true',
+    )
+
     sim_group.add_argument(
         '--restore-checkpoint',
         help='Restore simulation state using the given checkpoint',
@@ -1,21 +1,47 @@
 import os
 
-def parse_simpoints(args, highest_weight_only=False) -> list:
-    simpoint_file = os.path.join(args.simpoint_checkpoints, 'simpoint.txt')
-    weights_file = os.path.join(args.simpoint_checkpoints, 'weights.txt')
-    simpoints = []
-    weights = []
+def read_weights(simpoint_dir: str) -> list:
+    '''
+    Read the weight of every simpoint from weights.txt, indexed by simpoint ID.
+    Raises a ValueError if the IDs are not exactly 0 to the amount of simpoints - 1.
+    '''
+    weights_file = os.path.join(simpoint_dir, 'weights.txt')
+    weights = {}
 
     with open(weights_file, 'r') as f:
-        for line in f.readlines():
-            if not line:
+        for line_n, line in enumerate(f.readlines(), 1):
+            if not line.strip():
                 continue
             weight_data = line.split()
-            weight = float(weight_data[0])
-            # simpoint weights are already sorted by ID so don't really need this
-            # sp_id = int(weight_data[1])
-            weights.append(weight)
-    
+            if len(weight_data) != 2:
+                raise ValueError(f'{weights_file}:{line_n}: expected "<weight> <simpoint ID>", got "{line.strip()}"')
+            sp_id = int(weight_data[1])
+            if sp_id in weights:
+                raise ValueError(f'{weights_file}:{line_n}: simpoint {sp_id} has more than one weight')
+            weights[sp_id] = float(weight_data[0])
+
+    missing = sorted(set(range(len(weights))) - set(weights.keys()))
+    if missing:
+        raise ValueError(f'{weights_file}: simpoint IDs are not contiguous from 0, no weight for {missing}')
+
+    return [weights[sp_id] for sp_id in range(len(weights))]
+
+def check_simpoint_ids(weights: list, sp_ids, source: str):
+    '''
+    Fail with a clear message if any of the simpoint IDs has no weight
+    '''
+    unknown = sorted(set(sp_ids) - set(range(len(weights))))
+    if unknown:
+        raise ValueError(f'{source} has simpoints {unknown}, but weights.txt only has IDs 0 to {len(weights) - 1}. '
+                         'Are they from the same simpoint analysis?')
+
+def parse_simpoints(args, highest_weight_only=False) -> list:
+    simpoint_file = os.path.join(args.simpoint_checkpoints, 'simpoint.txt')
+    simpoints = []
+    weights = read_weights(args.simpoint_checkpoints)
+    with open(simpoint_file, 'r') as f:
+        check_simpoint_ids(weights, (int(line.split()[1]) for line in f if line.strip()), simpoint_file)
+
     # find the simpoint ID corresponding to the highest weight
     highest_weight_sp = weights.index(max(weights))
     with open(simpoint_file, 'r') as f:
@@ -27,13 +53,15 @@ def parse_simpoints(args, highest_weight_only=False) -> list:
             # Convert interval number to #insts
             # Account for booting.
             sp_insts = (sp_data[0] * args.simpoint_interval)
+            # Simpoints early in the program get as much warmup as there is before them
+            sp_warmup = min(int(args.warmup_insts), sp_insts)
             if not highest_weight_only or (sp_data[1] == highest_weight_sp):
                 simpoints.append({
                     'id': sp_data[1],
                     'interval': sp_data[0],
                     'weight': weights[sp_data[1]],
                     'insts': sp_insts,
-                    'warmup': int(args.warmup_insts),
+                    'warmup': sp_warmup,
                 })
 
     return sorted(simpoints, key=lambda sp: sp['insts'])
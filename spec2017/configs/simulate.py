@@ -2,6 +2,21 @@ import m5
 from datetime import datetime
 from simpoints import parse_simpoints
 import os
+import re
+
+# Exit cause of the runahead CPU commit watchdog
+COMMIT_WATCHDOG_CAUSE = 'runahead CPU commit watchdog fired'
+# Exit cause at the end of the warmup of a simpoint checkpoint
+WARMUP_DONE_CAUSE = 'simpoint warmup finished'
+# Warmup instructions in the name of a simpoint checkpoint, see sim_fs_simpoint_checkpoints
+CHECKPOINT_WARMUP_PAT = re.compile(r'_warmup-(?P<warmup>\d+)$')
+
+def active_core_insts(root) -> int:
+    '''
+    Instructions committed by the active cores. Read straight from the CPU objects,
+    which is much cheaper than serializing the whole stat tree
+    '''
+    return sum(core.core.totalInsts() for core in root.system.processor.get_cores())
 
 def sim_fs_normal(root, args, switch_core=True):
     '''
@@ -58,46 +73,46 @@ def sim_fs_from_checkpoint(root, args):
     exit_event = m5.simulate(restart_period)
     tick = m5.curTick()
 
-    simstats = m5.stats.gem5stats.get_simstat(root).to_json()
-    insts = int(simstats['system']['processor']['cores0']['core']['exec_context.thread_0']['numInsts']['value'])
+    insts = active_core_insts(root)
     print(f'Simulated {insts} instructions in {tick - start_tick} ticks (init period)')
 
     root.system.processor.switch()
 
+    # Simpoint checkpoints are taken before their warmup, keep it out of the final stats dump
+    match = CHECKPOINT_WARMUP_PAT.search(os.path.basename(os.path.normpath(args.restore_checkpoint)))
+    warmup = int(match.group('warmup')) if match else 0
+    if warmup > 0:
+        print(f'Resetting stats after {warmup} warmup insts')
+        for core in root.system.processor.get_cores():
+            core.core.scheduleInstStop(0, warmup, WARMUP_DONE_CAUSE)
+
     # But things can also break silently. In some cases, checkpoint restores leave the
-    # detailed CPU model in a stall. Forever. So we simulate in smaller chunks and regularly
-    # check if the CPU has stalled
+    # detailed CPU model in a stall. Forever. The commit watchdog of the runahead CPU
+    # exits the simulation loop if that happens, so there is no need to poll progress
     prev_insts = 0
     prev_tick = tick
-    # The last sim interval is used for any sim periods beyond the length of this list
-    sim_intervals = [5000000000]
-    it = sim_intervals.__iter__()
     while True:
-        try:
-            sim_interval = next(it)
-        except StopIteration:
-            sim_interval = sim_intervals[-1]
-
-        if sim_interval <= 0:
-            break
-
-        print(f'Simulating for {sim_interval} ticks @ {tick}')
-        exit_event = m5.simulate(sim_interval)
+        print(f'Simulating @ {tick}')
+        exit_event = m5.simulate()
         tick = m5.curTick()
         cause = exit_event.getCause()
 
-        simstats = m5.stats.gem5stats.get_simstat(root).to_json()
-        insts = int(simstats['system']['processor']['cores1']['core']['committedInsts']['0']['value'])
+        insts = active_core_insts(root)
         print(f'Simulated {insts - prev_insts} instructions in {tick - prev_tick} ticks - {cause} @ {tick}')
         print(f'Progress: {insts}/{args.max_insts} insts ({(insts/args.max_insts)*100:.2f}%)')
 
         if cause == 'a thread reached the max instruction count':
             break
 
-        if insts == prev_insts:
+        if cause == COMMIT_WATCHDOG_CAUSE:
             print('The simulation stalled. Try again.')
             exit(1)
 
+        if cause == WARMUP_DONE_CAUSE:
+            print('Warmup finished, dumping and resetting stats...')
+            m5.stats.dump()
+            m5.stats.reset()
+
         prev_insts = insts
         prev_tick = tick
 
@@ -113,7 +128,7 @@ def sim_fs_simpoint_checkpoints(root, args):
     Checkpoints are never taken before boot has finished
     Although the system should be setup in the same way as a detailed run, we stay on the simple core
     '''
-    simpoints = parse_simpoints(args, highest_weight_only=True)
+    simpoints = parse_simpoints(args, highest_weight_only=not args.all_simpoints)
     boot_complete = False
 
     exit_event = None
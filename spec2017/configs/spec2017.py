@@ -11,7 +11,7 @@ from gem5.components.boards.x86_board import X86Board
 from gem5.isas import ISA
 from gem5.resources.resource import CustomResource, CustomDiskImageResource
 
-from core import setup_cores, add_core_args
+from core import setup_cores, add_core_args, continuous_runahead_engines
 from memory import setup_cache, setup_memory, add_memory_args
 from options import add_parser_args
 from simpoints import parse_simpoints
@@ -43,6 +43,10 @@ board = X86Board(
     memory=setup_memory(args),
 )
 
+# The continuous runahead engine prefetches straight into the LLC
+for engine in continuous_runahead_engines(processor):
+    engine.port = board.get_cache_hierarchy().get_llc_cpu_side_port()
+
 # Check that the kernel, image and runscript exist
 assert os.path.exists(args.kernel)
 assert os.path.exists(args.image)